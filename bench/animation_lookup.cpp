@@ -0,0 +1,114 @@
+#include "animation_table.hpp"
+#include "character.hpp"
+
+#include <array>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+/**
+ * Stand-in for a @c Sprite , with the same fields that the per-tick code reads.
+ */
+struct BenchmarkSprite {
+    unsigned short length = 4U; /**< How many frames to show the sprite for. */
+    SDL_FRect spriteSheetArea{0.0f, 0.0f, 32.0f, 48.0f}; /**< The area of the sprite sheet. */
+    signed short xOffset = 0; /**< The horizontal offset. */
+    signed short yOffset = 0; /**< The vertical offset. */
+    std::vector<SDL_FRect> boxes = std::vector<SDL_FRect>(4UZ); /**< The boxes of the sprite. */
+};
+
+/**
+ * Builds the animations of a character with a full move list.
+ * @return The frames of each animation.
+ */
+static std::map<unsigned short, std::vector<BenchmarkSprite>> makeRoster() {
+    std::map<unsigned short, std::vector<BenchmarkSprite>> animations;
+    for (unsigned short type = IDLE; type <= DEFEAT; ++type) {
+        animations[type].resize(4UZ);
+    }
+    for (const unsigned short base : {STAND_LIGHT_PUNCH, CROUCH_LIGHT_PUNCH, JUMP_LIGHT_PUNCH}) {
+        for (unsigned short type = base; type < base + 4U; ++type) {
+            animations[type].resize(6UZ);
+        }
+    }
+    animations[FORWARD_LIGHT_KICK].resize(6UZ);
+    animations[FORWARD_THROW].resize(8UZ);
+    animations[BACKWARD_THROW].resize(8UZ);
+    for (unsigned short type = SPECIALS_START; type < SPECIALS_START + 12U; ++type) {
+        animations[type].resize(10UZ);
+    }
+    animations[SUPER].resize(30UZ);
+    for (unsigned short type = CHARACTER_SPECIFIC_METER_ASSETS_BEGIN; type < CHARACTER_SPECIFIC_METER_ASSETS_BEGIN + 4U; ++type) {
+        animations[type].resize(2UZ);
+    }
+    for (unsigned short type = MISC_ASSETS_BEGIN; type < MISC_ASSETS_BEGIN + 8U; ++type) {
+        animations[type].resize(2UZ);
+    }
+    animations[CHARACTER_SELECTION_IMAGE].resize(1UZ);
+    animations[CHARACTER_WIN_IMAGE].resize(1UZ);
+    animations[CHARACTER_LOSS_IMAGE].resize(1UZ);
+    return animations;
+}
+
+/**
+ * The animations a character goes through during a match, one per tick.
+ */
+static constexpr std::array<unsigned short, 8> tickAnimations = {
+    IDLE, WALK_FORWARD, CROUCH, STAND_HEAVY_KICK, JUMP_FORWARD, JUMP_HEAVY_PUNCH, SPECIALS_START + 3U, SUPER
+};
+
+/**
+ * Performs the lookups of one tick, as @c Character::processInputs and @c Character::render do.
+ * @tparam Lookup A callable taking an animation type and a frame index.
+ * @param lookup The lookup to perform.
+ * @param tick The current tick.
+ */
+template <typename Lookup>
+static void simulateTick(const Lookup& lookup, const size_t tick) {
+    const unsigned short type = tickAnimations[tick % tickAnimations.size()];
+    const size_t frame = tick % 2UZ;
+    for (int i = 0; i < 12; ++i) {
+        const BenchmarkSprite& sprite = lookup(type, frame);
+        benchmark::DoNotOptimize(sprite.length);
+        benchmark::DoNotOptimize(sprite.spriteSheetArea.w);
+    }
+}
+
+/**
+ * Measures the lookups of a tick with the previous @c std::map of @c std::vector s.
+ * @param state The benchmark state.
+ */
+static void BM_MapLookup(benchmark::State& state) {
+    std::map<AnimationType, std::vector<BenchmarkSprite>> animations;
+    for (auto& [type, frames] : makeRoster()) {
+        animations[static_cast<AnimationType>(type)] = std::move(frames);
+    }
+    size_t tick = 0UZ;
+    for (auto _ : state) {
+        simulateTick([&animations](const unsigned short type, const size_t frame) -> const BenchmarkSprite& {
+            return animations.at(static_cast<AnimationType>(type)).at(frame);
+        }, tick++);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MapLookup);
+
+/**
+ * Measures the lookups of a tick with an @c AnimationTable .
+ * @param state The benchmark state.
+ */
+static void BM_TableLookup(benchmark::State& state) {
+    const AnimationTable<BenchmarkSprite> animations(makeRoster());
+    size_t tick = 0UZ;
+    for (auto _ : state) {
+        simulateTick([&animations](const unsigned short type, const size_t frame) -> const BenchmarkSprite& {
+            return animations.at(type, frame);
+        }, tick++);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TableLookup);
+
+BENCHMARK_MAIN();
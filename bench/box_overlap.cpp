@@ -0,0 +1,120 @@
+#include "box_overlap.hpp"
+#include "character.hpp"
+#include "character_data.hpp"
+#include "scalar.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+/**
+ * The boxes of both characters, as if each had as many projectiles on the stage as its number of hitboxes.
+ */
+struct BenchmarkBoxes {
+    std::vector<CharacterBox> player1Boxes; /**< The boxes that player 1's active boxes point to. */
+    std::vector<CharacterBox> player2Boxes; /**< The boxes that player 2's active boxes point to. */
+    std::vector<ActiveBox> player1; /**< Player 1's active boxes. */
+    std::vector<ActiveBox> player2; /**< Player 2's active boxes. */
+    /**
+     * Scatters boxes of every type over the middle of the stage, so that some of them overlap.
+     * @param hitboxes How many hitboxes each character has.
+     */
+    explicit BenchmarkBoxes(const size_t hitboxes) {
+        std::mt19937 generator(0U);
+        std::uniform_int_distribution<int> x(300, 900);
+        std::uniform_int_distribution<int> y(300, 600);
+        std::uniform_int_distribution<int> size(8, 48);
+        for (std::vector<CharacterBox>* boxes : {&this->player1Boxes, &this->player2Boxes}) {
+            for (size_t i = 0UZ; i < hitboxes; ++i) {
+                boxes->emplace_back(static_cast<BoxType>(0x0180U), HitboxProperties(), ScalarRect());
+            }
+            // A hurtbox per hitbox too, since each projectile can be hit.
+            for (size_t i = 0UZ; i < hitboxes + 4UZ; ++i) {
+                boxes->emplace_back(HURTBOX, HitboxProperties(), ScalarRect());
+            }
+            boxes->emplace_back(COMMAND_GRAB, HitboxProperties(), ScalarRect());
+            boxes->emplace_back(THROW_PUSH_GROUND_COLLISION, HitboxProperties(), ScalarRect());
+            boxes->emplace_back(PROXIMITY_GUARD, HitboxProperties(), ScalarRect());
+        }
+        for (const CharacterBox& box : this->player1Boxes) {
+            this->player1.emplace_back(&box, ScalarRect(Scalar(x(generator)), Scalar(y(generator)), Scalar(size(generator)), Scalar(size(generator))));
+        }
+        for (const CharacterBox& box : this->player2Boxes) {
+            this->player2.emplace_back(&box, ScalarRect(Scalar(x(generator)), Scalar(y(generator)), Scalar(size(generator)), Scalar(size(generator))));
+        }
+    }
+};
+
+/**
+ * Checks whether two boxes of the given types can collide, the way @c collideBoxes pairs them.
+ * @param first The type of the first character's box.
+ * @param second The type of the second character's box.
+ * @return Whether the boxes are compared.
+ */
+static bool collides(const BoxType first, const BoxType second) {
+    if (first >= HITBOX_BEGIN && first <= HITBOX_END) {
+        return second == HURTBOX;
+    }
+    return (first == COMMAND_GRAB && second == THROW_PUSH_GROUND_COLLISION)
+        || (first == PROXIMITY_GUARD && second == HURTBOX);
+}
+
+/**
+ * Measures comparing every pair of active boxes one by one with @c hasIntersection , as the boxes are stored.
+ * @param state The benchmark state, whose argument is the number of hitboxes of each character.
+ */
+static void BM_OverlapActiveBoxes(benchmark::State& state) {
+    const BenchmarkBoxes boxes(static_cast<size_t>(state.range(0)));
+    std::vector<BoxOverlap> overlaps;
+    for (auto _ : state) {
+        overlaps.clear();
+        for (const auto& [first, second] : {std::pair(&boxes.player1, &boxes.player2), std::pair(&boxes.player2, &boxes.player1)}) {
+            for (size_t i = 0UZ; i < first->size(); ++i) {
+                for (size_t j = 0UZ; j < second->size(); ++j) {
+                    if (collides((*first)[i].box->boxType, (*second)[j].box->boxType) && hasIntersection((*first)[i].rect, (*second)[j].rect)) {
+                        overlaps.emplace_back(static_cast<uint16_t>(i), static_cast<uint16_t>(j));
+                    }
+                }
+            }
+        }
+        for (size_t i = 0UZ; i < boxes.player1.size(); ++i) {
+            for (size_t j = 0UZ; j < boxes.player2.size(); ++j) {
+                if (boxes.player1[i].box->boxType == THROW_PUSH_GROUND_COLLISION && boxes.player2[j].box->boxType == THROW_PUSH_GROUND_COLLISION
+                    && hasIntersection(boxes.player1[i].rect, boxes.player2[j].rect)) {
+                    overlaps.emplace_back(static_cast<uint16_t>(i), static_cast<uint16_t>(j));
+                }
+            }
+        }
+        benchmark::DoNotOptimize(overlaps.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * boxes.player1.size() * boxes.player2.size()));
+}
+BENCHMARK(BM_OverlapActiveBoxes)->Arg(4)->Arg(16)->Arg(64)->Arg(256);
+
+/**
+ * Measures packing the active boxes into columns and finding every overlap with the kernel, as @c Match::step does.
+ * @param state The benchmark state, whose argument is the number of hitboxes of each character.
+ */
+static void BM_OverlapColumns(benchmark::State& state) {
+    const BenchmarkBoxes boxes(static_cast<size_t>(state.range(0)));
+    CharacterBoxColumns player1;
+    CharacterBoxColumns player2;
+    BoxCollisions collisions;
+    for (auto _ : state) {
+        player1.pack(boxes.player1);
+        player2.pack(boxes.player2);
+        collideBoxes(player1, player2, collisions);
+        benchmark::DoNotOptimize(collisions.player1Hits.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * boxes.player1.size() * boxes.player2.size()));
+}
+BENCHMARK(BM_OverlapColumns)->Arg(4)->Arg(16)->Arg(64)->Arg(256);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,147 @@
+#include "character_data.hpp"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <span>
+#include <vector>
+
+#include <SDL3/SDL.h>
+
+#include <benchmark/benchmark.h>
+
+/**
+ * Writes *.ff numbers in big-endian order.
+ */
+class DataWriter {
+public:
+    std::vector<std::byte> bytes; /**< The data written so far. */
+    /**
+     * Writes an unsigned short.
+     * @param value The number.
+     */
+    void u16(const uint16_t value) {
+        this->bytes.push_back(static_cast<std::byte>(value >> 8));
+        this->bytes.push_back(static_cast<std::byte>(value & 0xFFU));
+    }
+    /**
+     * Writes a @c float .
+     * @param value The number.
+     */
+    void f32(const float value) {
+        const uint32_t bits = std::bit_cast<uint32_t>(value);
+        this->u16(static_cast<uint16_t>(bits >> 16));
+        this->u16(static_cast<uint16_t>(bits & 0xFFFFU));
+    }
+    /**
+     * Writes a box.
+     * @param type The type of the box.
+     * @param x The x-coordinate of the box.
+     */
+    void box(const uint16_t type, const uint16_t x) {
+        this->u16(x);
+        this->u16(8U);
+        this->u16(24U);
+        this->u16(40U);
+        if (type >= HITBOX_BEGIN && type <= HITBOX_END) {
+            this->u16(12U);
+            this->u16(8U);
+            this->u16(4U);
+            this->u16(2U);
+        }
+    }
+};
+
+/**
+ * Builds the *.ff file of a character far larger than any in the roster: 8 palettes of 64 colors, and 256
+ * animations of 16 frames, where every other frame copies the one before it and only redefines its hitboxes.
+ * @return The *.ff file.
+ */
+static std::vector<std::byte> makeLargeCharacter() {
+    DataWriter writer;
+    writer.u16(0xF055U);
+    writer.u16(8U);
+    writer.u16(64U);
+    for (size_t i = 0UZ; i < 8UZ * 64UZ * 3UZ; ++i) {
+        writer.bytes.push_back(static_cast<std::byte>(i));
+    }
+    for (const float stat : {2.0F, 3.0F, 2.5F, 3.0F, 2.5F, 12.0F, 0.5F}) {
+        writer.f32(stat);
+    }
+    for (uint16_t animation = 0U; animation < 256U; ++animation) {
+        const uint16_t type = animation < 128U ? animation : static_cast<uint16_t>(SPECIALS_START + animation - 128U);
+        writer.u16(type);
+        writer.u16(16U);
+        for (uint16_t frame = 0U; frame < 16U; ++frame) {
+            if (frame % 2U == 1U) {
+                // Copies everything but the hitboxes of the previous frame.
+                writer.u16(0xFFFEU);
+                writer.u16(type);
+                writer.u16(static_cast<uint16_t>(frame - 1U));
+                writer.u16(0x0180U);
+                writer.u16(1U);
+                writer.box(0x0180U, frame);
+                writer.u16(NULL_TERMINATOR);
+                continue;
+            }
+            writer.u16(4U);
+            writer.u16(static_cast<uint16_t>(frame * 32U));
+            writer.u16(static_cast<uint16_t>(animation * 48U));
+            writer.u16(32U);
+            writer.u16(48U);
+            writer.u16(0U);
+            writer.u16(0U);
+            writer.u16(HURTBOX);
+            writer.u16(4U);
+            for (uint16_t i = 0U; i < 4U; ++i) {
+                writer.box(HURTBOX, i);
+            }
+            writer.u16(THROW_PUSH_GROUND_COLLISION);
+            writer.u16(1U);
+            writer.box(THROW_PUSH_GROUND_COLLISION, 0U);
+            writer.u16(0x0180U);
+            writer.u16(2U);
+            writer.box(0x0180U, 0U);
+            writer.box(0x0180U, 1U);
+            writer.u16(NULL_TERMINATOR);
+        }
+    }
+    return writer.bytes;
+}
+
+/**
+ * Measures parsing a large character that is already in memory.
+ * @param state The benchmark state.
+ */
+static void BM_ParseCharacterData(benchmark::State& state) {
+    const std::vector<std::byte> file = makeLargeCharacter();
+    for (auto _ : state) {
+        std::expected<CharacterData, CharacterDataError> data = parseCharacterData(file);
+        if (!data) {
+            state.SkipWithError(data.error().origin);
+            break;
+        }
+        benchmark::DoNotOptimize(data->animations.allFrames().data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * file.size()));
+}
+BENCHMARK(BM_ParseCharacterData)->Unit(benchmark::kMicrosecond);
+
+/**
+ * Measures reading a large character from a stream, as the asset compiler does.
+ * @param state The benchmark state.
+ */
+static void BM_ReadCharacterData(benchmark::State& state) {
+    const std::vector<std::byte> file = makeLargeCharacter();
+    for (auto _ : state) {
+        SDL_IOStream* stream = SDL_IOFromConstMem(file.data(), file.size());
+        CharacterData data = readCharacterData(stream);
+        SDL_CloseIO(stream);
+        benchmark::DoNotOptimize(data.animations.allFrames().data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * file.size()));
+}
+BENCHMARK(BM_ReadCharacterData)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
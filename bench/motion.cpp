@@ -0,0 +1,61 @@
+#include "motion_recognizer.hpp"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+/**
+ * A minute of a player rolling the stick around and mashing, with inputs held for up to 20 frames like
+ * @c RandomCommandInputParser .
+ * @return The direction and buttons of each frame.
+ */
+static std::vector<InputHistoryEntry> makeBenchmarkInputs() {
+    std::mt19937 generator(0U);
+    std::uniform_int_distribution<int> direction(DOWN_BACK, UP_FORWARD);
+    std::uniform_int_distribution<int> buttons(0, 15);
+    std::uniform_int_distribution<int> hold(0, 20);
+    std::vector<InputHistoryEntry> inputs;
+    while (inputs.size() < 60UZ * 60UZ) {
+        const InputHistoryEntry entry(static_cast<Direction>(direction(generator)), ButtonGroup(static_cast<unsigned char>(buttons(generator))));
+        for (int frame = hold(generator); frame >= 0; --frame) {
+            inputs.push_back(entry);
+        }
+    }
+    return inputs;
+}
+
+static void BM_UpdateMotionRecognizer(benchmark::State& state) {
+    const std::vector<InputHistoryEntry> inputs = makeBenchmarkInputs();
+    MotionRecognizer recognizer;
+    size_t frame = 0UZ;
+    for (auto _ : state) {
+        const InputHistoryEntry& input = inputs[frame];
+        recognizer.update(input.getDirection(), input.getButton());
+        benchmark::DoNotOptimize(recognizer);
+        frame = frame + 1UZ == inputs.size() ? 0UZ : frame + 1UZ;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_UpdateMotionRecognizer);
+
+static void BM_MatchEveryCommandInput(benchmark::State& state) {
+    const std::vector<InputHistoryEntry> inputs = makeBenchmarkInputs();
+    MotionRecognizer recognizer;
+    size_t frame = 0UZ;
+    for (auto _ : state) {
+        const InputHistoryEntry& input = inputs[frame];
+        recognizer.update(input.getDirection(), input.getButton());
+        unsigned int matched = 0U;
+        for (unsigned int data = 0U; data < 0x100U; data += 2U) {
+            matched += recognizer.matches(commandInputFromByte(static_cast<uint8_t>(data))) ? 1U : 0U;
+        }
+        benchmark::DoNotOptimize(matched);
+        frame = frame + 1UZ == inputs.size() ? 0UZ : frame + 1UZ;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MatchEveryCommandInput);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,86 @@
+#include "palette_swap.hpp"
+
+#include <cstdint>
+#include <random>
+#include <span>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+/**
+ * The width and height of the benchmark sprite sheet.
+ */
+constexpr size_t sheetSize = 1024UZ;
+
+/**
+ * A palette of distinct opaque colors.
+ * @param colors The number of colors.
+ * @param seed Picks the colors.
+ * @return The colors, as RGBA32 pixel values.
+ */
+static std::vector<uint32_t> makePalette(const size_t colors, const uint_fast32_t seed) {
+    std::mt19937 generator(seed);
+    std::vector<uint32_t> palette;
+    for (size_t i = 0UZ; i < colors; ++i) {
+        palette.push_back(0xFF000000U | (static_cast<uint32_t>(generator()) & 0x00FFFFFFU));
+    }
+    return palette;
+}
+
+/**
+ * A sprite sheet that is mostly transparent, with runs of colors from a palette and a few colors that are not in it.
+ * @param palette The palette.
+ * @return The pixels.
+ */
+static std::vector<uint32_t> makeSheet(const std::vector<uint32_t>& palette) {
+    std::mt19937 generator(0U);
+    std::uniform_int_distribution<size_t> color(0UZ, palette.size() - 1UZ);
+    std::uniform_int_distribution<int> run(1, 12);
+    std::uniform_int_distribution<int> kind(0, 9);
+    std::vector<uint32_t> pixels;
+    while (pixels.size() < sheetSize * sheetSize) {
+        const int pick = kind(generator);
+        const uint32_t pixel = pick < 6 ? 0x00000000U : pick < 9 ? palette[color(generator)] : 0xFF808080U;
+        pixels.insert(pixels.end(), static_cast<size_t>(run(generator)), pixel);
+    }
+    pixels.resize(sheetSize * sheetSize);
+    return pixels;
+}
+
+static void BM_RecolorPerColor(benchmark::State& state) {
+    const std::vector<uint32_t> from = makePalette(static_cast<size_t>(state.range(0)), 1U);
+    const std::vector<uint32_t> to = makePalette(static_cast<size_t>(state.range(0)), 2U);
+    const std::vector<uint32_t> sheet = makeSheet(from);
+    std::vector<uint32_t> pixels;
+    for (auto _ : state) {
+        pixels = sheet;
+        // How sprite sheets used to be recolored: one pass over every pixel per color.
+        for (size_t i = 0UZ; i < from.size(); ++i) {
+            for (uint32_t& pixel : pixels) {
+                if (pixel == from[i]) {
+                    pixel = to[i];
+                }
+            }
+        }
+        benchmark::DoNotOptimize(pixels.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * sheet.size()));
+}
+BENCHMARK(BM_RecolorPerColor)->Arg(16)->Arg(64)->Arg(256)->Unit(benchmark::kMillisecond);
+
+static void BM_RecolorPaletteSwap(benchmark::State& state) {
+    const std::vector<uint32_t> from = makePalette(static_cast<size_t>(state.range(0)), 1U);
+    const std::vector<uint32_t> to = makePalette(static_cast<size_t>(state.range(0)), 2U);
+    const std::vector<uint32_t> sheet = makeSheet(from);
+    std::vector<uint32_t> pixels;
+    for (auto _ : state) {
+        pixels = sheet;
+        const PaletteSwap swap(from, to);
+        swap.apply(pixels);
+        benchmark::DoNotOptimize(pixels.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * sheet.size()));
+}
+BENCHMARK(BM_RecolorPaletteSwap)->Arg(16)->Arg(64)->Arg(256)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,60 @@
+#include "replay.hpp"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+/**
+ * A replay of an hour of two players mashing, with inputs held for up to 20 frames like @c RandomCommandInputParser .
+ * @return The replay.
+ */
+static Replay makeBenchmarkReplay() {
+    ReplayRecorder recorder({"Debuggy", "Debuggy"}, {0U, 0U});
+    std::mt19937 generator(0U);
+    std::uniform_int_distribution<int> direction(DOWN_BACK, UP_FORWARD);
+    std::uniform_int_distribution<int> buttons(0, 15);
+    std::uniform_int_distribution<int> hold(0, 20);
+    uint8_t player1Input = neutralInput;
+    uint8_t player2Input = neutralInput;
+    int player1Remaining = 0;
+    int player2Remaining = 0;
+    for (int frame = 0; frame < 60 * 60 * 60; ++frame) {
+        if (player1Remaining-- == 0) {
+            player1Input = packInput(static_cast<Direction>(direction(generator)), ButtonGroup(static_cast<unsigned char>(buttons(generator))));
+            player1Remaining = hold(generator);
+        }
+        if (player2Remaining-- == 0) {
+            player2Input = packInput(static_cast<Direction>(direction(generator)), ButtonGroup(static_cast<unsigned char>(buttons(generator))));
+            player2Remaining = hold(generator);
+        }
+        recorder.recordFrame(player1Input, player2Input);
+    }
+    return recorder.getReplay();
+}
+
+static void BM_EncodeReplay(benchmark::State& state) {
+    const Replay replay = makeBenchmarkReplay();
+    size_t bytes = 0UZ;
+    for (auto _ : state) {
+        const std::vector<uint8_t> encoded = encodeReplay(replay);
+        bytes = encoded.size();
+        benchmark::DoNotOptimize(encoded.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes));
+    state.counters["bytes"] = static_cast<double>(bytes);
+}
+BENCHMARK(BM_EncodeReplay);
+
+static void BM_DecodeReplay(benchmark::State& state) {
+    const std::vector<uint8_t> encoded = encodeReplay(makeBenchmarkReplay());
+    for (auto _ : state) {
+        const Replay replay = decodeReplay(encoded);
+        benchmark::DoNotOptimize(replay.inputs[0].data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * encoded.size()));
+}
+BENCHMARK(BM_DecodeReplay);
+
+BENCHMARK_MAIN();
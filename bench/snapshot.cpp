@@ -0,0 +1,139 @@
+#include "command_input_parser.hpp"
+#include "match.hpp"
+
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+/**
+ * Inputs that put both characters through walking, jumping and attacking.
+ */
+static const std::vector<InputHistoryEntry> benchmarkScript = {
+    InputHistoryEntry(FORWARD, ButtonGroup(), 20U),
+    InputHistoryEntry(UP_FORWARD, ButtonGroup(), 0U),
+    InputHistoryEntry(NEUTRAL, ButtonGroup(), 30U),
+    InputHistoryEntry(NEUTRAL, ButtonGroup(0x8U), 0U),
+    InputHistoryEntry(DOWN, ButtonGroup(), 10U),
+    InputHistoryEntry(BACK, ButtonGroup(), 15U),
+};
+
+/**
+ * A match that has been played for a while, so that the input histories are full.
+ */
+struct BenchmarkMatch {
+    ScriptedCommandInputParser player1Controller{benchmarkScript}; /**< Player 1's inputs. */
+    ScriptedCommandInputParser player2Controller{benchmarkScript}; /**< Player 2's inputs. */
+    Match match{"Debuggy", &player1Controller, "Debuggy", &player2Controller}; /**< The match. */
+    /**
+     * Plays the match for ten seconds.
+     */
+    BenchmarkMatch() {
+        for (int i = 0; i < 600; ++i) {
+            this->match.step();
+        }
+    }
+};
+
+static void BM_SaveCharacter(benchmark::State& state) {
+    BenchmarkMatch setup;
+    CharacterState saved;
+    for (auto _ : state) {
+        setup.match.getPlayer1().saveState(saved);
+        benchmark::DoNotOptimize(saved);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * sizeof(CharacterState)));
+}
+BENCHMARK(BM_SaveCharacter);
+
+static void BM_LoadCharacter(benchmark::State& state) {
+    BenchmarkMatch setup;
+    CharacterState saved;
+    setup.match.getPlayer1().saveState(saved);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(saved);
+        setup.match.getPlayer1().loadState(saved);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * sizeof(CharacterState)));
+}
+BENCHMARK(BM_LoadCharacter);
+
+static void BM_SaveMatch(benchmark::State& state) {
+    BenchmarkMatch setup;
+    MatchState saved;
+    for (auto _ : state) {
+        setup.match.saveState(saved);
+        benchmark::DoNotOptimize(saved);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * sizeof(MatchState)));
+}
+BENCHMARK(BM_SaveMatch);
+
+static void BM_LoadMatch(benchmark::State& state) {
+    BenchmarkMatch setup;
+    MatchState saved;
+    setup.match.saveState(saved);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(saved);
+        setup.match.loadState(saved);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * sizeof(MatchState)));
+}
+BENCHMARK(BM_LoadMatch);
+
+/**
+ * Copying a saved state around, as a rollback buffer does, for comparison with saving and loading.
+ */
+static void BM_CopyMatchState(benchmark::State& state) {
+    BenchmarkMatch setup;
+    MatchState saved;
+    MatchState copy;
+    setup.match.saveState(saved);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(saved);
+        copy = saved;
+        benchmark::DoNotOptimize(copy);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * sizeof(MatchState)));
+}
+BENCHMARK(BM_CopyMatchState);
+
+static void BM_ChecksumMatchState(benchmark::State& state) {
+    BenchmarkMatch setup;
+    MatchState saved;
+    setup.match.saveState(saved);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(saved);
+        benchmark::DoNotOptimize(checksumMatchState(saved));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * sizeof(MatchState)));
+}
+BENCHMARK(BM_ChecksumMatchState);
+
+/**
+ * The full per-frame checksum, including the active boxes, next to the 16.67 ms that a frame has.
+ */
+static void BM_ChecksumMatch(benchmark::State& state) {
+    BenchmarkMatch setup;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(setup.match.checksum());
+    }
+}
+BENCHMARK(BM_ChecksumMatch);
+
+/**
+ * One frame of the match, to compare the checksum against.
+ */
+static void BM_StepMatch(benchmark::State& state) {
+    BenchmarkMatch setup;
+    for (auto _ : state) {
+        setup.match.step();
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_StepMatch);
+
+BENCHMARK_MAIN();
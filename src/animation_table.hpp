@@ -0,0 +1,224 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Where an animation's frames are located in an @c AnimationTable .
+ */
+struct AnimationSpan {
+    uint32_t offset = 0U; /**< The index of the animation's first frame. */
+    uint16_t count = 0U; /**< How many frames the animation has, 0 if the animation does not exist. */
+};
+
+/**
+ * A dense table of animations, built when a character is loaded, to which rarely used animations can be added later.
+ *
+ * Animation types are grouped in ranges by their high byte (normals, specials @c 0x02XX, meter assets @c 0xF0XX, etc.).
+ * The high byte selects a page, and the low byte selects the animation within that page, so finding an animation
+ * takes two array lookups. The frames of every animation are stored back to back in one contiguous array.
+ * @tparam T The type of frame stored in the table.
+ */
+template <typename T>
+class AnimationTable {
+private:
+    static constexpr uint8_t noPage = 0xFFU; /**< Marks a high byte that has no animations. */
+    std::array<uint8_t, 0x100> pageIndices; /**< The page of each high byte of an animation type, @c noPage if there is none. */
+    std::vector<std::array<AnimationSpan, 0x100>> pages; /**< Where the frames of each animation are, indexed by the low byte of its type. */
+    std::vector<T> frames; /**< The frames of every animation, back to back. */
+    /**
+     * Gets the location of an animation's frames.
+     * @param type The type of animation.
+     * @return The location of the animation, with a count of 0 if it does not exist.
+     */
+    AnimationSpan find(unsigned short type) const;
+public:
+    /**
+     * Constructs a table with no animations.
+     */
+    AnimationTable();
+    /**
+     * Constructs a table out of animations read from a data file.
+     * @param animations The frames of each animation, which are moved into the table.
+     * @exception std::length_error There are too many animation ranges or frames to index.
+     */
+    explicit AnimationTable(std::map<unsigned short, std::vector<T>>&& animations);
+    /**
+     * Makes room for frames, so that adding animations with that many frames in total does not move the frames already in the table.
+     * @param frameCount How many frames the table will have.
+     * @exception std::length_error There are too many frames to index.
+     */
+    void reserve(size_t frameCount);
+    /**
+     * Adds an animation to the table, after the frames of every other animation. Unless room was made for them with
+     * @c AnimationTable::reserve , this moves the frames already in the table.
+     * @param type The type of animation, which must not be in the table yet.
+     * @param animation The frames of the animation, which are moved into the table. Nothing is added if it is empty.
+     * @exception std::length_error There are too many animation ranges or frames to index.
+     */
+    void add(unsigned short type, std::vector<T>&& animation);
+    /**
+     * Checks whether an animation exists.
+     * @param type The type of animation.
+     * @return Whether the animation has at least one frame.
+     */
+    bool contains(unsigned short type) const;
+    /**
+     * Gets the frames of an animation.
+     * @param type The type of animation.
+     * @return The frames of the animation.
+     * @exception std::out_of_range The animation does not exist.
+     */
+    std::span<const T> at(unsigned short type) const;
+    /**
+     * Gets one frame of an animation.
+     * @param type The type of animation.
+     * @param index The index of the frame, starting from 0.
+     * @return The frame.
+     * @exception std::out_of_range The animation or frame does not exist.
+     */
+    const T& at(unsigned short type, size_t index) const;
+    /**
+     * Gets how many frames an animation has.
+     * @param type The type of animation.
+     * @return The number of frames, 0 if the animation does not exist.
+     */
+    size_t size(unsigned short type) const;
+    /**
+     * Gets the type of every animation in the table.
+     * @return The types of the animations that have at least one frame, in ascending order.
+     */
+    std::vector<unsigned short> types() const;
+    /**
+     * Gets every frame of every animation.
+     * @return The frames of all animations, back to back.
+     */
+    std::span<T> allFrames();
+    /**
+     * Gets every frame of every animation.
+     * @return The frames of all animations, back to back.
+     */
+    std::span<const T> allFrames() const;
+};
+
+template <typename T>
+AnimationTable<T>::AnimationTable() : pages{}, frames{} {
+    this->pageIndices.fill(noPage);
+}
+
+template <typename T>
+AnimationTable<T>::AnimationTable(std::map<unsigned short, std::vector<T>>&& animations) : AnimationTable() {
+    size_t frameCount = 0UZ;
+    for (const auto& [type, animation] : animations) {
+        frameCount += animation.size();
+    }
+    this->reserve(frameCount);
+    for (auto& [type, animation] : animations) {
+        this->add(type, std::move(animation));
+    }
+    animations.clear();
+}
+
+template <typename T>
+void AnimationTable<T>::reserve(const size_t frameCount) {
+    if (frameCount > UINT32_MAX) {
+        throw std::length_error(std::string("Too many frames to fit in an animation table: ") + std::to_string(frameCount));
+    }
+    this->frames.reserve(frameCount);
+}
+
+template <typename T>
+void AnimationTable<T>::add(const unsigned short type, std::vector<T>&& animation) {
+    if (animation.empty()) {
+        return;
+    }
+    if (animation.size() > UINT16_MAX) {
+        throw std::length_error(std::string("Too many frames in animation ") + std::to_string(type) + ": " + std::to_string(animation.size()));
+    }
+    if (this->frames.size() + animation.size() > UINT32_MAX) {
+        throw std::length_error(std::string("Too many frames to fit in an animation table: ") + std::to_string(this->frames.size() + animation.size()));
+    }
+    const uint8_t high = type >> 8;
+    if (this->pageIndices[high] == noPage) {
+        if (this->pages.size() >= noPage) {
+            throw std::length_error(std::string("Too many animation ranges to fit in an animation table"));
+        }
+        this->pageIndices[high] = static_cast<uint8_t>(this->pages.size());
+        this->pages.emplace_back();
+    }
+    this->pages[this->pageIndices[high]][type & 0xFFU] = AnimationSpan(static_cast<uint32_t>(this->frames.size()),
+                                                                       static_cast<uint16_t>(animation.size()));
+    for (T& frame : animation) {
+        this->frames.push_back(std::move(frame));
+    }
+}
+
+template <typename T>
+AnimationSpan AnimationTable<T>::find(const unsigned short type) const {
+    const uint8_t page = this->pageIndices[(type >> 8) & 0xFFU];
+    if (page == noPage) {
+        return AnimationSpan();
+    }
+    return this->pages[page][type & 0xFFU];
+}
+
+template <typename T>
+bool AnimationTable<T>::contains(const unsigned short type) const {
+    return this->find(type).count != 0U;
+}
+
+template <typename T>
+std::span<const T> AnimationTable<T>::at(const unsigned short type) const {
+    const AnimationSpan location = this->find(type);
+    if (location.count == 0U) {
+        throw std::out_of_range(std::string("No animation of type ") + std::to_string(type));
+    }
+    return std::span<const T>(this->frames.data() + location.offset, location.count);
+}
+
+template <typename T>
+const T& AnimationTable<T>::at(const unsigned short type, const size_t index) const {
+    const AnimationSpan location = this->find(type);
+    if (index >= location.count) {
+        throw std::out_of_range(std::string("No frame ") + std::to_string(index) + " in animation of type " + std::to_string(type));
+    }
+    return this->frames[location.offset + index];
+}
+
+template <typename T>
+size_t AnimationTable<T>::size(const unsigned short type) const {
+    return this->find(type).count;
+}
+
+template <typename T>
+std::vector<unsigned short> AnimationTable<T>::types() const {
+    std::vector<unsigned short> result;
+    for (size_t high = 0UZ; high < this->pageIndices.size(); ++high) {
+        if (this->pageIndices[high] == noPage) {
+            continue;
+        }
+        const std::array<AnimationSpan, 0x100>& page = this->pages[this->pageIndices[high]];
+        for (size_t low = 0UZ; low < page.size(); ++low) {
+            if (page[low].count != 0U) {
+                result.push_back(static_cast<unsigned short>((high << 8) | low));
+            }
+        }
+    }
+    return result;
+}
+
+template <typename T>
+std::span<T> AnimationTable<T>::allFrames() {
+    return std::span<T>(this->frames);
+}
+
+template <typename T>
+std::span<const T> AnimationTable<T>::allFrames() const {
+    return std::span<const T>(this->frames);
+}
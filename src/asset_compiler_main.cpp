@@ -0,0 +1,149 @@
+#include "character_container.hpp"
+#include "character_data.hpp"
+#include "compiled_character.hpp"
+#include "data_exception.hpp"
+
+#include <cstddef>
+#include <exception>
+#include <expected>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <SDL3/SDL.h>
+#include <SDL3_image/SDL_image.h>
+
+/**
+ * Prints how to use the asset compiler.
+ * @param program The name of the program.
+ */
+static void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " <character.ff> <sprite-sheet.png> <output.ffc>" << std::endl
+              << "Reads a character's data and sprite sheet, resolves copied sprites, scales the boxes, checks that the" << std::endl
+              << "game can use them, and writes them in the layout that the game reads in place." << std::endl
+              << "       " << program << " --container <character.ff> <output.ff>" << std::endl
+              << "Rewrites a character's data in the container layout, with an animation directory, each animation" << std::endl
+              << "compressed on its own, and every copied sprite resolved." << std::endl;
+}
+
+/**
+ * Reads a character's data file.
+ * @param path The path of the *.ff file.
+ * @return The character's data.
+ * @exception DataException Any of the exceptions thrown by @c readCharacterData , or a @c DataException<int> when the file cannot be opened.
+ */
+static CharacterData readDataFile(const std::string& path) {
+    SDL_IOStream* stream = SDL_IOFromFile(path.c_str(), "rb");
+    if (stream == nullptr) {
+        throw DataException<int>(std::string(__PRETTY_FUNCTION__) + " while opening " + path, std::string(SDL_GetError()));
+    }
+    try {
+        CharacterData data = readCharacterData(stream);
+        SDL_CloseIO(stream);
+        return data;
+    } catch (...) {
+        SDL_CloseIO(stream);
+        throw;
+    }
+}
+
+/**
+ * Decodes a sprite sheet into the pixel format that the game uploads.
+ * @param path The path of the image.
+ * @return The sprite sheet in @c SDL_PIXELFORMAT_RGBA32 , which must be destroyed with @c SDL_DestroySurface .
+ * @exception DataException Throws a @c DataException<int> when the image cannot be decoded or converted.
+ */
+static SDL_Surface* decodeSpriteSheet(const std::string& path) {
+    SDL_Surface* decoded = IMG_Load(path.c_str());
+    if (decoded == nullptr) {
+        throw DataException<int>(std::string(__PRETTY_FUNCTION__) + " while decoding " + path, std::string(SDL_GetError()));
+    }
+    if (decoded->format == SDL_PIXELFORMAT_RGBA32) {
+        return decoded;
+    }
+    SDL_Surface* converted = SDL_ConvertSurface(decoded, SDL_PIXELFORMAT_RGBA32);
+    SDL_DestroySurface(decoded);
+    if (converted == nullptr) {
+        throw DataException<int>(std::string(__PRETTY_FUNCTION__) + " while converting " + path, std::string(SDL_GetError()));
+    }
+    return converted;
+}
+
+/**
+ * Rewrites a *.ff file in the container layout.
+ * @param dataPath The path of the *.ff file, in either layout.
+ * @param outputPath The path of the *.ff container to write.
+ * @return The exit code.
+ */
+static int writeContainer(const std::string& dataPath, const std::string& outputPath) {
+    std::ifstream input(dataPath, std::ios::binary);
+    const std::vector<char> file{std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>()};
+    if (!input.eof()) {
+        std::cerr << "Error reading " << dataPath << std::endl;
+        return 1;
+    }
+    const std::span<const std::byte> bytes = std::as_bytes(std::span(file));
+    // The boxes are stored as they are written, so they are only scaled when the game reads them.
+    std::expected<CharacterData, CharacterDataError> data = parseCharacterData(bytes, false);
+    std::expected<std::vector<std::byte>, CharacterDataError> container = data
+        ? writeCharacterContainer(*data, true)
+        : std::unexpected(data.error());
+    if (container) {
+        // Reading it back checks the layout the same way the game will.
+        if (std::expected<CharacterData, CharacterDataError> check = parseCharacterData(*container); !check) {
+            container = std::unexpected(check.error());
+        }
+    }
+    if (!container) {
+        std::cerr << "Error converting " << dataPath << " while " << container.error().origin << " at byte "
+                  << container.error().position << ":" << std::endl << container.error().error << std::endl;
+        return 1;
+    }
+    std::ofstream output(outputPath, std::ios::binary);
+    output.write(reinterpret_cast<const char*>(container->data()), static_cast<std::streamsize>(container->size()));
+    if (!output) {
+        std::cerr << "Error writing " << outputPath << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc == 4 && std::string(argv[1]) == "--container") {
+        return writeContainer(argv[2], argv[3]);
+    }
+    if (argc != 4) {
+        printUsage(argv[0]);
+        return argc == 2 && (std::string(argv[1]) == "--help" || std::string(argv[1]) == "-h") ? 0 : 1;
+    }
+    const std::string dataPath = argv[1];
+    const std::string spriteSheetPath = argv[2];
+    const std::string outputPath = argv[3];
+    try {
+        const CharacterData data = readDataFile(dataPath);
+        SDL_Surface* spriteSheet = decodeSpriteSheet(spriteSheetPath);
+        std::vector<std::byte> compiled;
+        try {
+            compiled = compileCharacter(data, spriteSheet);
+        } catch (...) {
+            SDL_DestroySurface(spriteSheet);
+            throw;
+        }
+        SDL_DestroySurface(spriteSheet);
+        // Reading it back checks the layout the same way the game will.
+        readCompiledCharacter(CompiledCharacter(compiled));
+        std::ofstream output(outputPath, std::ios::binary);
+        output.write(reinterpret_cast<const char*>(compiled.data()), static_cast<std::streamsize>(compiled.size()));
+        if (!output) {
+            std::cerr << "Error writing " << outputPath << std::endl;
+            return 1;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error compiling " << dataPath << " and " << spriteSheetPath << ":" << std::endl << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
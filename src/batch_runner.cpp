@@ -0,0 +1,172 @@
+#include "batch_runner.hpp"
+
+#include "command_input_parser.hpp"
+#include "match.hpp"
+#include "replay.hpp"
+#include "work_stealing_pool.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * The number of matches given to a worker at once, so that queueing costs little next to playing.
+ */
+constexpr size_t matchesPerTask = 4UZ;
+
+/**
+ * Creates the controller of one player of a batch match.
+ * @param config What to play.
+ * @param script The player's script.
+ * @param seed The seed of the player's random inputs.
+ * @return The command input parser for the player.
+ */
+static std::unique_ptr<BaseCommandInputParser> makeBatchController(const BatchConfig& config,
+                                                                   const std::vector<InputHistoryEntry>& script,
+                                                                   const uint_fast32_t seed) {
+    if (script.empty() && config.randomInputs) {
+        return std::make_unique<RandomCommandInputParser>(seed);
+    }
+    return std::make_unique<ScriptedCommandInputParser>(script);
+}
+
+/**
+ * Gets ready to record a match.
+ * @param trace If not @c nullptr , where the match will be recorded after every frame.
+ * @param frames The number of frames that will be played.
+ */
+static void startTrace(FrameTrace* trace, const unsigned long long frames) {
+    if (trace == nullptr) {
+        return;
+    }
+    trace->checksums.clear();
+    trace->checksums.reserve(frames);
+    trace->states.clear();
+    if (trace->keepStates) {
+        trace->states.reserve(frames);
+    }
+}
+
+/**
+ * Records a match after a frame.
+ * @param trace If not @c nullptr , where to record the match.
+ * @param match The match.
+ */
+static void traceFrame(FrameTrace* trace, Match& match) {
+    if (trace == nullptr) {
+        return;
+    }
+    trace->checksums.push_back(match.checksum());
+    if (trace->keepStates) {
+        match.saveState(trace->states.emplace_back());
+    }
+}
+
+/**
+ * Fills in how a match ended.
+ * @param match The match, once it is over.
+ * @param result Where to put the frames, healths and outcome.
+ */
+static void scoreMatch(Match& match, MatchResult& result) {
+    result.frames = match.getFrame();
+    result.player1Health = match.getPlayer1().getCurrentHealth();
+    result.player2Health = match.getPlayer2().getCurrentHealth();
+    if (result.player1Health > result.player2Health) {
+        result.outcome = PLAYER_1_WIN;
+    } else if (result.player2Health > result.player1Health) {
+        result.outcome = PLAYER_2_WIN;
+    } else {
+        result.outcome = DRAW;
+    }
+}
+
+MatchResult playBatchMatch(const BatchConfig& config, const size_t index, FrameTrace* trace, ReplayRecorder* recorder) {
+    const size_t rosterSize = config.roster.size();
+    const size_t pairing = index / config.matchesPerPairing;
+    MatchResult result;
+    result.player1 = pairing / rosterSize;
+    result.player2 = pairing % rosterSize;
+
+    const uint_fast32_t seed = config.seed + static_cast<uint_fast32_t>(index) * 2U;
+    std::unique_ptr<BaseCommandInputParser> player1Controller = makeBatchController(config, config.player1Script, seed);
+    std::unique_ptr<BaseCommandInputParser> player2Controller = makeBatchController(config, config.player2Script, seed + 1U);
+    Match match(config.roster[result.player1].c_str(), player1Controller.get(),
+                config.roster[result.player2].c_str(), player2Controller.get());
+    startTrace(trace, config.ticks);
+    for (unsigned long long t = 0ULL; t < config.ticks; ++t) {
+        match.step();
+        traceFrame(trace, match);
+        if (recorder != nullptr) {
+            recorder->recordFrame(match.getPlayer1().getLastInput(), match.getPlayer2().getLastInput());
+        }
+    }
+
+    scoreMatch(match, result);
+    return result;
+}
+
+MatchResult playReplay(const Replay& replay, FrameTrace* trace) {
+    MatchResult result;
+    result.player1 = 0UZ;
+    result.player2 = 1UZ;
+    ScriptedCommandInputParser player1Controller(replay.inputs[0], false);
+    ScriptedCommandInputParser player2Controller(replay.inputs[1], false);
+    Match match(replay.characters[0].c_str(), &player1Controller, replay.characters[1].c_str(), &player2Controller);
+    startTrace(trace, replay.frames);
+    for (uint64_t frame = 0U; frame < replay.frames; ++frame) {
+        match.step();
+        traceFrame(trace, match);
+    }
+    scoreMatch(match, result);
+    return result;
+}
+
+BatchReport runBatch(const BatchConfig& config) {
+    BatchReport report;
+    const size_t rosterSize = config.roster.size();
+    report.matches = rosterSize * rosterSize * config.matchesPerPairing;
+    std::vector<MatchResult> results(report.matches);
+
+    const auto start = std::chrono::steady_clock::now();
+    {
+        WorkStealingPool pool(config.threads);
+        report.threads = pool.size();
+        for (size_t first = 0UZ; first < report.matches; first += matchesPerTask) {
+            const size_t last = std::min(first + matchesPerTask, report.matches);
+            // Each match writes only its own result, so the results need no lock.
+            pool.submit([&config, &results, first, last] {
+                for (size_t i = first; i < last; ++i) {
+                    results[i] = playBatchMatch(config, i);
+                }
+            });
+        }
+        pool.wait();
+    }
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    report.pairings.resize(rosterSize * rosterSize);
+    for (size_t i = 0UZ; i < report.pairings.size(); ++i) {
+        report.pairings[i].player1 = config.roster[i / rosterSize];
+        report.pairings[i].player2 = config.roster[i % rosterSize];
+    }
+    for (const MatchResult& result : results) {
+        PairingResult& pairing = report.pairings[result.player1 * rosterSize + result.player2];
+        ++pairing.matches;
+        pairing.frames += result.frames;
+        report.frames += result.frames;
+        switch (result.outcome) {
+            case PLAYER_1_WIN:
+                ++pairing.player1Wins;
+                break;
+            case PLAYER_2_WIN:
+                ++pairing.player2Wins;
+                break;
+            case DRAW:
+                ++pairing.draws;
+                break;
+        }
+    }
+    return report;
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "desync.hpp"
+#include "input_history.hpp"
+#include "replay.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * How a match ended.
+ */
+enum MatchOutcome : uint8_t {
+    PLAYER_1_WIN, /**< Player 1 had more health left. */
+    PLAYER_2_WIN, /**< Player 2 had more health left. */
+    DRAW /**< Both players had the same health left. */
+};
+
+/**
+ * The result of one match of a batch.
+ */
+struct MatchResult {
+    size_t player1 = 0UZ; /**< The index of player 1's character in the roster. */
+    size_t player2 = 0UZ; /**< The index of player 2's character in the roster. */
+    unsigned long long frames = 0ULL; /**< The number of frames simulated. */
+    unsigned short player1Health = 0U; /**< The health that player 1 had left. */
+    unsigned short player2Health = 0U; /**< The health that player 2 had left. */
+    MatchOutcome outcome = DRAW; /**< How the match ended. */
+};
+
+/**
+ * The results of every match between two characters of the roster.
+ */
+struct PairingResult {
+    std::string player1; /**< The name of player 1's character. */
+    std::string player2; /**< The name of player 2's character. */
+    size_t matches = 0UZ; /**< The number of matches played. */
+    size_t player1Wins = 0UZ; /**< The number of matches won by player 1. */
+    size_t player2Wins = 0UZ; /**< The number of matches won by player 2. */
+    size_t draws = 0UZ; /**< The number of matches that ended in a draw. */
+    unsigned long long frames = 0ULL; /**< The number of frames simulated over every match. */
+};
+
+/**
+ * What to play in a batch.
+ */
+struct BatchConfig {
+    std::vector<std::string> roster = {"Debuggy"}; /**< The characters to play. Every character plays every character, mirrors included. */
+    size_t matchesPerPairing = 1UZ; /**< The number of matches to play for each pair of characters. */
+    unsigned long long ticks = 3600ULL; /**< The number of frames to simulate per match. */
+    size_t threads = 0UZ; /**< The number of threads to play on, 0 for one per hardware thread. */
+    bool randomInputs = false; /**< Whether players without a script mash random inputs (@c true) or stay neutral (@c false). */
+    uint_fast32_t seed = 0U; /**< The seed of the random inputs. Each match derives its own seeds from it and its index. */
+    std::vector<InputHistoryEntry> player1Script; /**< The inputs of player 1, empty to use random or neutral inputs. */
+    std::vector<InputHistoryEntry> player2Script; /**< The inputs of player 2, empty to use random or neutral inputs. */
+};
+
+/**
+ * The results of a batch.
+ */
+struct BatchReport {
+    std::vector<PairingResult> pairings; /**< The results of each pair of characters, in roster order. */
+    size_t matches = 0UZ; /**< The number of matches played. */
+    unsigned long long frames = 0ULL; /**< The number of frames simulated over every match. */
+    size_t threads = 0UZ; /**< The number of threads that the matches were played on. */
+    double seconds = 0.0; /**< How long the batch took, in seconds. */
+};
+
+/**
+ * Plays one match of a batch. Only touches state belonging to the match, so any number can run at once.
+ * @param config What to play.
+ * @param index The index of the match in the batch, which decides the characters and the random seeds.
+ * @param trace If not @c nullptr , where to record the match after every frame.
+ * @param recorder If not @c nullptr , records the inputs of the match.
+ * @return The result of the match.
+ * @exception DataException Any of the exceptions thrown by @c Character::Character .
+ */
+MatchResult playBatchMatch(const BatchConfig& config, size_t index, FrameTrace* trace = nullptr, ReplayRecorder* recorder = nullptr);
+
+/**
+ * Plays a replay back as fast as possible.
+ * @param replay The replay to play.
+ * @param trace If not @c nullptr , where to record the match after every frame.
+ * @return The result of the match, with the indices of the characters in @c Replay::characters .
+ * @exception DataException Any of the exceptions thrown by @c Character::Character .
+ */
+MatchResult playReplay(const Replay& replay, FrameTrace* trace = nullptr);
+
+/**
+ * Plays every match of a batch, spread over a @c WorkStealingPool .
+ * @param config What to play.
+ * @return The results, which do not depend on the number of threads.
+ * @exception std::exception Rethrows the first exception thrown by a match.
+ */
+BatchReport runBatch(const BatchConfig& config);
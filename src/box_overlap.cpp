@@ -0,0 +1,214 @@
+#include "box_overlap.hpp"
+
+#include "character.hpp"
+#include "character_data.hpp"
+#include "scalar.hpp"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+/**
+ * Gets an edge as the overlap kernel compares it.
+ * @param value The edge.
+ * @return The raw value of the edge.
+ */
+static BoxEdge toBoxEdge(const Scalar value) {
+#if FOSS_FIGHT_FIXED_POINT
+    return value.getRaw();
+#else
+    return value;
+#endif
+}
+
+void BoxColumns::clear() {
+    this->left.clear();
+    this->top.clear();
+    this->right.clear();
+    this->bottom.clear();
+    this->indices.clear();
+}
+
+void BoxColumns::push(const ScalarRect& rect, const uint16_t index) {
+    const Scalar right = rect.x + rect.w;
+    const Scalar bottom = rect.y + rect.h;
+    // hasIntersection never matches these, and leaving them out lets the kernel compare only opposite edges.
+    if (rect.w < Scalar(0) || rect.h < Scalar(0) || right < rect.x || bottom < rect.y) {
+        return;
+    }
+    this->left.push_back(toBoxEdge(rect.x));
+    this->top.push_back(toBoxEdge(rect.y));
+    this->right.push_back(toBoxEdge(right));
+    this->bottom.push_back(toBoxEdge(bottom));
+    this->indices.push_back(index);
+}
+
+size_t BoxColumns::size() const {
+    return this->indices.size();
+}
+
+void CharacterBoxColumns::pack(const std::span<const ActiveBox> boxes) {
+    this->hitboxes.clear();
+    this->hurtboxes.clear();
+    this->grabs.clear();
+    this->bodies.clear();
+    this->proximityGuards.clear();
+    for (size_t i = 0UZ; i < boxes.size(); ++i) {
+        const BoxType type = boxes[i].box->boxType;
+        const uint16_t index = static_cast<uint16_t>(i);
+        if (type >= HITBOX_BEGIN && type <= HITBOX_END) {
+            this->hitboxes.push(boxes[i].rect, index);
+            continue;
+        }
+        switch (type) {
+            case HURTBOX:
+                this->hurtboxes.push(boxes[i].rect, index);
+                break;
+            case COMMAND_GRAB:
+                this->grabs.push(boxes[i].rect, index);
+                break;
+            case THROW_PUSH_GROUND_COLLISION:
+                this->bodies.push(boxes[i].rect, index);
+                break;
+            case PROXIMITY_GUARD:
+                this->proximityGuards.push(boxes[i].rect, index);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+void BoxCollisions::clear() {
+    this->player1Hits.clear();
+    this->player2Hits.clear();
+    this->player1Throws.clear();
+    this->player2Throws.clear();
+    this->pushes.clear();
+    this->player1Guards.clear();
+    this->player2Guards.clear();
+}
+
+#if defined(__AVX2__)
+/**
+ * How many boxes the kernel compares at once.
+ */
+static constexpr size_t boxLanes = 8UZ;
+
+/**
+ * Compares one box with the next @c boxLanes boxes of a column.
+ * @param columns The boxes.
+ * @param first The first box to compare with.
+ * @param left The x-coordinate of the box.
+ * @param top The y-coordinate of the box.
+ * @param right The right edge of the box.
+ * @param bottom The bottom edge of the box.
+ * @return A bit for each box that overlaps, lowest first.
+ */
+static uint32_t overlapLanes(const BoxColumns& columns, const size_t first, const BoxEdge left, const BoxEdge top, const BoxEdge right, const BoxEdge bottom) {
+#if FOSS_FIGHT_FIXED_POINT
+    const __m256i otherLeft = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(columns.left.data() + first));
+    const __m256i otherTop = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(columns.top.data() + first));
+    const __m256i otherRight = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(columns.right.data() + first));
+    const __m256i otherBottom = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(columns.bottom.data() + first));
+    const __m256i apart = _mm256_or_si256(_mm256_or_si256(_mm256_cmpgt_epi32(_mm256_set1_epi32(left), otherRight),
+                                                          _mm256_cmpgt_epi32(otherLeft, _mm256_set1_epi32(right))),
+                                          _mm256_or_si256(_mm256_cmpgt_epi32(_mm256_set1_epi32(top), otherBottom),
+                                                          _mm256_cmpgt_epi32(otherTop, _mm256_set1_epi32(bottom))));
+    return ~static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(apart))) & 0xFFU;
+#else
+    const __m256 otherLeft = _mm256_loadu_ps(columns.left.data() + first);
+    const __m256 otherTop = _mm256_loadu_ps(columns.top.data() + first);
+    const __m256 otherRight = _mm256_loadu_ps(columns.right.data() + first);
+    const __m256 otherBottom = _mm256_loadu_ps(columns.bottom.data() + first);
+    const __m256 together = _mm256_and_ps(_mm256_and_ps(_mm256_cmp_ps(_mm256_set1_ps(left), otherRight, _CMP_LE_OQ),
+                                                        _mm256_cmp_ps(otherLeft, _mm256_set1_ps(right), _CMP_LE_OQ)),
+                                          _mm256_and_ps(_mm256_cmp_ps(_mm256_set1_ps(top), otherBottom, _CMP_LE_OQ),
+                                                        _mm256_cmp_ps(otherTop, _mm256_set1_ps(bottom), _CMP_LE_OQ)));
+    return static_cast<uint32_t>(_mm256_movemask_ps(together));
+#endif
+}
+#elif defined(__SSE2__)
+/**
+ * How many boxes the kernel compares at once.
+ */
+static constexpr size_t boxLanes = 4UZ;
+
+/**
+ * Compares one box with the next @c boxLanes boxes of a column.
+ * @param columns The boxes.
+ * @param first The first box to compare with.
+ * @param left The x-coordinate of the box.
+ * @param top The y-coordinate of the box.
+ * @param right The right edge of the box.
+ * @param bottom The bottom edge of the box.
+ * @return A bit for each box that overlaps, lowest first.
+ */
+static uint32_t overlapLanes(const BoxColumns& columns, const size_t first, const BoxEdge left, const BoxEdge top, const BoxEdge right, const BoxEdge bottom) {
+#if FOSS_FIGHT_FIXED_POINT
+    const __m128i otherLeft = _mm_loadu_si128(reinterpret_cast<const __m128i*>(columns.left.data() + first));
+    const __m128i otherTop = _mm_loadu_si128(reinterpret_cast<const __m128i*>(columns.top.data() + first));
+    const __m128i otherRight = _mm_loadu_si128(reinterpret_cast<const __m128i*>(columns.right.data() + first));
+    const __m128i otherBottom = _mm_loadu_si128(reinterpret_cast<const __m128i*>(columns.bottom.data() + first));
+    const __m128i apart = _mm_or_si128(_mm_or_si128(_mm_cmpgt_epi32(_mm_set1_epi32(left), otherRight),
+                                                    _mm_cmpgt_epi32(otherLeft, _mm_set1_epi32(right))),
+                                       _mm_or_si128(_mm_cmpgt_epi32(_mm_set1_epi32(top), otherBottom),
+                                                    _mm_cmpgt_epi32(otherTop, _mm_set1_epi32(bottom))));
+    return ~static_cast<uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(apart))) & 0xFU;
+#else
+    const __m128 otherLeft = _mm_loadu_ps(columns.left.data() + first);
+    const __m128 otherTop = _mm_loadu_ps(columns.top.data() + first);
+    const __m128 otherRight = _mm_loadu_ps(columns.right.data() + first);
+    const __m128 otherBottom = _mm_loadu_ps(columns.bottom.data() + first);
+    const __m128 together = _mm_and_ps(_mm_and_ps(_mm_cmple_ps(_mm_set1_ps(left), otherRight),
+                                                  _mm_cmple_ps(otherLeft, _mm_set1_ps(right))),
+                                       _mm_and_ps(_mm_cmple_ps(_mm_set1_ps(top), otherBottom),
+                                                  _mm_cmple_ps(otherTop, _mm_set1_ps(bottom))));
+    return static_cast<uint32_t>(_mm_movemask_ps(together));
+#endif
+}
+#endif
+
+void findOverlaps(const BoxColumns& first, const BoxColumns& second, std::vector<BoxOverlap>& overlaps) {
+    const size_t count = second.size();
+#if defined(__AVX2__) || defined(__SSE2__)
+    // The vectorized part stops at the last whole group of lanes, and the rest is compared one box at a time.
+    const size_t vectorized = count - count % boxLanes;
+#endif
+    for (size_t i = 0UZ; i < first.size(); ++i) {
+        const BoxEdge left = first.left[i];
+        const BoxEdge top = first.top[i];
+        const BoxEdge right = first.right[i];
+        const BoxEdge bottom = first.bottom[i];
+        size_t j = 0UZ;
+#if defined(__AVX2__) || defined(__SSE2__)
+        for (; j < vectorized; j += boxLanes) {
+            for (uint32_t lanes = overlapLanes(second, j, left, top, right, bottom); lanes != 0U; lanes &= lanes - 1U) {
+                overlaps.emplace_back(first.indices[i], second.indices[j + static_cast<size_t>(std::countr_zero(lanes))]);
+            }
+        }
+#endif
+        for (; j < count; ++j) {
+            if (left <= second.right[j] && second.left[j] <= right && top <= second.bottom[j] && second.top[j] <= bottom) {
+                overlaps.emplace_back(first.indices[i], second.indices[j]);
+            }
+        }
+    }
+}
+
+void collideBoxes(const CharacterBoxColumns& player1, const CharacterBoxColumns& player2, BoxCollisions& collisions) {
+    collisions.clear();
+    findOverlaps(player1.hitboxes, player2.hurtboxes, collisions.player1Hits);
+    findOverlaps(player2.hitboxes, player1.hurtboxes, collisions.player2Hits);
+    findOverlaps(player1.grabs, player2.bodies, collisions.player1Throws);
+    findOverlaps(player2.grabs, player1.bodies, collisions.player2Throws);
+    findOverlaps(player1.bodies, player2.bodies, collisions.pushes);
+    findOverlaps(player1.proximityGuards, player2.hurtboxes, collisions.player1Guards);
+    findOverlaps(player2.proximityGuards, player1.hurtboxes, collisions.player2Guards);
+}
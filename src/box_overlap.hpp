@@ -0,0 +1,105 @@
+#pragma once
+
+#include "character.hpp"
+#include "scalar.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/**
+ * An edge of a box as the overlap kernel compares it: the raw value of a @c Fixed , or the @c float itself.
+ */
+#if FOSS_FIGHT_FIXED_POINT
+typedef int32_t BoxEdge;
+#else
+typedef float BoxEdge;
+#endif
+
+/**
+ * Boxes of one kind on the stage in structure-of-arrays form, so that the overlap kernel compares several boxes with
+ * each instruction. Each box is stored by its edges, worked out the same way as @c hasIntersection does, and boxes that
+ * can never overlap anything (a negative width or height) are left out.
+ */
+struct BoxColumns {
+    std::vector<BoxEdge> left; /**< The x-coordinate of each box. */
+    std::vector<BoxEdge> top; /**< The y-coordinate of each box. */
+    std::vector<BoxEdge> right; /**< The x-coordinate plus the width of each box. */
+    std::vector<BoxEdge> bottom; /**< The y-coordinate plus the height of each box. */
+    std::vector<uint16_t> indices; /**< The index of each box in the character's active boxes. */
+    /**
+     * Removes every box, keeping the memory for the next tick.
+     */
+    void clear();
+    /**
+     * Adds a box, unless it can never overlap anything.
+     * @param rect The location of the box on the stage.
+     * @param index The index of the box in the character's active boxes.
+     */
+    void push(const ScalarRect& rect, uint16_t index);
+    /**
+     * Counts the boxes.
+     * @return How many boxes there are.
+     */
+    size_t size() const;
+};
+
+/**
+ * The active boxes of a character, sorted into columns by what they can collide with.
+ */
+struct CharacterBoxColumns {
+    BoxColumns hitboxes; /**< Attacks, from @c HITBOX_BEGIN to @c HITBOX_END . */
+    BoxColumns hurtboxes; /**< Where the character can be hit, @c HURTBOX . */
+    BoxColumns grabs; /**< Where the character grabs with a command grab, @c COMMAND_GRAB . */
+    BoxColumns bodies; /**< Where the character can be thrown or pushed, @c THROW_PUSH_GROUND_COLLISION . */
+    BoxColumns proximityGuards; /**< Where the opponent is forced to block, @c PROXIMITY_GUARD . */
+    /**
+     * Replaces the columns with a character's active boxes.
+     * @param boxes The character's active boxes, from @c Character::getActiveBoxes .
+     */
+    void pack(std::span<const ActiveBox> boxes);
+};
+
+/**
+ * Two boxes that overlap, by their index in each character's active boxes.
+ */
+struct BoxOverlap {
+    uint16_t first; /**< The box of the first character. */
+    uint16_t second; /**< The box of the second character. */
+};
+
+/**
+ * Every pair of boxes that overlap between two characters on one tick. Pairs are in the order of the first box, then
+ * of the second box, whichever instructions found them.
+ */
+struct BoxCollisions {
+    std::vector<BoxOverlap> player1Hits; /**< Player 1's hitboxes against player 2's hurtboxes. */
+    std::vector<BoxOverlap> player2Hits; /**< Player 2's hitboxes against player 1's hurtboxes. */
+    std::vector<BoxOverlap> player1Throws; /**< Player 1's command grabs against player 2's throw boxes. */
+    std::vector<BoxOverlap> player2Throws; /**< Player 2's command grabs against player 1's throw boxes. */
+    std::vector<BoxOverlap> pushes; /**< Player 1's push boxes against player 2's push boxes. */
+    std::vector<BoxOverlap> player1Guards; /**< Player 1's proximity guard boxes against player 2's hurtboxes. */
+    std::vector<BoxOverlap> player2Guards; /**< Player 2's proximity guard boxes against player 1's hurtboxes. */
+    /**
+     * Removes every pair, keeping the memory for the next tick.
+     */
+    void clear();
+};
+
+/**
+ * Finds every pair of overlapping boxes, the same way as @c hasIntersection : touching edges count. Uses AVX2 when the
+ * game is built with it (@c FOSS_FIGHT_AVX2 ), otherwise SSE2 on x86-64, otherwise one box at a time.
+ * @param first The boxes of the first character.
+ * @param second The boxes of the second character.
+ * @param overlaps The pairs to add to.
+ */
+void findOverlaps(const BoxColumns& first, const BoxColumns& second, std::vector<BoxOverlap>& overlaps);
+
+/**
+ * Finds every pair of overlapping boxes between two characters in one pass: hits, throws, pushes and proximity guards.
+ * @param player1 The boxes of player 1's character.
+ * @param player2 The boxes of player 2's character.
+ * @param collisions Replaced with the pairs that overlap.
+ */
+void collideBoxes(const CharacterBoxColumns& player1, const CharacterBoxColumns& player2, BoxCollisions& collisions);
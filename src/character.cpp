@@ -1,555 +1,45 @@
 #include "character.hpp"
 
+#include "character_data.hpp"
+#include "checksum.hpp"
+#include "compiled_character.hpp"
 #include "frect_helpers.hpp"
+#include "roster.hpp"
+#include "scalar.hpp"
 
 #include <algorithm>
-#include <bitset>
-#include <concepts>
-#include <iomanip>
+#include <cstdint>
 #include <iostream>
-#include <ranges>
-#include <sstream>
+#include <span>
 #include <stdexcept>
 #include <string>
-#include <type_traits>
 #include <utility>
 
 #include <SDL3/SDL.h>
-#include <SDL3_image/SDL_image.h>
 
-template <std::integral T>
-std::string format_number(T number, const bool hex, const bool binary, const bool uppercase) {
-    std::stringstream ss;
-    if (uppercase) {
-        ss << std::uppercase;
-    }
-    if (hex) {
-        ss << std::hex << "0x" << std::setfill('0') << std::setw(sizeof(T) * 2);
-        if (std::is_same_v<T, char> || std::is_same_v<T, unsigned char>) {
-            ss << static_cast<short>(number);
-        } else {
-            ss << number;
-        }
-    } else if (binary) {
-        ss << "0b" << std::setfill('0') << std::setw(sizeof(T) * 8);
-        std::bitset<sizeof(T) * 8> bits(number);
-        ss << bits;
-    } else {
-        if (std::is_same_v<T, char> || std::is_same_v<T, unsigned char>) {
-            ss << static_cast<short>(number);
-        } else {
-            ss << number;
-        }
-    }
-    if (!std::is_signed_v<T>) {
-        ss << (uppercase ? 'U' : 'u');
-    }
-    if (std::is_same_v<T, long> || std::is_same_v<T, unsigned long>) {
-        ss << (uppercase ? 'L' : 'l');
-    } else if (std::is_same_v<T, long long> || std::is_same_v<T, unsigned long long>) {
-        ss << (uppercase ? 'L' : 'l') << (uppercase ? 'L' : 'l');
-    }
-    return ss.str();
-}
-
-template <std::integral T>
-DataException<T>::DataException(std::string origin, std::string error, const T data) : origin{std::move(origin)}, error{std::move(error)}, data{data} {
-    std::stringstream ss;
-    ss << "Origin: " << this->origin << std::endl << "Error: " << this->error << std::endl << "Data: " << format_number<T>(this->data) << std::endl;
-    this->result = ss.str();
-}
-
-template <std::integral T>
-const char* DataException<T>::what() const noexcept {
-    return this->result.c_str();
-}
-
-template <std::integral T>
-void Buffer<T>::assign(T datum) {
-    if (this->height == nullptr) {
-        if (this->width == nullptr) {
-            if (this->y == nullptr) {
-                if (this->x == nullptr) {
-                    this->x = new T(datum);
-                } else {
-                    this->y = new T(datum);
-                }
-            } else {
-                this->width = new T(datum);
-            }
-        } else {
-            this->height = new T(datum);
-        }
-    } else {
-        throw std::out_of_range(std::string("Tried to assign value ") + format_number(datum) + " to full buffer!");
-    }
-}
-
-template <std::integral T>
-SDL_FRect Buffer<T>::toFRect() const {
-    if (this->x == nullptr) {
-        throw DataException<T>(std::string(__PRETTY_FUNCTION__) + " while reading this->x", std::string("this->x is a nullptr"));
-    } else if (this->y == nullptr) {
-        throw DataException<T>(std::string(__PRETTY_FUNCTION__) + " while reading this->y", std::string("this->y is a nullptr"));
-    } else if (this->width == nullptr) {
-        throw DataException<T>(std::string(__PRETTY_FUNCTION__) + " while reading this->width", std::string("this->width is a nullptr"));
-    } else if (this->height == nullptr) {
-        throw DataException<T>(std::string(__PRETTY_FUNCTION__) + " while reading this->height", std::string("this->height is a nullptr"));
-    } else {
-        return SDL_FRect(static_cast<float>(*this->x),
-                        static_cast<float>(*this->y),
-                        static_cast<float>(*this->width),
-                        static_cast<float>(*this->height));
-    }
-}
-
-template <std::integral T>
-void Buffer<T>::clear() {
-    delete this->x;
-    this->x = nullptr;
-    delete this->y;
-    this->y = nullptr;
-    delete this->width;
-    this->width = nullptr;
-    delete this->height;
-    this->height = nullptr;
-}
-
-CopyInformation::CopyInformation(unsigned short type, unsigned short index, uint8_t copyInfo) {
-    this->animationType = static_cast<AnimationType>(type);
-    this->index = index;
-    this->copyFrameLength = copyInfo & (1 << 7);
-    this->copySpriteSheetLocation = copyInfo & (1 << 6);
-    this->copyOffset = copyInfo & (1 << 5);
-    this->copyHurtboxes = copyInfo & (1 << 4);
-    this->copyCommandGrabBoxes = copyInfo & (1 << 3);
-    this->copyThrowPushAndGroundCollisionBoxes = copyInfo & (1 << 2);
-    this->copyProximityGuardBoxes = copyInfo & (1 << 1);
-    this->copyHitboxes = copyInfo & (1 << 0);
-    std::stringstream ss;
-    ss << "Copying animation " << format_number(static_cast<unsigned short>(this->animationType)) << " at index " << this->index << "." << std::endl;
-    ss << "Copying the following attributes (" << format_number(copyInfo, false, true, true) << "):" << std::endl;
-    if (copyInfo == 0b00000000U) {
-        ss << "None" << std::endl;
-    }
-    if (this->copyFrameLength) {
-        ss << "Frame Length" << std::endl;
-    }
-    if (this->copySpriteSheetLocation) {
-        ss << "Sprite Sheet Location" << std::endl;
-    }
-    if (this->copyOffset) {
-        ss << "Offset" << std::endl;
-    }
-    if (this->copyHurtboxes) {
-        ss << "Hurtboxes" << std::endl;
-    }
-    if (this->copyCommandGrabBoxes) {
-        ss << "Grab and Command Grab Boxes" << std::endl;
-    }
-    if (this->copyThrowPushAndGroundCollisionBoxes) {
-        ss << "Throw, Push and Ground Collision Boxes" << std::endl;
-    }
-    if (this->copyProximityGuardBoxes) {
-        ss << "Proximity Guard Boxes" << std::endl;
-    }
-    if (this->copyHitboxes) {
-        ss << "Hitboxes" << std::endl;
-    }
-    this->result = ss.str();
-}
-
-const char* CopyInformation::what() const noexcept {
-    return this->result.c_str();
-}
-
-
-bool boxTypeToColor(SDL_Renderer*& renderer, const BoxType boxType, const bool translucent) {
-    const uint8_t alpha = translucent ? 0x80U : 0xFFU;
-    switch (boxType) {
-        case NULL_TERMINATOR:
-            return true;
-        case HURTBOX:
-            return SDL_SetRenderDrawColor(renderer, 0x00U, 0x00U, 0xFFU, alpha); // blue
-        case COMMAND_GRAB:
-            return SDL_SetRenderDrawColor(renderer, 0xFFU, 0xA5U, 0x00U, alpha); // orange
-        case THROW_PUSH_GROUND_COLLISION:
-            return SDL_SetRenderDrawColor(renderer, 0x00U, 0xFFU, 0x00U, alpha); // green
-        case PROXIMITY_GUARD:
-            return SDL_SetRenderDrawColor(renderer, 0xFFU, 0xFFU, 0x00U, alpha); // yellow
-        default:
-            return SDL_SetRenderDrawColor(renderer, 0xFFU, 0x00U, 0x00U, alpha); // red
-    }
-}
-
-HitboxProperties::HitboxProperties(uint8_t data) {
-    this->blockableHigh = data & (1 << 7);
-    this->blockableLow = data & (1 << 6);
-    this->specialCancelable = data & (1 << 5);
-    this->superCancelable = data & (1 << 4);
-    this->knockback = static_cast<KnockbackLevel>((data & (1 << 3)) | (data & (1 << 2)));
-    this->hardKnockdown = data & (1 << 1);
-    this->airReset = data & (1 << 0);
-}
-
-void HitboxProperties::updateStatsNoKnockdown(SDL_IOStream*& stream) {
-    if (!SDL_ReadU16BE(stream, &this->hitStun)) {
-        const std::string error(SDL_GetError());
-        throw DataException<long>(std::string(__PRETTY_FUNCTION__) + " while assigning to this->hitStun", error.empty() ? std::string("Reached EOF") : error, SDL_TellIO(stream));
-    }
-    if (!SDL_ReadU16BE(stream, &this->blockStun)) {
-        const std::string error(SDL_GetError());
-        throw DataException<long>(std::string(__PRETTY_FUNCTION__) + " while assigning to this->blockStun", error.empty() ? std::string("Reached EOF") : error, SDL_TellIO(stream));
-    }
-    if (!SDL_ReadS16BE(stream, &this->hitPushback)) {
-        const std::string error(SDL_GetError());
-        throw DataException<long>(std::string(__PRETTY_FUNCTION__) + " while assigning to this->hitPushback", error.empty() ? std::string("Reached EOF") : error, SDL_TellIO(stream));
-    }
-    if (!SDL_ReadS16BE(stream, &this->blockPushback)) {
-        const std::string error(SDL_GetError());
-        throw DataException<long>(std::string(__PRETTY_FUNCTION__) + " while assigning to this->blockPushback", error.empty() ? std::string("Reached EOF") : error, SDL_TellIO(stream));
-    }
-}
-
-void HitboxProperties::updateStatsKnockdown(SDL_IOStream*& stream) {
-    if (!SDL_ReadU16BE(stream, &this->xKnockback)) {
-        const std::string error(SDL_GetError());
-        throw DataException<long>(std::string(__PRETTY_FUNCTION__) + " while assigning to this->xKnockback", error.empty() ? std::string("Reached EOF") : error, SDL_TellIO(stream));
-    }
-    if (!SDL_ReadU16BE(stream, &this->blockStun)) {
-        const std::string error(SDL_GetError());
-        throw DataException<long>(std::string(__PRETTY_FUNCTION__) + " while assigning to this->blockStun", error.empty() ? std::string("Reached EOF") : error, SDL_TellIO(stream));
-    }
-    if (!SDL_ReadS16BE(stream, &this->yKnockback)) {
-        const std::string error(SDL_GetError());
-        throw DataException<long>(std::string(__PRETTY_FUNCTION__) + " while assigning to this->yKnockback", error.empty() ? std::string("Reached EOF") : error, SDL_TellIO(stream));
-    }
-    if (!SDL_ReadS16BE(stream, &this->blockPushback)) {
-        const std::string error(SDL_GetError());
-        throw DataException<long>(std::string(__PRETTY_FUNCTION__) + " while assigning to this->blockPushback", error.empty() ? std::string("Reached EOF") : error, SDL_TellIO(stream));
-    }
-}
-
-CharacterBox::CharacterBox(SDL_IOStream*& stream, BoxType currentBoxType)
-    : boxType(currentBoxType) {
-    if (this->boxType >= HITBOX_BEGIN && this->boxType <= HITBOX_END) {
-        this->hitboxProperties = HitboxProperties(this->boxType % 256);
-    }
-    signed short bufferItem;
-    for (int k = 0; k < 4; ++k) {
-        if (SDL_ReadS16BE(stream, &bufferItem)) {
-            this->boxBuffer.assign(bufferItem);
-        } else {
-            const std::string error(SDL_GetError());
-            throw DataException<long>(std::string(__PRETTY_FUNCTION__) + " while assigning to bufferItem", error.empty() ? std::string("Reached EOF") : error, SDL_TellIO(stream));
-        }
-    }
-    this->rect = new SDL_FRect(this->boxBuffer.toFRect());
-    if (this->boxType >= HITBOX_BEGIN && this->boxType <= HITBOX_END) {
-        if (this->hitboxProperties.knockback == KNOCKS_DOWN) {
-            this->hitboxProperties.updateStatsKnockdown(stream);
-        } else {
-            this->hitboxProperties.updateStatsNoKnockdown(stream);
-        }
-    }
-}
-
-CharacterBox::CharacterBox(const BoxType currentBoxType, const HitboxProperties hitboxProperties, float x, float y, float width, float height)
-    : boxType(currentBoxType),
-    hitboxProperties{hitboxProperties} {
-    this->rect = new SDL_FRect(x, y, width, height);
-}
-
-Sprite::Sprite(SDL_IOStream*& stream, SDL_Renderer*& renderer, SDL_Surface*& spriteSheet) {
-    this->texture = SDL_CreateTexture(renderer, spriteSheet->format, SDL_TEXTUREACCESS_TARGET, spriteSheet->w, spriteSheet->h);
-    if (this->texture == nullptr) {
-        throw DataException<int>(std::string(__PRETTY_FUNCTION__) + " while assigning to this->texture", std::string(SDL_GetError()));
-    }
-    if (!SDL_SetTextureScaleMode(this->texture, SDL_SCALEMODE_NEAREST)) {
-        throw DataException<int>(std::string(__PRETTY_FUNCTION__) + " while setting scale mode for this->texture", std::string(SDL_GetError()), SDL_SCALEMODE_NEAREST);
-    }
-    if (!SDL_UpdateTexture(this->texture, nullptr, spriteSheet->pixels, spriteSheet->pitch)) {
-        throw DataException<int>(std::string(__PRETTY_FUNCTION__) + " while updating this->texture", std::string(SDL_GetError()), spriteSheet->pitch);
-    }
-    this->length = 0x0000U;
-    if (!SDL_ReadU16BE(stream, &this->length)) {
-        const std::string error(SDL_GetError());
-        throw DataException<long>(std::string(__PRETTY_FUNCTION__) + " while assigning to this->length", error.empty() ? std::string("Reached EOF") : error, SDL_TellIO(stream));
-    }
-    if (this->length >= 0xFF00U) {
-        unsigned short animationIndex;
-        unsigned short spriteIndex;
-        if (!SDL_ReadU16BE(stream, &animationIndex)) {
-            const std::string error(SDL_GetError());
-            throw DataException<long>(std::string(__PRETTY_FUNCTION__) + " while beginning to copy other sprite and assigning to animationIndex", error.empty() ? std::string("Reached EOF") : error, SDL_TellIO(stream));
-        }
-        if (!SDL_ReadU16BE(stream, &spriteIndex)) {
-            const std::string error(SDL_GetError());
-            throw DataException<long>(std::string(__PRETTY_FUNCTION__) + " while beginning to copy other sprite and assigning to spriteIndex", error.empty() ? std::string("Reached EOF") : error, SDL_TellIO(stream));
-        }
-        throw CopyInformation(animationIndex, spriteIndex, static_cast<uint8_t>(this->length % 256));
-    }
-    unsigned short data;
-    for (int i = 0; i < 4; ++i) {
-        if (SDL_ReadU16BE(stream, &data)) {
-            this->spriteSheetBuffer.assign(data);
-        } else {
-            const std::string error(SDL_GetError());
-            throw DataException<long>(std::string(__PRETTY_FUNCTION__) + " while assigning to data for buffer", error.empty() ? std::string("Reached EOF") : error, SDL_TellIO(stream));
-        }
-    }
-    this->spriteSheetArea = new SDL_FRect(this->spriteSheetBuffer.toFRect());
-    this->spriteSheetBuffer.clear();
-    if (!SDL_ReadS16BE(stream, &this->xOffset)) {
-        const std::string error(SDL_GetError());
-        throw DataException<long>(std::string(__PRETTY_FUNCTION__) + " while assigning to this->xOffset", error.empty() ? std::string("Reached EOF") : error, SDL_TellIO(stream));
-    }
-    if (!SDL_ReadS16BE(stream, &this->yOffset)) {
-        const std::string error(SDL_GetError());
-        throw DataException<long>(std::string(__PRETTY_FUNCTION__) + " while assigning to this->yOffset", error.empty() ? std::string("Reached EOF") : error, SDL_TellIO(stream));
-    }
-    unsigned short boxType;
-    unsigned short count;
-    do {
-        if (!SDL_ReadU16BE(stream, &boxType)) {
-            const std::string error(SDL_GetError());
-            throw DataException<long>(std::string(__PRETTY_FUNCTION__) + " while assigning to boxType", error.empty() ? std::string("Reached EOF") : error, SDL_TellIO(stream));
-        }
-        if (boxType != NULL_TERMINATOR) {
-            if (!SDL_ReadU16BE(stream, &count)) {
-                const std::string error(SDL_GetError());
-                throw DataException<long>(std::string(__PRETTY_FUNCTION__) + " while assigning to count", error.empty() ? std::string("Reached EOF") : error, SDL_TellIO(stream));
-            }
-            for (unsigned short j = 0U; j < count; ++j) {
-                this->charBoxes.emplace_back(
-                    stream, static_cast<BoxType>(boxType)
-                );
-            }
-        }
-    } while (boxType != NULL_TERMINATOR);
-    for (const auto& box : this->charBoxes) {
-        this->charBoxesWithAbsoluteLocation.emplace_back(box.boxType, box.hitboxProperties, box.rect->x, box.rect->y, box.rect->w, box.rect->h);
-    }
-}
-
-
-Sprite::Sprite(const Sprite& reference,
-    SDL_IOStream*& stream,
-    SDL_Renderer*& renderer,
-    SDL_Surface*& spriteSheet,
-    const CopyInformation& copy) {
-    this->texture = SDL_CreateTexture(renderer, spriteSheet->format, SDL_TEXTUREACCESS_TARGET, spriteSheet->w, spriteSheet->h);
-    if (this->texture == nullptr) {
-        throw DataException<int>(std::string(__PRETTY_FUNCTION__) + " while copying a sprite and assigning to texture", std::string(SDL_GetError()));
-    }
-    if (!SDL_SetTextureScaleMode(this->texture, SDL_SCALEMODE_NEAREST)) {
-        throw DataException<int>(std::string(__PRETTY_FUNCTION__) + " while copying a sprite and setting texture scale mode", std::string(SDL_GetError()), SDL_SCALEMODE_NEAREST);
-    }
-    if (!SDL_UpdateTexture(this->texture, nullptr, spriteSheet->pixels, spriteSheet->pitch)) {
-        throw DataException<int>(std::string(__PRETTY_FUNCTION__) + " while copying a sprite and updating texture", std::string(SDL_GetError()), spriteSheet->pitch);
-    }
-    if (copy.copyFrameLength) {
-        this->length = reference.length;
-    } else {
-        unsigned short spriteCount;
-        if (SDL_ReadU16BE(stream, &spriteCount)) {
-            this->length = spriteCount;
-        } else {
-            const std::string error(SDL_GetError());
-            throw DataException<long>(std::string(__PRETTY_FUNCTION__) + " while copying a sprite and assigning to spriteCount", error.empty() ? std::string("Reached EOF") : error, SDL_TellIO(stream));
-        }
-    }
-    if (copy.copySpriteSheetLocation) {
-        this->spriteSheetArea = new SDL_FRect(reference.spriteSheetArea->x,
-            reference.spriteSheetArea->y,
-            reference.spriteSheetArea->w,
-            reference.spriteSheetArea->h);
-    } else {
-        unsigned short coordinate;
-        for (int i = 0; i < 4; ++i) {
-            if (SDL_ReadU16BE(stream, &coordinate)) {
-                this->spriteSheetBuffer.assign(coordinate);
-            } else {
-                const std::string error(SDL_GetError());
-                throw DataException<long>(std::string(__PRETTY_FUNCTION__) + " while copying a sprite and assigning to coordinate", error.empty() ? std::string("Reached EOF") : error, SDL_TellIO(stream));
-            }
-        }
-        this->spriteSheetArea = new SDL_FRect(this->spriteSheetBuffer.toFRect());
-        this->spriteSheetBuffer.clear();
-    }
-    if (copy.copyOffset) {
-        this->xOffset = reference.xOffset;
-        this->yOffset = reference.yOffset;
-    } else {
-        if (!SDL_ReadS16BE(stream, &this->xOffset)) {
-            const std::string error(SDL_GetError());
-            throw DataException<long>(std::string(__PRETTY_FUNCTION__) + " while copying a sprite and assigning to this->xOffset", error.empty() ? std::string("Reached EOF") : error, SDL_TellIO(stream));
-        }
-        if (!SDL_ReadS16BE(stream, &this->yOffset)) {
-            const std::string error(SDL_GetError());
-            throw DataException<long>(std::string(__PRETTY_FUNCTION__) + " while copying a sprite and assigning to this->yOffset", error.empty() ? std::string("Reached EOF") : error, SDL_TellIO(stream));
-        }
-    }
-    if (!copy.copyHurtboxes
-        || !copy.copyCommandGrabBoxes
-        || !copy.copyThrowPushAndGroundCollisionBoxes
-        || !copy.copyProximityGuardBoxes
-        || !copy.copyHitboxes) {
-        unsigned short boxType;
-        unsigned short count;
-        do {
-            if (!SDL_ReadU16BE(stream, &boxType)) {
-                const std::string error(SDL_GetError());
-                throw DataException<long>(std::string(__PRETTY_FUNCTION__) + " while copying a sprite and assigning to boxType", error.empty() ? std::string("Reached EOF") : error, SDL_TellIO(stream));
-            }
-            if (boxType != NULL_TERMINATOR) {
-                if (!SDL_ReadU16BE(stream, &count)) {
-                    const std::string error(SDL_GetError());
-                    throw DataException<long>(std::string(__PRETTY_FUNCTION__) + " while copying a sprite and assigning to count", error.empty() ? std::string("Reached EOF") : error, SDL_TellIO(stream));
-                }
-                for (unsigned short j = 0x0000U; j < count; ++j) {
-                    this->charBoxes.emplace_back(
-                        stream, static_cast<BoxType>(boxType)
-                    );
-                }
-            }
-        } while (boxType != NULL_TERMINATOR);
-        for (const auto& box : this->charBoxes) {
-            this->charBoxesWithAbsoluteLocation.emplace_back(box.boxType, box.hitboxProperties, box.rect->x, box.rect->y, box.rect->w, box.rect->h);
-        }
-    }
-    bool mustCopy = false;
-    for (const auto& box : reference.charBoxes) {
-        BoxType type = box.boxType;
-        switch (type) {
-            case NULL_TERMINATOR:
-                mustCopy = false;
-                break;
-            case HURTBOX:
-                mustCopy = copy.copyHurtboxes;
-                break;
-            case COMMAND_GRAB:
-                mustCopy = copy.copyCommandGrabBoxes;
-                break;
-            case THROW_PUSH_GROUND_COLLISION:
-                mustCopy = copy.copyThrowPushAndGroundCollisionBoxes;
-                break;
-            case PROXIMITY_GUARD:
-                mustCopy = copy.copyProximityGuardBoxes;
-                break;
-            default:
-                mustCopy = copy.copyHitboxes;
-                break;
-        }
-        if (mustCopy) {
-            this->charBoxes.emplace_back(type, box.hitboxProperties, box.rect->x, box.rect->y, box.rect->w, box.rect->h);
-            this->charBoxesWithAbsoluteLocation.emplace_back(type, box.hitboxProperties, box.rect->x, box.rect->y, box.rect->w, box.rect->h);
-        }
-    }
-}
-
-SDL_FRect* Sprite::getSpriteSheetArea() const {
-    return this->spriteSheetArea;
-}
-
-unsigned short Sprite::getLength() const {
-    return this->length;
-}
-
-void Sprite::destroyTexture() const {
-    if (this->texture != nullptr) {
-        SDL_DestroyTexture(this->texture);
-    }
-}
-
-
-void Sprite::render(SDL_Renderer*& renderer, const SDL_FRect* location) const {
-    if (!SDL_RenderTexture(renderer, this->texture, this->spriteSheetArea, location)) {
-        throw DataException<unsigned int>(std::string(__PRETTY_FUNCTION__) + " while rendering sprite texture", std::string(SDL_GetError()));
-    }
-#if DEBUG_RENDER_BOXES
-    for (const auto& box : this->charBoxes) {
-        if (!boxTypeToColor(renderer, box.boxType, false)) {
-            throw DataException<unsigned char>(std::string(__PRETTY_FUNCTION__) + " while setting box outline color", std::string(SDL_GetError()));
-        }
-        if (!SDL_RenderRect(renderer, box.rect)) {
-            throw DataException<unsigned char>(std::string(__PRETTY_FUNCTION__) + " while rendering box outline", std::string(SDL_GetError()));
-        }
-        if (!boxTypeToColor(renderer, box.boxType, true)) {
-            throw DataException<unsigned char>(std::string(__PRETTY_FUNCTION__) + " while setting box color", std::string(SDL_GetError()));
-        }
-        if (!SDL_RenderFillRect(renderer, box.rect)) {
-            throw DataException<unsigned char>(std::string(__PRETTY_FUNCTION__) + " while rendering box", std::string(SDL_GetError()));
-        }
-    }
-#endif
-}
-
-const SDL_FRect* Character::ground;
-
-#define GET_SPRITES(name) \
-    extern const unsigned char _binary_data_characters_##name##_png_start[]; \
-    extern const unsigned char _binary_data_characters_##name##_png_end[]; \
-    sprites = SDL_IOFromConstMem(_binary_data_characters_##name##_png_start, _binary_data_characters_##name##_png_end - _binary_data_characters_##name##_png_start); \
-    extern const unsigned char _binary_data_characters_##name##_ff_start[]; \
-    extern const unsigned char _binary_data_characters_##name##_ff_end[]; \
-    ffFile = SDL_IOFromConstMem(_binary_data_characters_##name##_ff_start, _binary_data_characters_##name##_ff_end - _binary_data_characters_##name##_ff_start);
-
-
-Character::Character(const char* name, SDL_Renderer*& renderer, BaseCommandInputParser* controller, const SDL_FRect*& groundBox, const unsigned short paletteIndex) :
+Character::Character(const char* name, BaseCommandInputParser* controller, const SDL_FRect*& groundBox) :
+    Character(name, loadCharacterData(name), controller, groundBox) {}
+
+Character::Character(const char* name, CharacterData&& data, BaseCommandInputParser* controller, const SDL_FRect*& groundBox) :
+    ground{ScalarRect::fromFRect(*groundBox)},
+    animations{std::move(data.animations)},
+    deferred{std::move(data.deferred)},
+    size{data.stats.size},
+    walkForwardSpeed{data.stats.walkForwardSpeed},
+    walkBackwardSpeed{data.stats.walkBackwardSpeed},
+    jumpForwardXVelocity{data.stats.jumpForwardXVelocity},
+    jumpBackwardXVelocity{data.stats.jumpBackwardXVelocity},
+    initialJumpVelocity{data.stats.initialJumpVelocity},
+    gravity{data.stats.gravity},
     name{name}, inputs{InputHistory()}, controller{controller} {
-    Character::ground = groundBox;
-    unsigned short data;
-    SDL_IOStream* sprites = nullptr;
-    SDL_IOStream* ffFile = nullptr;
-    if (name == std::string("Debuggy")) {
-GET_SPRITES(Debuggy)
-    }
-    if (!SDL_ReadU16BE(ffFile, &data)) {
-        const std::string error(SDL_GetError());
-        throw DataException<long>(std::string(__PRETTY_FUNCTION__) + " while reading header", error.empty() ? std::string("Reached EOF") : error, SDL_TellIO(ffFile));
-    }
-    if (data != 0xF055U) {
-        throw DataException<unsigned short>(
-            std::string(__PRETTY_FUNCTION__) + " while checking header", std::string("Invalid header"), data);
-    }
-    this->spriteSheet = IMG_Load_IO(sprites, true);
-    if (this->spriteSheet == nullptr) {
-        throw DataException<int>(
-            std::string(__PRETTY_FUNCTION__) + " while loading sprite sheet", std::string(SDL_GetError()));
-    }
-    unsigned short numberOfPalettes;
-    if (!SDL_ReadU16BE(ffFile, &numberOfPalettes)) {
-        const std::string error(SDL_GetError());
-        throw DataException<long>(std::string(__PRETTY_FUNCTION__) + " while assigning to numberOfPalettes", error.empty() ? std::string("Reached EOF") : error, SDL_TellIO(ffFile));
-    }
-    unsigned short numberOfColors;
-    if (!SDL_ReadU16BE(ffFile, &numberOfColors)) {
-        const std::string error(SDL_GetError());
-        throw DataException<long>(std::string(__PRETTY_FUNCTION__) + " while assigning to numberOfColors", error.empty() ? std::string("Reached EOF") : error, SDL_TellIO(ffFile));
-    }
-    for (unsigned short i = 0x0000U; i < numberOfPalettes; ++i) {
-        this->altPalettes.push_back(SDL_CreatePalette(numberOfColors));
-        if (this->altPalettes.at(i) == nullptr) {
-            throw DataException<short>(std::string(__PRETTY_FUNCTION__) + " while creating alternative palette", std::string(SDL_GetError()), i);
+    for (const std::vector<SDL_Color>& colors : data.palettes) {
+        SDL_Palette* palette = SDL_CreatePalette(static_cast<int>(colors.size()));
+        if (palette == nullptr) {
+            throw DataException<short>(std::string(__PRETTY_FUNCTION__) + " while creating alternative palette", std::string(SDL_GetError()), static_cast<short>(this->altPalettes.size()));
         }
-        for (unsigned short j = 0x0000U; j < numberOfColors; ++j) {
-            uint8_t r, g, b;
-            if (!SDL_ReadU8(ffFile, &r)) {
-                const std::string error(SDL_GetError());
-                throw DataException<long>(std::string(__PRETTY_FUNCTION__) + " while assigning to r", error.empty() ? std::string("Reached EOF") : error, SDL_TellIO(ffFile));
-            }
-            if (!SDL_ReadU8(ffFile, &g)) {
-                const std::string error(SDL_GetError());
-                throw DataException<long>(std::string(__PRETTY_FUNCTION__) + " while assigning to g", error.empty() ? std::string("Reached EOF") : error, SDL_TellIO(ffFile));
-            }
-            if (!SDL_ReadU8(ffFile, &b)) {
-                const std::string error(SDL_GetError());
-                throw DataException<long>(std::string(__PRETTY_FUNCTION__) + " while assigning to b", error.empty() ? std::string("Reached EOF") : error, SDL_TellIO(ffFile));
-            }
-            if (!SDL_SetPaletteColors(this->altPalettes.at(i), new SDL_Color(r, g, b, 0xFFU), j, 1)) {
-                throw DataException<short>(std::string(__PRETTY_FUNCTION__) + " while setting palette colors", std::string(SDL_GetError()), j);
-            }
+        this->altPalettes.push_back(palette);
+        if (!SDL_SetPaletteColors(palette, colors.data(), 0, static_cast<int>(colors.size()))) {
+            throw DataException<short>(std::string(__PRETTY_FUNCTION__) + " while setting palette colors", std::string(SDL_GetError()), static_cast<short>(this->altPalettes.size() - 1UZ));
         }
     }
     this->basePalette = SDL_CreatePalette(this->altPalettes.at(0)->ncolors);
@@ -562,125 +52,63 @@ GET_SPRITES(Debuggy)
                                                  this->altPalettes.at(0)->colors[i].b,
                                                  this->altPalettes.at(0)->colors[i].a);
     }
-    if (paletteIndex != 0x0000U) {
-        unsigned int* pixels = static_cast<unsigned int*>(this->spriteSheet->pixels);
-        int pixelCount = this->spriteSheet->w * this->spriteSheet->h;
-        unsigned int color, baseColor;
-        for (int i = 0; i < this->altPalettes.at(paletteIndex)->ncolors; ++i) {
-            baseColor = (this->basePalette->colors[i].a << 24)
-                  | (this->basePalette->colors[i].b << 16)
-                  | (this->basePalette->colors[i].g << 8)
-                  | this->basePalette->colors[i].r;
-            color = (this->altPalettes.at(paletteIndex)->colors[i].a << 24)
-                  | (this->altPalettes.at(paletteIndex)->colors[i].b << 16)
-                  | (this->altPalettes.at(paletteIndex)->colors[i].g << 8)
-                  | this->altPalettes.at(paletteIndex)->colors[i].r;
-            for (int j = 0; j < pixelCount; ++j) {
-                if (pixels[j] == baseColor) {
-                    pixels[j] = color;
-                }
-            }
-        }
-    }
-    int sizeBits;
-    if (SDL_ReadS32BE(ffFile, &sizeBits)) {
-        this->size = reinterpret_cast<float&>(sizeBits);
-    } else {
-        const std::string error(SDL_GetError());
-        throw DataException<long>(std::string(__PRETTY_FUNCTION__) + " while assigning to sizeBits", error.empty() ? std::string("Reached EOF") : error, SDL_TellIO(ffFile));
-    }
-    int walkForwardSpeedBits;
-    if (SDL_ReadS32BE(ffFile, &walkForwardSpeedBits)) {
-        this->walkForwardSpeed = reinterpret_cast<float&>(walkForwardSpeedBits);
-    } else {
-        const std::string error(SDL_GetError());
-        throw DataException<long>(std::string(__PRETTY_FUNCTION__) + " while assigning to walkForwardSpeedBits", error.empty() ? std::string("Reached EOF") : error, SDL_TellIO(ffFile));
-    }
-    int walkBackwardSpeedBits;
-    if (SDL_ReadS32BE(ffFile, &walkBackwardSpeedBits)) {
-        this->walkBackwardSpeed = reinterpret_cast<float&>(walkBackwardSpeedBits);
-    } else {
-        const std::string error(SDL_GetError());
-        throw DataException<long>(std::string(__PRETTY_FUNCTION__) + " while assigning to walkBackwardSpeedBits", error.empty() ? std::string("Reached EOF") : error, SDL_TellIO(ffFile));
-    }
-    int jumpForwardXVelocityBits;
-    if (SDL_ReadS32BE(ffFile, &jumpForwardXVelocityBits)) {
-        this->jumpForwardXVelocity = reinterpret_cast<float&>(jumpForwardXVelocityBits);
-    } else {
-        const std::string error(SDL_GetError());
-        throw DataException<long>(std::string(__PRETTY_FUNCTION__) + " while assigning to jumpForwardXVelocityBits", error.empty() ? std::string("Reached EOF") : error, SDL_TellIO(ffFile));
-    }
-    int jumpBackwardXVelocityBits;
-    if (SDL_ReadS32BE(ffFile, &jumpBackwardXVelocityBits)) {
-        this->jumpBackwardXVelocity = reinterpret_cast<float&>(jumpBackwardXVelocityBits);
-    } else {
-        const std::string error(SDL_GetError());
-        throw DataException<long>(std::string(__PRETTY_FUNCTION__) + " while assigning to jumpBackwardXVelocityBits", error.empty() ? std::string("Reached EOF") : error, SDL_TellIO(ffFile));
-    }
-    int initialJumpVelocityBits;
-    if (SDL_ReadS32BE(ffFile, &initialJumpVelocityBits)) {
-        this->initialJumpVelocity = reinterpret_cast<float&>(initialJumpVelocityBits);
-    } else {
-        const std::string error(SDL_GetError());
-        throw DataException<long>(std::string(__PRETTY_FUNCTION__) + " while assigning to initialJumpVelocityBits", error.empty() ? std::string("Reached EOF") : error, SDL_TellIO(ffFile));
-    }
-    int gravityBits;
-    if (SDL_ReadS32BE(ffFile, &gravityBits)) {
-        this->gravity = reinterpret_cast<float&>(gravityBits);
-    } else {
-        const std::string error(SDL_GetError());
-        throw DataException<long>(std::string(__PRETTY_FUNCTION__) + " while assigning to gravityBits", error.empty() ? std::string("Reached EOF") : error, SDL_TellIO(ffFile));
-    }
-    unsigned short animationIndex;
-    unsigned short numberOfFrames;
-    while (SDL_GetIOStatus(ffFile) != SDL_IO_STATUS_EOF) {
-        if (!SDL_ReadU16BE(ffFile, &animationIndex)) { // reached EOF if function returns false
-            break;
-        }
-        if (!SDL_ReadU16BE(ffFile, &numberOfFrames)) {
-            const std::string error(SDL_GetError());
-            throw DataException<long>(std::string(__PRETTY_FUNCTION__) + " while assigning to numberOfFrames", error.empty() ? std::string("Reached EOF") : error, SDL_TellIO(ffFile));
-        }
-        for (unsigned short i = 0x0000U; i < numberOfFrames; ++i) {
-            try {
-                this->animations[static_cast<AnimationType>(animationIndex)].emplace_back(
-                    ffFile, renderer, this->spriteSheet);
-            } catch (const CopyInformation& e) {
-                this->animations[static_cast<AnimationType>(animationIndex)].emplace_back(
-                    this->animations[e.animationType].at(e.index), ffFile, renderer,
-                    this->spriteSheet, e);
-            }
-        }
-    }
-    this->coordinates = new SDL_FRect(400.0f,
-        Character::ground->y - this->animations.at(IDLE).at(0).getSpriteSheetArea()->h * this->size,
-        this->animations.at(IDLE).at(0).getSpriteSheetArea()->w * this->size,
-        this->animations.at(IDLE).at(0).getSpriteSheetArea()->h * this->size);
-    this->renderCoordinates = new SDL_FRect(400.0f,
-        Character::ground->y - this->animations.at(IDLE).at(0).getSpriteSheetArea()->h * this->size,
-        this->animations.at(IDLE).at(0).getSpriteSheetArea()->w * this->size,
-        this->animations.at(IDLE).at(0).getSpriteSheetArea()->h * this->size);
-    for (std::vector<Sprite>& allSprites : this->animations | std::views::values) {
-        for (Sprite& spriteItem : allSprites) {
-            for (CharacterBox& boxItem : spriteItem.charBoxes) {
-                multiplySizeRect(boxItem.rect, this->size);
-                changeLocationRect(boxItem.rect, 400.0f, Character::ground->y - boxItem.rect->h);
-            }
-        }
+    const SDL_FRect* idleArea = this->animations.at(IDLE, 0).getSpriteSheetArea();
+    this->coordinates = ScalarRect(Scalar(400),
+        this->ground.y - Scalar(idleArea->h) * this->size,
+        Scalar(idleArea->w) * this->size,
+        Scalar(idleArea->h) * this->size);
+    size_t mostBoxes = 0UZ;
+    for (const Sprite& spriteItem : this->animations.allFrames()) {
+        mostBoxes = std::max(mostBoxes, spriteItem.charBoxes.size());
     }
+    this->activeBoxes.reserve(mostBoxes);
 }
 
 Character::~Character() {
-    for (std::vector<Sprite>& sprites : this->animations | std::views::values) {
-        for (const Sprite& spriteItem : sprites) {
-            spriteItem.destroyTexture();
-        }
-    }
     SDL_DestroyPalette(this->basePalette);
     for (SDL_Palette* palette : this->altPalettes) {
         SDL_DestroyPalette(palette);
     }
-    SDL_DestroySurface(this->spriteSheet);
+}
+
+void Character::move(const Scalar dx, const Scalar dy) {
+    moveRect(this->coordinates, dx, dy);
+    this->activeBoxesValid = false;
+}
+
+void Character::loadAnimation(const AnimationType type) {
+    if (this->deferred == nullptr || this->animations.contains(type)) {
+        return;
+    }
+    this->animations.add(type, this->deferred->read(type));
+}
+
+const std::vector<ActiveBox>& Character::getActiveBoxes() {
+    if (this->activeBoxesValid
+        && this->activeBoxesAnimation == this->currentAnimation
+        && this->activeBoxesFrame == this->frame) {
+        return this->activeBoxes;
+    }
+    this->activeBoxes.clear();
+    for (const CharacterBox& boxItem : this->animations.at(this->currentAnimation, this->frame).charBoxes) {
+        this->activeBoxes.emplace_back(&boxItem, ScalarRect(this->coordinates.x + boxItem.rect.x,
+                                                           this->coordinates.y + boxItem.rect.y,
+                                                           boxItem.rect.w,
+                                                           boxItem.rect.h));
+    }
+    this->activeBoxesValid = true;
+    this->activeBoxesAnimation = this->currentAnimation;
+    this->activeBoxesFrame = this->frame;
+    return this->activeBoxes;
+}
+
+uint64_t Character::checksumBoxes(const CharacterState& state, uint64_t hash) const {
+    // Placed the same way as in getActiveBoxes, so that the checksum matches the boxes once the state is loaded.
+    for (const CharacterBox& boxItem : this->animations.at(state.currentAnimation, state.frame).charBoxes) {
+        const ScalarRect rect(state.coordinates.x + boxItem.rect.x, state.coordinates.y + boxItem.rect.y, boxItem.rect.w, boxItem.rect.h);
+        hash = checksum64(std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(&rect), sizeof(ScalarRect)), hash ^ boxItem.boxType);
+    }
+    return hash;
 }
 
 AnimationType Character::processAttacks() {
@@ -726,8 +154,8 @@ AnimationType Character::processInputs() {
         }
     }
     if (this->currentAnimation == this->currentAttack) {
-        if (this->spriteIndex >= this->animations.at(this->currentAnimation).at(this->frame).getLength() - 1
-            && this->frame >= this->animations.at(this->currentAnimation).size() - 1) {
+        if (this->spriteIndex >= this->animations.at(this->currentAnimation, this->frame).getLength() - 1
+            && this->frame >= this->animations.size(this->currentAnimation) - 1) {
             this->currentAttack = NOTHING;
         } else {
             return this->currentAttack;
@@ -740,66 +168,40 @@ AnimationType Character::processInputs() {
             && this->currentAnimation != JUMP_BACKWARD) {
             return PRE_JUMP;
         }
-        if (this->currentAnimation == PRE_JUMP && this->spriteIndex < this->animations.at(this->currentAnimation).at(this->frame).getLength()) {
+        if (this->currentAnimation == PRE_JUMP && this->spriteIndex < this->animations.at(this->currentAnimation, this->frame).getLength()) {
             return PRE_JUMP;
         }
         AnimationType arc = JUMP_NEUTRAL;
         switch (this->jumpArc) {
             case UP_BACK:
-                moveRect(this->coordinates, this->jumpBackwardXVelocity, this->currentYVelocity);
-                for (std::vector<Sprite>& sprites : this->animations | std::views::values) {
-                    for (Sprite& spr : sprites) {
-                        for (CharacterBox& boxItem : spr.charBoxes) {
-                            moveRect(boxItem.rect, this->jumpBackwardXVelocity, this->currentYVelocity);
-                        }
-                    }
-                }
+                this->move(this->jumpBackwardXVelocity, this->currentYVelocity);
                 this->currentXVelocity = this->jumpBackwardXVelocity;
                 arc = JUMP_BACKWARD;
                 break;
             case UP_FORWARD:
-                moveRect(this->coordinates, this->jumpForwardXVelocity, this->currentYVelocity);
-                for (std::vector<Sprite>& sprites : this->animations | std::views::values) {
-                    for (Sprite& spr : sprites) {
-                        for (CharacterBox& boxItem : spr.charBoxes) {
-                            moveRect(boxItem.rect, this->jumpForwardXVelocity, this->currentYVelocity);
-                        }
-                    }
-                }
+                this->move(this->jumpForwardXVelocity, this->currentYVelocity);
                 this->currentXVelocity = this->jumpForwardXVelocity;
                 arc = JUMP_FORWARD;
                 break;
             case UP:
-                moveRect(this->coordinates, 0.0f, this->currentYVelocity);
-                for (std::vector<Sprite>& sprites : this->animations | std::views::values) {
-                    for (Sprite& spr : sprites) {
-                        for (CharacterBox& boxItem : spr.charBoxes) {
-                            moveRect(boxItem.rect, 0.0f, this->currentYVelocity);
-                        }
-                    }
-                }
-                this->currentXVelocity = 0.0f;
+                this->move(Scalar(0), this->currentYVelocity);
+                this->currentXVelocity = Scalar(0);
                 arc = JUMP_NEUTRAL;
                 break;
             default:
                 break;
         }
         this->currentYVelocity += this->gravity;
-        const auto it = std::ranges::find_if(this->animations.at(this->currentAnimation).at(this->frame).charBoxes,
-                                       [](const auto& box) {
-                                           return box.boxType == THROW_PUSH_GROUND_COLLISION;
+        const std::vector<ActiveBox>& boxes = this->getActiveBoxes();
+        const auto it = std::ranges::find_if(boxes,
+                                       [](const ActiveBox& active) {
+                                           return active.box->boxType == THROW_PUSH_GROUND_COLLISION;
                                        });
-        if (it != (this->animations.at(this->currentAnimation).at(this->frame).charBoxes).end()) {
-            if (SDL_HasRectIntersectionFloat(it->rect, Character::ground)) {
-                this->currentXVelocity = 0.0f;
-                this->currentYVelocity = 0.0f;
-                for (std::vector<Sprite>& sprites : this->animations | std::views::values) {
-                    for (Sprite& spr : sprites) {
-                        for (CharacterBox& boxItem : spr.charBoxes) {
-                            changeLocationRect(boxItem.rect, boxItem.rect->x, Character::ground->y - boxItem.rect->h);
-                        }
-                    }
-                }
+        if (it != boxes.end()) {
+            if (hasIntersection(it->rect, this->ground)) {
+                this->currentXVelocity = Scalar(0);
+                this->currentYVelocity = Scalar(0);
+                this->move(Scalar(0), this->ground.y - (it->rect.y + it->rect.h));
                 this->midair = false;
             }
         }
@@ -809,7 +211,7 @@ AnimationType Character::processInputs() {
             case DOWN_BACK:
             case DOWN:
             case DOWN_FORWARD:
-                if ((this->currentAnimation == CROUCH_TRANSITION || this->currentAnimation == CROUCH) && this->spriteIndex == this->animations.at(this->currentAnimation).at(this->frame).getLength()) {
+                if ((this->currentAnimation == CROUCH_TRANSITION || this->currentAnimation == CROUCH) && this->spriteIndex == this->animations.at(this->currentAnimation, this->frame).getLength()) {
                     return CROUCH;
                 } else {
                     return CROUCH_TRANSITION;
@@ -818,52 +220,38 @@ AnimationType Character::processInputs() {
                 if (this->currentAnimation == CROUCH) {
                     return CROUCH_TRANSITION;
                 } else if (this->currentAnimation == CROUCH_TRANSITION) {
-                    if (this->spriteIndex == this->animations.at(this->currentAnimation).at(this->frame).getLength()) {
+                    if (this->spriteIndex == this->animations.at(this->currentAnimation, this->frame).getLength()) {
                         return WALK_BACKWARD;
                     } else {
                         return CROUCH_TRANSITION;
                     }
                 }
-                moveRect(this->coordinates, this->walkBackwardSpeed, 0.0f);
-                for (std::vector<Sprite>& sprites : this->animations | std::views::values) {
-                    for (Sprite& spr : sprites) {
-                        for (CharacterBox& boxItem : spr.charBoxes) {
-                            moveRect(boxItem.rect, this->walkBackwardSpeed, 0.0f);
-                        }
-                    }
-                }
+                this->move(this->walkBackwardSpeed, Scalar(0));
                 this->currentXVelocity = this->walkBackwardSpeed;
                 return WALK_BACKWARD;
             case NEUTRAL:
                 if (this->currentAnimation == CROUCH) {
                     return CROUCH_TRANSITION;
                 } else if (this->currentAnimation == CROUCH_TRANSITION) {
-                    if (this->spriteIndex == this->animations.at(this->currentAnimation).at(this->frame).getLength()) {
+                    if (this->spriteIndex == this->animations.at(this->currentAnimation, this->frame).getLength()) {
                         return IDLE;
                     } else {
                         return CROUCH_TRANSITION;
                     }
                 }
-                this->currentXVelocity = 0.0f;
+                this->currentXVelocity = Scalar(0);
                 return IDLE;
             case FORWARD:
                 if (this->currentAnimation == CROUCH) {
                     return CROUCH_TRANSITION;
                 } else if (this->currentAnimation == CROUCH_TRANSITION) {
-                    if (this->spriteIndex == this->animations.at(this->currentAnimation).at(this->frame).getLength()) {
+                    if (this->spriteIndex == this->animations.at(this->currentAnimation, this->frame).getLength()) {
                         return WALK_BACKWARD;
                     } else {
                         return CROUCH_TRANSITION;
                     }
                 }
-                moveRect(this->coordinates, this->walkForwardSpeed, 0.0f);
-                for (std::vector<Sprite>& spriteVector : this->animations | std::views::values) {
-                    for (Sprite& spr : spriteVector) {
-                        for (CharacterBox& boxItem : spr.charBoxes) {
-                            moveRect(boxItem.rect, this->walkForwardSpeed, 0.0f);
-                        }
-                    }
-                }
+                this->move(this->walkForwardSpeed, Scalar(0));
                 this->currentXVelocity = this->walkForwardSpeed;
                 return WALK_FORWARD;
             case UP_BACK:
@@ -879,37 +267,100 @@ AnimationType Character::processInputs() {
 }
 
 
-void Character::render(SDL_Renderer*& renderer) {
-    SDL_SetRenderDrawColor(renderer, 0x80U, 0x80U, 0x80U, 0xFFU);
-    SDL_RenderFillRect(renderer, Character::ground);
+void Character::update() {
+    const Direction direction = this->controller->inputToDirection();
+    this->inputs.addEntry(InputHistoryEntry(direction, this->controller->getButton()));
+    // Before the attacks are processed, since they consume the buttons.
+    this->motions.update(direction, this->controller->getButton());
     this->currentAnimation = this->processInputs();
     if (this->previousAnimation != this->currentAnimation) {
+        this->loadAnimation(this->currentAnimation);
         this->frame = 0UZ;
         this->spriteIndex = 0U;
         this->previousAction = this->previousAnimation;
     }
-    if (this->spriteIndex >= this->animations.at(this->currentAnimation).at(this->frame).getLength()) {
+    if (this->spriteIndex >= this->animations.at(this->currentAnimation, this->frame).getLength()) {
         ++this->frame;
         this->spriteIndex = 0U;
     }
-    if (this->frame >= this->animations.at(this->currentAnimation).size()) {
+    if (this->frame >= this->animations.size(this->currentAnimation)) {
         this->frame = 0UZ;
     }
+    const Sprite& currentSprite = this->animations.at(this->currentAnimation, this->frame);
     changeDimensionsRect(this->coordinates,
-        this->animations.at(this->currentAnimation).at(this->frame).getSpriteSheetArea()->w * this->size,
-        this->animations.at(this->currentAnimation).at(this->frame).getSpriteSheetArea()->h * this->size);
-
-    for (size_t i = 0UZ; i < this->animations.at(this->currentAnimation).at(this->frame).charBoxes.size(); ++i) {
-        changeLocationRect(
-            this->animations.at(this->currentAnimation).at(this->frame).charBoxes.at(i).rect,
-            this->coordinates->x + this->animations.at(this->currentAnimation).at(this->frame).charBoxesWithAbsoluteLocation.at(i).rect->x * this->size,
-            this->coordinates->y + this->animations.at(this->currentAnimation).at(this->frame).charBoxesWithAbsoluteLocation.at(i).rect->y * this->size);
-    }
-    this->renderCoordinates->x = this->coordinates->x + this->animations.at(this->currentAnimation).at(this->frame).xOffset;
-    this->renderCoordinates->y = this->coordinates->y + this->animations.at(this->currentAnimation).at(this->frame).yOffset;
-    this->renderCoordinates->w = this->coordinates->w;
-    this->renderCoordinates->h = this->coordinates->h;
-    this->animations.at(this->currentAnimation).at(this->frame).render(renderer, this->renderCoordinates);
+        Scalar(currentSprite.getSpriteSheetArea()->w) * this->size,
+        Scalar(currentSprite.getSpriteSheetArea()->h) * this->size);
     this->previousAnimation = this->currentAnimation;
     ++this->spriteIndex;
-}
\ No newline at end of file
+}
+
+void Character::saveState(CharacterState& state) const {
+    state.coordinates = this->coordinates;
+    state.currentXVelocity = this->currentXVelocity;
+    state.currentYVelocity = this->currentYVelocity;
+    state.frame = static_cast<uint32_t>(this->frame);
+    state.currentHealth = this->currentHealth;
+    state.currentAnimation = this->currentAnimation;
+    state.previousAnimation = this->previousAnimation;
+    state.previousAction = this->previousAction;
+    state.currentAttack = this->currentAttack;
+    state.spriteIndex = this->spriteIndex;
+    state.midair = this->midair ? 1U : 0U;
+    state.jumpArc = static_cast<uint8_t>(this->jumpArc);
+    this->inputs.saveState(state.inputs);
+    this->motions.saveState(state.motions);
+}
+
+void Character::loadState(const CharacterState& state) {
+    this->coordinates = state.coordinates;
+    this->currentXVelocity = state.currentXVelocity;
+    this->currentYVelocity = state.currentYVelocity;
+    this->frame = state.frame;
+    this->currentHealth = state.currentHealth;
+    this->currentAnimation = static_cast<AnimationType>(state.currentAnimation);
+    this->loadAnimation(this->currentAnimation);
+    this->previousAnimation = static_cast<AnimationType>(state.previousAnimation);
+    this->previousAction = static_cast<AnimationType>(state.previousAction);
+    this->currentAttack = static_cast<AnimationType>(state.currentAttack);
+    this->spriteIndex = state.spriteIndex;
+    this->midair = state.midair != 0U;
+    this->jumpArc = static_cast<Direction>(state.jumpArc);
+    this->inputs.loadState(state.inputs);
+    this->motions.loadState(state.motions);
+    this->activeBoxesValid = false;
+}
+
+const Sprite& Character::getCurrentSprite() const {
+    return this->animations.at(this->currentAnimation, this->frame);
+}
+
+SDL_FRect Character::getCoordinates() const {
+    return this->coordinates.toFRect();
+}
+
+unsigned short Character::getCurrentHealth() const {
+    return this->currentHealth;
+}
+
+uint8_t Character::getLastInput() const {
+    return this->inputs.getLastInput();
+}
+
+const SDL_Palette* Character::getBasePalette() const {
+    return this->basePalette;
+}
+
+const std::vector<SDL_Palette*>& Character::getAltPalettes() const {
+    return this->altPalettes;
+}
+
+unsigned short Character::getPalette() const {
+    return this->palette;
+}
+
+void Character::setPalette(const unsigned short palette) {
+    if (palette >= this->altPalettes.size()) {
+        throw std::out_of_range(this->name + " has no palette " + std::to_string(palette));
+    }
+    this->palette = palette;
+}
@@ -0,0 +1,354 @@
+#include "character_container.hpp"
+
+#include "animation_table.hpp"
+#include "character_data.hpp"
+#include "packbits.hpp"
+#include "scalar.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <map>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <SDL3/SDL.h>
+
+/**
+ * Decodes a big-endian unsigned short.
+ * @param bytes The two bytes.
+ * @return The number.
+ */
+static uint16_t loadU16(const std::byte* bytes) {
+    return static_cast<uint16_t>((std::to_integer<uint16_t>(bytes[0]) << 8) | std::to_integer<uint16_t>(bytes[1]));
+}
+
+/**
+ * Decodes a big-endian unsigned int.
+ * @param bytes The four bytes.
+ * @return The number.
+ */
+static uint32_t loadU32(const std::byte* bytes) {
+    return (static_cast<uint32_t>(loadU16(bytes)) << 16) | loadU16(bytes + 2);
+}
+
+/**
+ * Appends a big-endian unsigned short.
+ * @param out The bytes to append to.
+ * @param value The number.
+ */
+static void storeU16(std::vector<std::byte>& out, const uint16_t value) {
+    out.push_back(static_cast<std::byte>(value >> 8));
+    out.push_back(static_cast<std::byte>(value & 0xFFU));
+}
+
+/**
+ * Appends a big-endian unsigned int.
+ * @param out The bytes to append to.
+ * @param value The number.
+ */
+static void storeU32(std::vector<std::byte>& out, const uint32_t value) {
+    storeU16(out, static_cast<uint16_t>(value >> 16));
+    storeU16(out, static_cast<uint16_t>(value & 0xFFFFU));
+}
+
+/**
+ * Overwrites a big-endian unsigned int that was appended earlier.
+ * @param out The bytes.
+ * @param offset Where the number is.
+ * @param value The number.
+ */
+static void patchU32(std::vector<std::byte>& out, const size_t offset, const uint32_t value) {
+    out[offset] = static_cast<std::byte>(value >> 24);
+    out[offset + 1UZ] = static_cast<std::byte>((value >> 16) & 0xFFU);
+    out[offset + 2UZ] = static_cast<std::byte>((value >> 8) & 0xFFU);
+    out[offset + 3UZ] = static_cast<std::byte>(value & 0xFFU);
+}
+
+/**
+ * Pads bytes with zeros up to the alignment of every section.
+ * @param out The bytes.
+ */
+static void alignSection(std::vector<std::byte>& out) {
+    out.resize((out.size() + characterSectionAlignment - 1UZ) & ~(characterSectionAlignment - 1UZ));
+}
+
+bool isRarelyUsedAnimation(const unsigned short type) {
+    return type == VICTORY
+        || type == DEFEAT
+        || type == CHARACTER_WIN_IMAGE
+        || type == CHARACTER_LOSS_IMAGE
+        || (type >= MISC_ASSETS_BEGIN && type <= MISC_ASSETS_END);
+}
+
+bool CharacterContainer::isContainer(const std::span<const std::byte> data) {
+    return data.size() >= 6UZ
+        && loadU16(data.data()) == characterDataHeader
+        && loadU16(data.data() + 2) == 0x0000U
+        && loadU16(data.data() + 4) == characterContainerVersion;
+}
+
+std::expected<CharacterContainer, CharacterDataError> CharacterContainer::open(const std::span<const std::byte> data) {
+    if (data.size() < characterContainerHeaderSize) {
+        return std::unexpected(CharacterDataError("reading header", "Reached EOF", data.size()));
+    }
+    if (!isContainer(data)) {
+        return std::unexpected(CharacterDataError("checking header", "Not a container", 0UZ));
+    }
+    const std::byte* header = data.data();
+    const uint16_t paletteCount = loadU16(header + 0x08);
+    const uint16_t colorCount = loadU16(header + 0x0A);
+    const uint32_t paletteOffset = loadU32(header + 0x0C);
+    const uint32_t animationCount = loadU32(header + 0x2C);
+    const uint32_t directoryOffset = loadU32(header + 0x30);
+    const uint32_t fileSize = loadU32(header + 0x34);
+    if (fileSize > data.size()) {
+        return std::unexpected(CharacterDataError("checking size", "Reached EOF", data.size()));
+    }
+    if (paletteCount == 0U || colorCount == 0U) {
+        return std::unexpected(CharacterDataError("checking palettes", "No colors", 0x08UZ));
+    }
+    const size_t paletteSize = static_cast<size_t>(paletteCount) * colorCount * 3UZ;
+    if (paletteOffset < characterContainerHeaderSize || paletteOffset > fileSize || paletteSize > fileSize - paletteOffset) {
+        return std::unexpected(CharacterDataError("checking palettes", "Section does not fit in the file", 0x0CUZ));
+    }
+    if (directoryOffset % characterSectionAlignment != 0U
+        || directoryOffset > fileSize
+        || animationCount > (fileSize - directoryOffset) / characterDirectoryEntrySize) {
+        return std::unexpected(CharacterDataError("checking directory", "Section does not fit in the file", 0x30UZ));
+    }
+    CharacterContainer container;
+    container.data = data.first(fileSize);
+    container.palettes.resize(paletteCount);
+    for (size_t i = 0UZ; i < paletteCount; ++i) {
+        container.palettes[i].reserve(colorCount);
+        for (size_t j = 0UZ; j < colorCount; ++j) {
+            const std::byte* color = header + paletteOffset + (i * colorCount + j) * 3UZ;
+            container.palettes[i].emplace_back(std::to_integer<uint8_t>(color[0]), std::to_integer<uint8_t>(color[1]), std::to_integer<uint8_t>(color[2]), 0xFFU);
+        }
+    }
+    float* stats[] = {
+        &container.stats.size, &container.stats.walkForwardSpeed, &container.stats.walkBackwardSpeed,
+        &container.stats.jumpForwardXVelocity, &container.stats.jumpBackwardXVelocity,
+        &container.stats.initialJumpVelocity, &container.stats.gravity
+    };
+    for (size_t i = 0UZ; i < std::size(stats); ++i) {
+        *stats[i] = std::bit_cast<float>(loadU32(header + 0x10 + i * 4UZ));
+    }
+    container.directory.reserve(animationCount);
+    for (size_t i = 0UZ; i < animationCount; ++i) {
+        const size_t position = directoryOffset + i * characterDirectoryEntrySize;
+        const std::byte* record = header + position;
+        const CharacterDirectoryEntry entry(loadU16(record), loadU16(record + 2), static_cast<SectionCompression>(record[4]), loadU32(record + 8), loadU32(record + 12));
+        if (!container.directory.empty() && entry.type <= container.directory.back().type) {
+            return std::unexpected(CharacterDataError("checking directory", "Animations are not sorted by type", position));
+        }
+        if (entry.compression != UNCOMPRESSED && entry.compression != PACK_BITS) {
+            return std::unexpected(CharacterDataError("checking directory", "Unknown compression", position + 4UZ));
+        }
+        if (entry.offset % characterSectionAlignment != 0U || entry.offset > fileSize || entry.length > fileSize - entry.offset) {
+            return std::unexpected(CharacterDataError("checking directory", "Section does not fit in the file", position + 8UZ));
+        }
+        container.directory.push_back(entry);
+    }
+    return container;
+}
+
+const CharacterStats& CharacterContainer::getStats() const {
+    return this->stats;
+}
+
+const std::vector<std::vector<SDL_Color>>& CharacterContainer::getPalettes() const {
+    return this->palettes;
+}
+
+std::span<const CharacterDirectoryEntry> CharacterContainer::getDirectory() const {
+    return this->directory;
+}
+
+std::expected<std::vector<Sprite>, CharacterDataError> CharacterContainer::decode(const CharacterDirectoryEntry& entry, const Scalar size) const {
+    const std::span<const std::byte> section = this->data.subspan(entry.offset, entry.length);
+    if (entry.compression == UNCOMPRESSED) {
+        return parseAnimationSection(section, entry.type, entry.frameCount, size);
+    }
+    std::vector<std::byte> unpacked;
+    unpacked.reserve(section.size() * 2UZ);
+    if (!unpackBits(section, unpacked)) {
+        return std::unexpected(CharacterDataError("decompressing section", "Reached EOF", entry.offset + entry.length));
+    }
+    return parseAnimationSection(unpacked, entry.type, entry.frameCount, size);
+}
+
+std::expected<std::span<const Sprite>, CharacterDataError> CharacterContainer::getAnimation(const unsigned short type) {
+    if (const auto it = this->decoded.find(type); it != this->decoded.end()) {
+        return std::span<const Sprite>(it->second);
+    }
+    const auto entry = std::ranges::lower_bound(this->directory, type, {}, &CharacterDirectoryEntry::type);
+    if (entry == this->directory.end() || entry->type != type) {
+        return std::span<const Sprite>();
+    }
+    std::expected<std::vector<Sprite>, CharacterDataError> frames = this->decode(*entry, Scalar(this->stats.size));
+    if (!frames) {
+        return std::unexpected(frames.error());
+    }
+    return std::span<const Sprite>(this->decoded.emplace(type, std::move(*frames)).first->second);
+}
+
+std::expected<CharacterData, CharacterDataError> CharacterContainer::readCharacterData(const bool includeRarelyUsed, const bool scaleBoxes) const {
+    CharacterData data;
+    data.palettes = this->palettes;
+    data.stats = this->stats;
+    const Scalar size = scaleBoxes ? Scalar(this->stats.size) : Scalar(1);
+    std::map<unsigned short, std::vector<Sprite>> animations;
+    for (const CharacterDirectoryEntry& entry : this->directory) {
+        if (!includeRarelyUsed && isRarelyUsedAnimation(entry.type)) {
+            continue;
+        }
+        std::expected<std::vector<Sprite>, CharacterDataError> frames = this->decode(entry, size);
+        if (!frames) {
+            return std::unexpected(frames.error());
+        }
+        animations.emplace(entry.type, std::move(*frames));
+    }
+    data.animations = AnimationTable<Sprite>(std::move(animations));
+    return data;
+}
+
+/**
+ * Converts a coordinate of a box that was not scaled back into the number stored in a *.ff file.
+ * @param value The coordinate.
+ * @param result The number.
+ * @return Whether the coordinate is a whole number that fits.
+ */
+static bool storeCoordinate(const Scalar value, int16_t& result) {
+    const float number = toFloat(value);
+    if (number != std::trunc(number) || number < static_cast<float>(INT16_MIN) || number > static_cast<float>(INT16_MAX)) {
+        return false;
+    }
+    result = static_cast<int16_t>(number);
+    return true;
+}
+
+/**
+ * Writes the sprites of an animation the same way as a sequential *.ff file, without any copies.
+ * @param frames The sprites.
+ * @param out The bytes to append to.
+ * @return Nothing, or why the sprites cannot be stored.
+ */
+static std::expected<void, CharacterDataError> writeAnimation(const std::span<const Sprite> frames, std::vector<std::byte>& out) {
+    for (const Sprite& sprite : frames) {
+        if (sprite.getLength() >= 0xFF00U) {
+            return std::unexpected(CharacterDataError("writing sprite", "Sprite is too long to be told apart from a copy", sprite.getLength()));
+        }
+        storeU16(out, sprite.getLength());
+        const SDL_FRect* area = sprite.getSpriteSheetArea();
+        for (const float coordinate : {area->x, area->y, area->w, area->h}) {
+            storeU16(out, static_cast<uint16_t>(coordinate));
+        }
+        storeU16(out, static_cast<uint16_t>(sprite.xOffset));
+        storeU16(out, static_cast<uint16_t>(sprite.yOffset));
+        // Boxes of the same type next to each other share a group, as long as its count fits.
+        for (size_t first = 0UZ; first < sprite.charBoxes.size();) {
+            const BoxType type = sprite.charBoxes[first].boxType;
+            size_t last = first + 1UZ;
+            while (last < sprite.charBoxes.size() && sprite.charBoxes[last].boxType == type && last - first < UINT16_MAX) {
+                ++last;
+            }
+            storeU16(out, type);
+            storeU16(out, static_cast<uint16_t>(last - first));
+            for (const CharacterBox& box : std::span(sprite.charBoxes).subspan(first, last - first)) {
+                int16_t rect[4];
+                if (!storeCoordinate(box.rect.x, rect[0]) || !storeCoordinate(box.rect.y, rect[1])
+                    || !storeCoordinate(box.rect.w, rect[2]) || !storeCoordinate(box.rect.h, rect[3])) {
+                    return std::unexpected(CharacterDataError("writing box", "Box is not in whole pixels, so it was scaled", out.size()));
+                }
+                for (const int16_t coordinate : rect) {
+                    storeU16(out, static_cast<uint16_t>(coordinate));
+                }
+                if (type >= HITBOX_BEGIN && type <= HITBOX_END) {
+                    const HitboxProperties& properties = box.hitboxProperties;
+                    const bool knocksDown = properties.knockback == KNOCKS_DOWN;
+                    storeU16(out, knocksDown ? properties.xKnockback : properties.hitStun);
+                    storeU16(out, properties.blockStun);
+                    storeU16(out, static_cast<uint16_t>(knocksDown ? properties.yKnockback : properties.hitPushback));
+                    storeU16(out, static_cast<uint16_t>(properties.blockPushback));
+                }
+            }
+            first = last;
+        }
+        storeU16(out, NULL_TERMINATOR);
+    }
+    return {};
+}
+
+std::expected<std::vector<std::byte>, CharacterDataError> writeCharacterContainer(const CharacterData& data, const bool compress) {
+    if (data.palettes.empty() || data.palettes.front().empty() || data.palettes.size() > UINT16_MAX || data.palettes.front().size() > UINT16_MAX) {
+        return std::unexpected(CharacterDataError("writing palettes", "No colors, or too many", data.palettes.size()));
+    }
+    const std::vector<unsigned short> types = data.animations.types();
+    std::vector<std::byte> out(characterContainerHeaderSize);
+    const size_t paletteOffset = out.size();
+    for (const std::vector<SDL_Color>& palette : data.palettes) {
+        if (palette.size() != data.palettes.front().size()) {
+            return std::unexpected(CharacterDataError("writing palettes", "Palette has a different number of colors than the base palette", out.size()));
+        }
+        for (const SDL_Color& color : palette) {
+            out.push_back(static_cast<std::byte>(color.r));
+            out.push_back(static_cast<std::byte>(color.g));
+            out.push_back(static_cast<std::byte>(color.b));
+        }
+    }
+    alignSection(out);
+    const size_t directoryOffset = out.size();
+    out.resize(directoryOffset + types.size() * characterDirectoryEntrySize);
+    std::vector<std::byte> section;
+    for (size_t i = 0UZ; i < types.size(); ++i) {
+        section.clear();
+        const std::span<const Sprite> frames = data.animations.at(types[i]);
+        if (std::expected<void, CharacterDataError> written = writeAnimation(frames, section); !written) {
+            return std::unexpected(written.error());
+        }
+        SectionCompression compression = UNCOMPRESSED;
+        if (compress) {
+            std::vector<std::byte> packed = packBits(std::span<const std::byte>(section));
+            if (packed.size() < section.size()) {
+                section = std::move(packed);
+                compression = PACK_BITS;
+            }
+        }
+        alignSection(out);
+        const size_t entry = directoryOffset + i * characterDirectoryEntrySize;
+        std::vector<std::byte> record;
+        storeU16(record, types[i]);
+        storeU16(record, static_cast<uint16_t>(frames.size()));
+        record.push_back(static_cast<std::byte>(compression));
+        record.resize(8UZ);
+        storeU32(record, static_cast<uint32_t>(out.size()));
+        storeU32(record, static_cast<uint32_t>(section.size()));
+        std::ranges::copy(record, out.begin() + static_cast<std::ptrdiff_t>(entry));
+        out.insert(out.end(), section.begin(), section.end());
+    }
+    std::vector<std::byte> header;
+    storeU16(header, characterDataHeader);
+    storeU16(header, 0x0000U);
+    storeU16(header, characterContainerVersion);
+    storeU16(header, 0x0000U);
+    storeU16(header, static_cast<uint16_t>(data.palettes.size()));
+    storeU16(header, static_cast<uint16_t>(data.palettes.front().size()));
+    storeU32(header, static_cast<uint32_t>(paletteOffset));
+    for (const float stat : {data.stats.size, data.stats.walkForwardSpeed, data.stats.walkBackwardSpeed,
+                             data.stats.jumpForwardXVelocity, data.stats.jumpBackwardXVelocity,
+                             data.stats.initialJumpVelocity, data.stats.gravity}) {
+        storeU32(header, std::bit_cast<uint32_t>(stat));
+    }
+    storeU32(header, static_cast<uint32_t>(types.size()));
+    storeU32(header, static_cast<uint32_t>(directoryOffset));
+    storeU32(header, 0U);
+    std::ranges::copy(header, out.begin());
+    patchU32(out, 0x34UZ, static_cast<uint32_t>(out.size()));
+    return out;
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "character_data.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <map>
+#include <span>
+#include <vector>
+
+#include <SDL3/SDL.h>
+
+/**
+ * The version of the container layout of *.ff files, stored after the @c 00 00 palette count that no sequential *.ff
+ * file can have.
+ */
+constexpr uint16_t characterContainerVersion = 2U;
+
+/**
+ * The size of the header of a *.ff container.
+ */
+constexpr size_t characterContainerHeaderSize = 64UZ;
+
+/**
+ * The size of each entry of the animation directory of a *.ff container.
+ */
+constexpr size_t characterDirectoryEntrySize = 16UZ;
+
+/**
+ * The alignment of the directory and of every section of a *.ff container, from the start of the file.
+ */
+constexpr size_t characterSectionAlignment = 16UZ;
+
+/**
+ * How a section of a *.ff container is stored.
+ */
+enum SectionCompression : uint8_t {
+    UNCOMPRESSED = 0x00U, /**< Stored as it is. */
+    PACK_BITS = 0x01U /**< Compressed with @c packBits . */
+};
+
+/**
+ * Where an animation is stored in a *.ff container.
+ */
+struct CharacterDirectoryEntry {
+    uint16_t type; /**< The @c AnimationType . */
+    uint16_t frameCount; /**< How many sprites the animation has. */
+    SectionCompression compression; /**< How the section is stored. */
+    uint32_t offset; /**< Where the section starts, from the start of the file. */
+    uint32_t length; /**< How many bytes the section takes in the file. */
+};
+
+/**
+ * Checks whether an animation is only needed outside of the fighting itself, such as after a round or for menus, so
+ * that it can be decoded when it is first used instead of when the character is loaded.
+ * @param type The @c AnimationType .
+ * @return Whether the animation is rarely used.
+ */
+bool isRarelyUsedAnimation(unsigned short type);
+
+/**
+ * A *.ff file in the container layout (version 2), read in place. The header and the animation directory are checked
+ * when it is opened, and each animation is only decoded when it is asked for, so reaching any animation takes one
+ * directory lookup instead of parsing everything before it. Not safe to use from several threads at once.
+ */
+class CharacterContainer {
+private:
+    std::span<const std::byte> data; /**< The whole file, which must outlive the container. */
+    std::vector<std::vector<SDL_Color>> palettes; /**< The color schemes of the character, starting with the base palette. */
+    CharacterStats stats; /**< The stats of the character. */
+    std::vector<CharacterDirectoryEntry> directory; /**< Where each animation is, sorted by type. */
+    std::map<unsigned short, std::vector<Sprite>> decoded; /**< The animations decoded by @c CharacterContainer::getAnimation so far. */
+    /**
+     * Constructs an empty container, to be filled by @c CharacterContainer::open .
+     */
+    CharacterContainer() = default;
+    /**
+     * Decodes one animation.
+     * @param entry Where the animation is.
+     * @param size How much to scale the boxes.
+     * @return The sprites, or why they could not be read.
+     */
+    std::expected<std::vector<Sprite>, CharacterDataError> decode(const CharacterDirectoryEntry& entry, Scalar size) const;
+public:
+    /**
+     * Checks whether a *.ff file is in the container layout rather than the sequential one.
+     * @param data The whole file.
+     * @return Whether the file starts with <c>F0 55 00 00 00 02</c>.
+     */
+    static bool isContainer(std::span<const std::byte> data);
+    /**
+     * Checks the header and the directory of a *.ff container.
+     * @param data The whole file, which must outlive the container.
+     * @return The container, or why it could not be read.
+     */
+    static std::expected<CharacterContainer, CharacterDataError> open(std::span<const std::byte> data);
+    /**
+     * Gets the stats.
+     * @return The stats of the character.
+     */
+    const CharacterStats& getStats() const;
+    /**
+     * Gets the palettes.
+     * @return The color schemes of the character, starting with the base palette.
+     */
+    const std::vector<std::vector<SDL_Color>>& getPalettes() const;
+    /**
+     * Gets the directory.
+     * @return Where each animation is, sorted by type.
+     */
+    std::span<const CharacterDirectoryEntry> getDirectory() const;
+    /**
+     * Gets an animation, decoding it the first time it is asked for, with its boxes scaled to the character's size.
+     * @param type The @c AnimationType .
+     * @return The sprites, empty if there is no such animation, or why they could not be read.
+     */
+    std::expected<std::span<const Sprite>, CharacterDataError> getAnimation(unsigned short type);
+    /**
+     * Decodes the animations of the character.
+     * @param includeRarelyUsed Whether to decode the animations for which @c isRarelyUsedAnimation is @c true .
+     * @param scaleBoxes Whether to scale the boxes, which only tools that write *.ff files turn off.
+     * @return The character's data, or why it could not be read.
+     */
+    std::expected<CharacterData, CharacterDataError> readCharacterData(bool includeRarelyUsed, bool scaleBoxes = true) const;
+};
+
+/**
+ * Writes a character in the container layout, with every copied sprite already resolved.
+ * @param data The character's data, as parsed by @c parseCharacterData without scaling its boxes.
+ * @param compress Whether to compress each section with @c packBits where it makes the section smaller.
+ * @return The *.ff file, or why the data cannot be stored in one.
+ */
+std::expected<std::vector<std::byte>, CharacterDataError> writeCharacterContainer(const CharacterData& data, bool compress);
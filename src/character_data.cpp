@@ -0,0 +1,414 @@
+#include "character_data.hpp"
+
+#include "animation_table.hpp"
+#include "character_container.hpp"
+#include "data_exception.hpp"
+#include "frect_helpers.hpp"
+#include "scalar.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <map>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <SDL3/SDL.h>
+
+CharacterBox::CharacterBox(const BoxType currentBoxType, const HitboxProperties hitboxProperties, const ScalarRect rect)
+    : boxType(currentBoxType),
+    hitboxProperties{hitboxProperties},
+    rect{rect} {}
+
+Sprite::Sprite(const unsigned short length,
+    const SDL_FRect spriteSheetArea,
+    const signed short xOffset,
+    const signed short yOffset,
+    std::vector<CharacterBox>&& charBoxes)
+    : length{length},
+    spriteSheetArea{spriteSheetArea},
+    xOffset{xOffset},
+    yOffset{yOffset},
+    charBoxes{std::move(charBoxes)} {}
+
+const SDL_FRect* Sprite::getSpriteSheetArea() const {
+    return &this->spriteSheetArea;
+}
+
+unsigned short Sprite::getLength() const {
+    return this->length;
+}
+
+/**
+ * Reads the big-endian numbers of a *.ff file that is already in memory. Reading past the end gives 0 and remembers the
+ * first failure instead of throwing, so that a whole record can be read before checking.
+ */
+class DataReader {
+private:
+    std::span<const std::byte> data; /**< The whole *.ff file. */
+    size_t position = 0UZ; /**< The next byte to read. */
+    const char* failure = nullptr; /**< What was being read when the data ended, @c nullptr if it has not. */
+    size_t failurePosition = 0UZ; /**< Where the data ended. */
+public:
+    /**
+     * Starts reading a *.ff file.
+     * @param data The whole *.ff file.
+     */
+    explicit DataReader(const std::span<const std::byte> data) : data{data} {}
+    /**
+     * Counts the bytes left to read.
+     * @return The bytes after the current position.
+     */
+    size_t remaining() const {
+        return this->data.size() - this->position;
+    }
+    /**
+     * Reads several bytes at once.
+     * @param count How many bytes to read.
+     * @param what What is being read, for the error.
+     * @return The bytes, empty if there are not enough left.
+     */
+    std::span<const std::byte> readBytes(const size_t count, const char* what) {
+        if (count > this->remaining()) {
+            if (this->failure == nullptr) {
+                this->failure = what;
+                this->failurePosition = this->data.size();
+            }
+            this->position = this->data.size();
+            return {};
+        }
+        const std::span<const std::byte> bytes = this->data.subspan(this->position, count);
+        this->position += count;
+        return bytes;
+    }
+    /**
+     * Reads a big-endian unsigned short.
+     * @param what What is being read, for the error.
+     * @return The number, 0 if the data has ended.
+     */
+    uint16_t readU16(const char* what) {
+        const std::span<const std::byte> bytes = this->readBytes(2UZ, what);
+        return bytes.empty() ? 0U : loadU16(bytes.data());
+    }
+    /**
+     * Checks whether any read went past the end of the data.
+     * @return Whether the data ended too early.
+     */
+    bool failed() const {
+        return this->failure != nullptr;
+    }
+    /**
+     * Describes the first read past the end of the data.
+     * @return The error.
+     */
+    CharacterDataError error() const {
+        return CharacterDataError(this->failure, "Reached EOF", this->failurePosition);
+    }
+    /**
+     * Gets the position of the next byte, for errors found after reading.
+     * @return The position.
+     */
+    size_t tell() const {
+        return this->position;
+    }
+    /**
+     * Decodes a big-endian unsigned short.
+     * @param bytes The two bytes.
+     * @return The number.
+     */
+    static uint16_t loadU16(const std::byte* bytes) {
+        return static_cast<uint16_t>((std::to_integer<uint16_t>(bytes[0]) << 8) | std::to_integer<uint16_t>(bytes[1]));
+    }
+    /**
+     * Decodes a big-endian signed short.
+     * @param bytes The two bytes.
+     * @return The number.
+     */
+    static int16_t loadS16(const std::byte* bytes) {
+        return static_cast<int16_t>(loadU16(bytes));
+    }
+    /**
+     * Decodes a big-endian @c float .
+     * @param bytes The four bytes.
+     * @return The number.
+     */
+    static float loadFloat(const std::byte* bytes) {
+        return std::bit_cast<float>((static_cast<uint32_t>(loadU16(bytes)) << 16) | loadU16(bytes + 2));
+    }
+    /**
+     * Decodes four big-endian unsigned shorts into a rectangle.
+     * @param bytes The eight bytes.
+     * @return The rectangle.
+     */
+    static SDL_FRect loadArea(const std::byte* bytes) {
+        return SDL_FRect(static_cast<float>(loadU16(bytes)), static_cast<float>(loadU16(bytes + 2)),
+                         static_cast<float>(loadU16(bytes + 4)), static_cast<float>(loadU16(bytes + 6)));
+    }
+};
+
+/**
+ * The size of a box's rectangle in a *.ff file.
+ */
+static constexpr size_t boxRectSize = 8UZ;
+
+/**
+ * The size of a hitbox's stun and pushback in a *.ff file.
+ */
+static constexpr size_t hitboxStatsSize = 8UZ;
+
+/**
+ * Reads boxes until a @c NULL_TERMINATOR , scaling them as they are read.
+ * @param reader The reader.
+ * @param size The size of the character.
+ * @param boxes The boxes to add to.
+ * @return Whether the boxes could be read; the reader has the error if not.
+ */
+static bool readBoxes(DataReader& reader, const Scalar size, std::vector<CharacterBox>& boxes) {
+    for (uint16_t boxType = reader.readU16("boxType"); boxType != NULL_TERMINATOR; boxType = reader.readU16("boxType")) {
+        const uint16_t count = reader.readU16("count");
+        if (reader.failed()) {
+            return false;
+        }
+        const bool isHitbox = boxType >= HITBOX_BEGIN && boxType <= HITBOX_END;
+        // A count past the end of the data is reported below, without reserving for it first.
+        boxes.reserve(boxes.size() + std::min<size_t>(count, reader.remaining() / boxRectSize));
+        for (uint16_t i = 0U; i < count; ++i) {
+            const std::span<const std::byte> rectBytes = reader.readBytes(boxRectSize, "box");
+            if (rectBytes.empty()) {
+                return false;
+            }
+            ScalarRect rect = ScalarRect::fromFRect(SDL_FRect(static_cast<float>(DataReader::loadS16(rectBytes.data())),
+                                                              static_cast<float>(DataReader::loadS16(rectBytes.data() + 2)),
+                                                              static_cast<float>(DataReader::loadS16(rectBytes.data() + 4)),
+                                                              static_cast<float>(DataReader::loadS16(rectBytes.data() + 6))));
+            multiplySizeRect(rect, size);
+            HitboxProperties properties;
+            if (isHitbox) {
+                properties = HitboxProperties(static_cast<uint8_t>(boxType % 256));
+                const std::span<const std::byte> statBytes = reader.readBytes(hitboxStatsSize, "hitbox stats");
+                if (statBytes.empty()) {
+                    return false;
+                }
+                if (properties.knockback == KNOCKS_DOWN) {
+                    properties.xKnockback = DataReader::loadU16(statBytes.data());
+                    properties.yKnockback = DataReader::loadS16(statBytes.data() + 4);
+                } else {
+                    properties.hitStun = DataReader::loadU16(statBytes.data());
+                    properties.hitPushback = DataReader::loadS16(statBytes.data() + 4);
+                }
+                properties.blockStun = DataReader::loadU16(statBytes.data() + 2);
+                properties.blockPushback = DataReader::loadS16(statBytes.data() + 6);
+            }
+            boxes.emplace_back(static_cast<BoxType>(boxType), properties, rect);
+        }
+    }
+    return !reader.failed();
+}
+
+/**
+ * Checks whether a copied sprite takes the boxes of a type from the sprite it copies.
+ * @param boxType The type of the boxes.
+ * @param copyInfo The bits of information that determine which attributes to copy.
+ * @return Whether the boxes are copied.
+ */
+static bool copiesBoxes(const BoxType boxType, const uint8_t copyInfo) {
+    switch (boxType) {
+        case NULL_TERMINATOR:
+            return false;
+        case HURTBOX:
+            return copyInfo & (1 << 4);
+        case COMMAND_GRAB:
+            return copyInfo & (1 << 3);
+        case THROW_PUSH_GROUND_COLLISION:
+            return copyInfo & (1 << 2);
+        case PROXIMITY_GUARD:
+            return copyInfo & (1 << 1);
+        default:
+            return copyInfo & (1 << 0);
+    }
+}
+
+/**
+ * Reads one sprite, resolving a copy of another sprite from the animations read so far.
+ * @param reader The reader.
+ * @param size The size of the character.
+ * @param animations The animations read so far.
+ * @return The sprite, or why it could not be read.
+ */
+static std::expected<Sprite, CharacterDataError> readSprite(DataReader& reader, const Scalar size, const std::map<unsigned short, std::vector<Sprite>>& animations) {
+    const uint16_t length = reader.readU16("length");
+    if (reader.failed()) {
+        return std::unexpected(reader.error());
+    }
+    std::vector<CharacterBox> boxes;
+    if (length < 0xFF00U) {
+        // The sprite sheet area and the offset are read at once.
+        const std::span<const std::byte> bytes = reader.readBytes(12UZ, "sprite");
+        if (bytes.empty() || !readBoxes(reader, size, boxes)) {
+            return std::unexpected(reader.error());
+        }
+        return Sprite(length, DataReader::loadArea(bytes.data()), DataReader::loadS16(bytes.data() + 8), DataReader::loadS16(bytes.data() + 10), std::move(boxes));
+    }
+    const uint16_t animationType = reader.readU16("copied animationType");
+    const uint16_t index = reader.readU16("copied spriteIndex");
+    if (reader.failed()) {
+        return std::unexpected(reader.error());
+    }
+    const auto animation = animations.find(animationType);
+    if (animation == animations.end() || index >= animation->second.size()) {
+        return std::unexpected(CharacterDataError("copying a sprite", "Copies a sprite that does not exist", reader.tell()));
+    }
+    const Sprite& reference = animation->second[index];
+    const uint8_t copyInfo = static_cast<uint8_t>(length % 256);
+    const unsigned short copiedLength = copyInfo & (1 << 7) ? reference.getLength() : reader.readU16("copied length");
+    SDL_FRect area = *reference.getSpriteSheetArea();
+    if (!(copyInfo & (1 << 6))) {
+        const std::span<const std::byte> bytes = reader.readBytes(8UZ, "copied sprite sheet area");
+        if (!bytes.empty()) {
+            area = DataReader::loadArea(bytes.data());
+        }
+    }
+    signed short xOffset = reference.xOffset;
+    signed short yOffset = reference.yOffset;
+    if (!(copyInfo & (1 << 5))) {
+        const std::span<const std::byte> bytes = reader.readBytes(4UZ, "copied offset");
+        if (!bytes.empty()) {
+            xOffset = DataReader::loadS16(bytes.data());
+            yOffset = DataReader::loadS16(bytes.data() + 2);
+        }
+    }
+    if (reader.failed() || ((copyInfo & 0b00011111U) != 0b00011111U && !readBoxes(reader, size, boxes))) {
+        return std::unexpected(reader.error());
+    }
+    boxes.reserve(boxes.size() + reference.charBoxes.size());
+    for (const CharacterBox& box : reference.charBoxes) {
+        if (copiesBoxes(box.boxType, copyInfo)) {
+            boxes.push_back(box);
+        }
+    }
+    return Sprite(copiedLength, area, xOffset, yOffset, std::move(boxes));
+}
+
+/**
+ * Reads the frames of an animation, resolving copies of the sprites read so far.
+ * @param reader The reader.
+ * @param size The size of the character.
+ * @param type The type of the animation.
+ * @param frameCount How many frames to read.
+ * @param animations The animations read so far, which the frames are added to.
+ * @return Nothing, or why the frames could not be read.
+ */
+static std::expected<void, CharacterDataError> readFrames(DataReader& reader, const Scalar size, const unsigned short type, const unsigned short frameCount, std::map<unsigned short, std::vector<Sprite>>& animations) {
+    std::vector<Sprite>& frames = animations[type];
+    // Every sprite takes at least 2 bytes, so a count past the end of the data reserves no more than what is there.
+    frames.reserve(frames.size() + std::min<size_t>(frameCount, reader.remaining() / 2UZ));
+    for (uint16_t i = 0U; i < frameCount; ++i) {
+        std::expected<Sprite, CharacterDataError> sprite = readSprite(reader, size, animations);
+        if (!sprite) {
+            return std::unexpected(sprite.error());
+        }
+        frames.push_back(std::move(*sprite));
+    }
+    return {};
+}
+
+std::expected<CharacterData, CharacterDataError> parseCharacterData(const std::span<const std::byte> bytes, const bool scaleBoxes) {
+    if (CharacterContainer::isContainer(bytes)) {
+        std::expected<CharacterContainer, CharacterDataError> container = CharacterContainer::open(bytes);
+        if (!container) {
+            return std::unexpected(container.error());
+        }
+        return container->readCharacterData(true, scaleBoxes);
+    }
+    DataReader reader(bytes);
+    CharacterData data;
+    const uint16_t header = reader.readU16("header");
+    if (reader.failed()) {
+        return std::unexpected(reader.error());
+    }
+    if (header != characterDataHeader) {
+        return std::unexpected(CharacterDataError("checking header", "Invalid header", 0UZ));
+    }
+    const uint16_t numberOfPalettes = reader.readU16("numberOfPalettes");
+    const uint16_t numberOfColors = reader.readU16("numberOfColors");
+    // Every palette is read at once.
+    const std::span<const std::byte> colors = reader.readBytes(static_cast<size_t>(numberOfPalettes) * numberOfColors * 3UZ, "palettes");
+    if (reader.failed()) {
+        return std::unexpected(reader.error());
+    }
+    if (numberOfPalettes == 0U || numberOfColors == 0U) {
+        return std::unexpected(CharacterDataError("checking palettes", "No colors", reader.tell()));
+    }
+    const std::span<const std::byte> stats = reader.readBytes(sizeof(CharacterStats), "stats");
+    if (reader.failed()) {
+        return std::unexpected(reader.error());
+    }
+    data.palettes.resize(numberOfPalettes);
+    for (size_t i = 0UZ; i < numberOfPalettes; ++i) {
+        data.palettes[i].reserve(numberOfColors);
+        for (size_t j = 0UZ; j < numberOfColors; ++j) {
+            const std::byte* color = colors.data() + (i * numberOfColors + j) * 3UZ;
+            data.palettes[i].emplace_back(std::to_integer<uint8_t>(color[0]), std::to_integer<uint8_t>(color[1]), std::to_integer<uint8_t>(color[2]), 0xFFU);
+        }
+    }
+    data.stats.size = DataReader::loadFloat(stats.data());
+    data.stats.walkForwardSpeed = DataReader::loadFloat(stats.data() + 4);
+    data.stats.walkBackwardSpeed = DataReader::loadFloat(stats.data() + 8);
+    data.stats.jumpForwardXVelocity = DataReader::loadFloat(stats.data() + 12);
+    data.stats.jumpBackwardXVelocity = DataReader::loadFloat(stats.data() + 16);
+    data.stats.initialJumpVelocity = DataReader::loadFloat(stats.data() + 20);
+    data.stats.gravity = DataReader::loadFloat(stats.data() + 24);
+    const Scalar size = scaleBoxes ? Scalar(data.stats.size) : Scalar(1);
+    std::map<unsigned short, std::vector<Sprite>> parsedAnimations;
+    // A trailing odd byte is ignored, as it always has been.
+    while (reader.remaining() >= 2UZ) {
+        const uint16_t animationIndex = reader.readU16("animationIndex");
+        const uint16_t numberOfFrames = reader.readU16("numberOfFrames");
+        if (reader.failed()) {
+            return std::unexpected(reader.error());
+        }
+        if (std::expected<void, CharacterDataError> read = readFrames(reader, size, animationIndex, numberOfFrames, parsedAnimations); !read) {
+            return std::unexpected(read.error());
+        }
+    }
+    data.animations = AnimationTable<Sprite>(std::move(parsedAnimations));
+    return data;
+}
+
+std::expected<std::vector<Sprite>, CharacterDataError> parseAnimationSection(const std::span<const std::byte> section, const unsigned short type, const unsigned short frameCount, const Scalar size) {
+    DataReader reader(section);
+    std::map<unsigned short, std::vector<Sprite>> animation;
+    if (std::expected<void, CharacterDataError> read = readFrames(reader, size, type, frameCount, animation); !read) {
+        return std::unexpected(read.error());
+    }
+    if (reader.remaining() != 0UZ) {
+        return std::unexpected(CharacterDataError("checking section", "Section is longer than its sprites", reader.tell()));
+    }
+    return std::move(animation[type]);
+}
+
+CharacterData readCharacterData(SDL_IOStream*& stream) {
+    std::vector<std::byte> bytes;
+    const Sint64 size = SDL_GetIOSize(stream);
+    const Sint64 position = SDL_TellIO(stream);
+    if (size > 0 && position >= 0 && size > position) {
+        bytes.reserve(static_cast<size_t>(size - position));
+    }
+    std::array<std::byte, 0x10000> chunk;
+    for (size_t read = SDL_ReadIO(stream, chunk.data(), chunk.size()); read > 0UZ; read = SDL_ReadIO(stream, chunk.data(), chunk.size())) {
+        bytes.insert(bytes.end(), chunk.begin(), chunk.begin() + static_cast<std::ptrdiff_t>(read));
+    }
+    if (SDL_GetIOStatus(stream) == SDL_IO_STATUS_ERROR) {
+        throw DataException<long>(std::string(__PRETTY_FUNCTION__) + " while reading the stream", std::string(SDL_GetError()), SDL_TellIO(stream));
+    }
+    std::expected<CharacterData, CharacterDataError> data = parseCharacterData(bytes);
+    if (!data) {
+        throw DataException<long>(std::string(__PRETTY_FUNCTION__) + " while " + data.error().origin, std::string(data.error().error), static_cast<long>(data.error().position));
+    }
+    return std::move(*data);
+}
@@ -0,0 +1,228 @@
+#pragma once
+
+#include "animation_table.hpp"
+#include "scalar.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include <SDL3/SDL.h>
+
+/**
+ * The different types of boxes in a character's data.
+ */
+enum BoxType : unsigned short {
+    NULL_TERMINATOR = 0x0000U, /**< Indicates the end of box definition. */
+    HURTBOX = 0x0001U, /**< Where the character can be hit by attacks. */
+    COMMAND_GRAB = 0x0002U, /**< Where a character grabs the opponent with a command grab. */
+    THROW_PUSH_GROUND_COLLISION = 0x0003U, /**< Where a character can be thrown or pushed, as well as ground collision detection. */
+    PROXIMITY_GUARD = 0x0004U, /**< If a character is holding back or down-back while overlapping with this kind of box, they are forced to enter the blocking animation. */
+    HITBOX_BEGIN = 0x0100U, /**< Begins the definition of hitboxes, or attacks. */
+    HITBOX_END = 0x01FFU, /**< Ends the definition of hitboxes, or attacks. */
+};
+
+/**
+ * The various types of character animations.
+ */
+enum AnimationType : unsigned short {
+    IDLE = 0x0000U, /**< Not doing anything. */
+    WALK_FORWARD = 0x0001U, /**< Walking forward. */
+    WALK_BACKWARD = 0x0002U, /**< Walking backward. */
+    CROUCH_TRANSITION = 0x0003U, /**< Transitioning from standing to crouching, or vice versa. */
+    CROUCH = 0x0004U, /**< Crouching. */
+    STAND_BLOCK = 0x0005U, /**< Blocking an attack while standing. */
+    CROUCH_BLOCK = 0x0006U, /**< Blocking an attack while crouching. */
+    PRE_JUMP = 0x0007U, /**< Frames before jumping. */
+    JUMP_FORWARD = 0x0008U, /**< Jumping forward. */
+    JUMP_NEUTRAL = 0x0009U, /**< Jumping vertically. */
+    JUMP_BACKWARD = 0x000AU, /**< Jumping backward. */
+    STAND_GETTING_HIT = 0x000BU, /**< Getting hit while standing. */
+    CROUCH_GETTING_HIT = 0x000CU, /**< Getting hit while crouching. */
+    AIR_GETTING_HIT = 0x000DU, /**< Getting hit in midair. */
+    AIR_RESET = 0x000EU, /**< The character landing on their feet after getting hit in midair. */
+    KNOCKDOWN = 0x000FU, /**< Getting knocked down. */
+    GET_UP = 0x0010U, /**< Getting up. */
+    VICTORY = 0x0011U, /**< Animation that plays when the character wins a round. */
+    DEFEAT = 0x0012U, /**< Animation that plays when the character loses a round to a time-out. */
+    STAND_LIGHT_PUNCH = 0x0100U, /**< Standing light punch (5LP). */
+    STAND_HEAVY_PUNCH = 0x0101U, /**< Standing heavy punch (5HP). */
+    STAND_LIGHT_KICK = 0x0102U, /**< Standing light kick (5LK). */
+    STAND_HEAVY_KICK = 0x0103U, /**< Standing heavy kick (5HK). */
+    FORWARD_LIGHT_KICK = 0x0104U, /**< Forward light kick (6LK), universal overhead. */
+    CROUCH_LIGHT_PUNCH = 0x0110U, /**< Crouching light punch (2LP). */
+    CROUCH_HEAVY_PUNCH = 0x0111U, /**< Crouching heavy punch (2HP), universal anti-air. */
+    CROUCH_LIGHT_KICK = 0x0112U, /**< Crouching light kick (2LK). */
+    CROUCH_HEAVY_KICK = 0x0113U, /**< Crouching heavy kick (2HK), aka sweep. */
+    JUMP_LIGHT_PUNCH = 0x0120U, /**< Jumping light punch (j.LP). */
+    JUMP_HEAVY_PUNCH = 0x0121U, /**< Jumping heavy punch (j.HP). */
+    JUMP_LIGHT_KICK = 0x0122U, /**< Jumping light kick (j.LK). */
+    JUMP_HEAVY_KICK = 0x0123U, /**< Jumping heavy kick (j.HK). */
+    COMMAND_NORMALS_START = 0x0124U, /**< Begins the definition of other command normals. */
+    COMMAND_NORMALS_END = 0x017FU, /**< Ends the definition of other command normals. */
+    FORWARD_THROW = 0x0180U, /**< Throwing the opponent forwards. */
+    BACKWARD_THROW = 0x0181U, /**< Throwing the opponent backwards. */
+    SPECIALS_START = 0x0200U, /**< Begins the definition of special moves. */
+    SPECIALS_END = 0x02FFU, /**< Ends the definition of special moves. */
+    SUPER = 0x0300U, /**< The character's Super Art. */
+    CHARACTER_SPECIFIC_METER_ASSETS_BEGIN = 0xF000U, /**< Begins the definition of character-specific meter assets. */
+    CHARACTER_SPECIFIC_METER_ASSETS_END = 0xF0FFU, /**< Ends the definition of character-specific meter assets. */
+    MISC_ASSETS_BEGIN = 0xF100U, /**< Begins the definition of miscellaneous assets. */
+    MISC_ASSETS_END = 0xF1FFU, /**< Ends the definition of miscellaneous assets. */
+    CHARACTER_SELECTION_IMAGE = 0xFF00U, /**< Image of the character on the character selection screen. */
+    CHARACTER_WIN_IMAGE = 0xFF01U, /**< Image shown after a game if the character wins. */
+    CHARACTER_LOSS_IMAGE = 0xFF02U, /**< Image shown after a game if the character loses. */
+    NOTHING = 0xFFFFU /**< Indicates none of the above. */
+};
+
+enum KnockbackLevel : uint8_t {
+    MILD,
+    MEDIUM,
+    HEAVY,
+    KNOCKS_DOWN
+};
+
+struct HitboxProperties {
+    bool blockableHigh = true;
+    bool blockableLow = true;
+    bool specialCancelable = true;
+    bool superCancelable = true;
+    KnockbackLevel knockback = MILD;
+    bool hardKnockdown = false;
+    bool airReset = true;
+    unsigned short hitStun = 0U, blockStun = 0U;
+    signed short hitPushback = 0, blockPushback = 0;
+    unsigned short xKnockback = 0U;
+    signed short yKnockback = 0;
+    constexpr explicit HitboxProperties(uint8_t data);
+    HitboxProperties() = default;
+    ~HitboxProperties() = default;
+};
+
+constexpr HitboxProperties::HitboxProperties(uint8_t data) {
+    this->blockableHigh = data & (1 << 7);
+    this->blockableLow = data & (1 << 6);
+    this->specialCancelable = data & (1 << 5);
+    this->superCancelable = data & (1 << 4);
+    this->knockback = static_cast<KnockbackLevel>((data & (1 << 3)) | (data & (1 << 2)));
+    this->hardKnockdown = data & (1 << 1);
+    this->airReset = data & (1 << 0);
+}
+
+struct CharacterBox {
+    BoxType boxType = NULL_TERMINATOR;
+    HitboxProperties hitboxProperties;
+    ScalarRect rect{};
+    CharacterBox(BoxType currentBoxType, HitboxProperties hitboxProperties, ScalarRect rect);
+    CharacterBox() = default;
+    ~CharacterBox() = default;
+};
+
+/**
+ * Represents a frame of an animation.
+ */
+class Sprite {
+private:
+    unsigned short length; /**< How many frames (1/60 of a second) to show the sprite for. */
+    SDL_FRect spriteSheetArea; /**< The area of the sprite sheet where the sprite's image is located. */
+public:
+    signed short xOffset = 0x0000; /**< The horizontal offset of this asset. */
+    signed short yOffset = 0x0000; /**< The vertical offset of this asset. */
+    std::vector<CharacterBox> charBoxes; /**< The sprite's boxes, relative to the top-left corner of the character and scaled to the character's size. */
+    /**
+     * Constructs a sprite out of data that has already been read and scaled.
+     * @param length How many frames (1/60 of a second) to show the sprite for.
+     * @param spriteSheetArea The area of the sprite sheet where the sprite's image is located.
+     * @param xOffset The horizontal offset of the sprite.
+     * @param yOffset The vertical offset of the sprite.
+     * @param charBoxes The sprite's boxes, relative to the top-left corner of the character and scaled to the character's size.
+     */
+    Sprite(unsigned short length, SDL_FRect spriteSheetArea, signed short xOffset, signed short yOffset, std::vector<CharacterBox>&& charBoxes);
+    /**
+     * Destroys a sprite.
+     */
+    ~Sprite() = default;
+    /**
+     * Gets the sprite's sprite sheet area.
+     * @return The area on the sprite sheet where the sprite gets its image from, which lives as long as the sprite.
+     */
+    const SDL_FRect* getSpriteSheetArea() const;
+    /**
+     * Gets the sprite's duration.
+     * @return How many frames (1/60 of a second) to show the sprite for.
+     */
+    unsigned short getLength() const;
+};
+
+/**
+ * The stats of a character, in the order they are stored in its data file.
+ */
+struct CharacterStats {
+    float size = 1.0F; /**< How much to scale the character. */
+    float walkForwardSpeed = 0.0F; /**< The speed at which the character walks forward (pixels/frame). */
+    float walkBackwardSpeed = 0.0F; /**< The speed at which the character walks backward (pixels/frame). */
+    float jumpForwardXVelocity = 0.0F; /**< The speed at which the character moves forward when jumping (pixels/frame). */
+    float jumpBackwardXVelocity = 0.0F; /**< The speed at which the character moves backward when jumping (pixels/frame). */
+    float initialJumpVelocity = 0.0F; /**< The initial velocity at which the character leaves the ground when jumping (pixels/frame). */
+    float gravity = 0.0F; /**< The speed at which the character falls (pixels/frame^2). */
+};
+
+static_assert(sizeof(CharacterStats) == 28UZ, "CharacterStats must have no padding, so that it can be stored as it is");
+
+class DeferredAnimations;
+
+/**
+ * Everything that a character's data describes, ready to be given to a @c Character .
+ */
+struct CharacterData {
+    std::vector<std::vector<SDL_Color>> palettes; /**< The color schemes of the character, starting with the base palette. */
+    CharacterStats stats; /**< The stats of the character. */
+    AnimationTable<Sprite> animations; /**< The character's animations, with every box already scaled to the character's size. */
+    std::shared_ptr<const DeferredAnimations> deferred; /**< The rarely used animations left out of @c CharacterData::animations until they are first used, @c nullptr if there are none. */
+};
+
+/**
+ * Why a character's data could not be read.
+ */
+struct CharacterDataError {
+    const char* origin; /**< What was being read. */
+    const char* error; /**< What went wrong. */
+    size_t position; /**< Where in the data it went wrong, in bytes. */
+};
+
+/**
+ * The first two bytes of every *.ff file, which represent "FOSS".
+ */
+constexpr uint16_t characterDataHeader = 0xF055U;
+
+/**
+ * Parses a character's *.ff file in one pass, resolving copied sprites and scaling the boxes to the character's size
+ * as they are read. Both the sequential layout and @c CharacterContainer are read. Nothing is thrown: a malformed file
+ * is reported in the result.
+ * @param data The whole *.ff file.
+ * @param scaleBoxes Whether to scale the boxes, which only tools that write *.ff files turn off.
+ * @return The character's data, or why it could not be read.
+ */
+std::expected<CharacterData, CharacterDataError> parseCharacterData(std::span<const std::byte> data, bool scaleBoxes = true);
+
+/**
+ * Parses the sprites of one animation, stored back to back the same way as in a sequential *.ff file. Copies may only
+ * refer to earlier sprites of the same animation.
+ * @param section The sprites, and nothing else.
+ * @param type The type of the animation.
+ * @param frameCount How many sprites there are.
+ * @param size How much to scale the boxes.
+ * @return The sprites, or why they could not be read.
+ */
+std::expected<std::vector<Sprite>, CharacterDataError> parseAnimationSection(std::span<const std::byte> section, unsigned short type, unsigned short frameCount, Scalar size);
+
+/**
+ * Reads a character's data from a *.ff file, resolving copied sprites and scaling the boxes to the character's size.
+ * @param stream The stream of data to read from, which is read to its end in one go and not closed.
+ * @return The character's data.
+ * @exception DataException Throws a @c DataException<long> holding the position of the problem when the stream cannot be read or the data is malformed.
+ */
+CharacterData readCharacterData(SDL_IOStream*& stream);
@@ -0,0 +1,58 @@
+#include "character_pack.hpp"
+
+#include "compiled_character.hpp"
+#include "data_exception.hpp"
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+CharacterPack::CharacterPack(const std::string& path) {
+    const int file = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (file < 0) {
+        throw DataException<int>(std::string(__PRETTY_FUNCTION__) + " while opening " + path, std::string(std::strerror(errno)), errno);
+    }
+    struct stat status{};
+    if (fstat(file, &status) != 0) {
+        const int error = errno;
+        close(file);
+        throw DataException<int>(std::string(__PRETTY_FUNCTION__) + " while reading the size of " + path, std::string(std::strerror(error)), error);
+    }
+    if (status.st_size <= 0) {
+        close(file);
+        throw DataException<int>(std::string(__PRETTY_FUNCTION__) + " while mapping " + path, std::string("File is empty"));
+    }
+    this->mappingSize = static_cast<size_t>(status.st_size);
+    this->mapping = mmap(nullptr, this->mappingSize, PROT_READ, MAP_PRIVATE, file, 0);
+    const int error = errno;
+    // The mapping keeps the file alive on its own.
+    close(file);
+    if (this->mapping == MAP_FAILED) {
+        this->mapping = nullptr;
+        throw DataException<int>(std::string(__PRETTY_FUNCTION__) + " while mapping " + path, std::string(std::strerror(error)), error);
+    }
+    this->data = std::span<const std::byte>(static_cast<const std::byte*>(this->mapping), this->mappingSize);
+}
+
+CharacterPack::CharacterPack(const std::span<const std::byte> data) : data{data} {}
+
+CharacterPack::~CharacterPack() {
+    if (this->mapping != nullptr) {
+        munmap(this->mapping, this->mappingSize);
+    }
+}
+
+CompiledCharacter CharacterPack::getCompiled() const {
+    return CompiledCharacter(this->data);
+}
+
+std::span<const std::byte> CharacterPack::getData() const {
+    return this->data;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "compiled_character.hpp"
+
+#include <cstddef>
+#include <span>
+#include <string>
+
+/**
+ * The data of one compiled character, either mapped from a *.ffc file or linked into the game.
+ *
+ * A mapped pack is never read into memory as a whole: the pages of the file are only loaded when they are read, and
+ * they stop counting towards the game's memory once the pack is destroyed.
+ */
+class CharacterPack {
+private:
+    std::span<const std::byte> data; /**< The compiled character. */
+    void* mapping = nullptr; /**< The mapping of the file, @c nullptr if the data is linked into the game. */
+    size_t mappingSize = 0UZ; /**< The size of the mapping. */
+public:
+    /**
+     * Maps a compiled character from a file, read-only.
+     * @param path The path of the *.ffc file.
+     * @exception DataException Throws a @c DataException<int> when the file cannot be opened or mapped.
+     */
+    explicit CharacterPack(const std::string& path);
+    /**
+     * Uses a compiled character linked into the game.
+     * @param data The compiled character, which must outlive the pack.
+     */
+    explicit CharacterPack(std::span<const std::byte> data);
+    CharacterPack(const CharacterPack&) = delete;
+    CharacterPack& operator=(const CharacterPack&) = delete;
+    /**
+     * Unmaps the file, if the pack was mapped from one.
+     */
+    ~CharacterPack();
+    /**
+     * Reads the compiled character in place.
+     * @return The compiled character, which must not outlive the pack.
+     * @exception DataException Any of the exceptions thrown by @c CompiledCharacter::CompiledCharacter .
+     */
+    CompiledCharacter getCompiled() const;
+    /**
+     * Gets the data of the pack.
+     * @return The compiled character, as bytes.
+     */
+    std::span<const std::byte> getData() const;
+};
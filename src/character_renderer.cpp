@@ -0,0 +1,255 @@
+#include "character_renderer.hpp"
+
+#include "character.hpp"
+#include "character_pack.hpp"
+#include "compiled_character.hpp"
+#include "palette_swap.hpp"
+#include "roster.hpp"
+#include "texture_atlas.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <SDL3/SDL.h>
+
+bool boxTypeToColor(SDL_Renderer*& renderer, const BoxType boxType, const bool translucent) {
+    const uint8_t alpha = translucent ? 0x80U : 0xFFU;
+    switch (boxType) {
+        case NULL_TERMINATOR:
+            return true;
+        case HURTBOX:
+            return SDL_SetRenderDrawColor(renderer, 0x00U, 0x00U, 0xFFU, alpha); // blue
+        case COMMAND_GRAB:
+            return SDL_SetRenderDrawColor(renderer, 0xFFU, 0xA5U, 0x00U, alpha); // orange
+        case THROW_PUSH_GROUND_COLLISION:
+            return SDL_SetRenderDrawColor(renderer, 0x00U, 0xFFU, 0x00U, alpha); // green
+        case PROXIMITY_GUARD:
+            return SDL_SetRenderDrawColor(renderer, 0xFFU, 0xFFU, 0x00U, alpha); // yellow
+        default:
+            return SDL_SetRenderDrawColor(renderer, 0xFFU, 0x00U, 0x00U, alpha); // red
+    }
+}
+
+/**
+ * Wraps the pixels of a character's compiled sprite sheet, without decoding or copying them.
+ * @param name The name of the character, whose pack must stay open while the sprite sheet is used.
+ * @return The sprite sheet, whose pixels are read-only and must not be changed, or @c nullptr if it could not be
+ * wrapped.
+ */
+static SDL_Surface* loadSpriteSheet(const std::string& name) {
+    const std::shared_ptr<const CharacterPack> pack = openCharacterPack(name);
+    const CompiledCharacter compiled = pack->getCompiled();
+    const CompiledHeader& header = compiled.getHeader();
+    // SDL only takes mutable pixels, but nothing writes to the base sprite sheet: recoloring works on a copy.
+    return SDL_CreateSurfaceFrom(static_cast<int>(header.sheetWidth),
+                                 static_cast<int>(header.sheetHeight),
+                                 static_cast<SDL_PixelFormat>(header.sheetFormat),
+                                 const_cast<std::byte*>(compiled.getPixels().data()),
+                                 static_cast<int>(header.sheetPitch));
+}
+
+/**
+ * Gets the colors of a palette.
+ * @param palette The palette.
+ * @return The colors.
+ */
+static std::span<const SDL_Color> paletteColors(const SDL_Palette* palette) {
+    return std::span<const SDL_Color>(palette->colors, static_cast<size_t>(palette->ncolors));
+}
+
+/**
+ * Converts the colors of a palette to pixel values.
+ * @param palette The colors of the palette.
+ * @param format The format of the pixels.
+ * @return The pixel value of each color.
+ */
+static std::vector<uint32_t> paletteToPixels(const std::span<const SDL_Color> palette, const SDL_PixelFormatDetails* format) {
+    std::vector<uint32_t> pixels(palette.size());
+    for (size_t i = 0UZ; i < palette.size(); ++i) {
+        const SDL_Color& color = palette[i];
+        pixels[i] = SDL_MapRGBA(format, nullptr, color.r, color.g, color.b, color.a);
+    }
+    return pixels;
+}
+
+/**
+ * Makes a copy of a sprite sheet in another palette, in one pass over the pixels.
+ * @param spriteSheet The sprite sheet, in @c SDL_PIXELFORMAT_RGBA32 .
+ * @param from The palette that the sprite sheet is drawn in.
+ * @param to The palette to recolor it to.
+ * @return The recolored copy, which must be destroyed with @c SDL_DestroySurface .
+ * @exception DataException Throws a @c DataException<int> when the copy cannot be made.
+ */
+static SDL_Surface* recolorSpriteSheet(SDL_Surface* spriteSheet, const std::span<const SDL_Color> from, const std::span<const SDL_Color> to) {
+    SDL_Surface* recolored = SDL_DuplicateSurface(spriteSheet);
+    if (recolored == nullptr) {
+        throw DataException<int>(std::string(__PRETTY_FUNCTION__) + " while copying sprite sheet", std::string(SDL_GetError()));
+    }
+    const SDL_PixelFormatDetails* format = SDL_GetPixelFormatDetails(recolored->format);
+    const PaletteSwap swap(paletteToPixels(from, format), paletteToPixels(to, format));
+    for (int y = 0; y < recolored->h; ++y) {
+        uint32_t* row = reinterpret_cast<uint32_t*>(static_cast<uint8_t*>(recolored->pixels) + static_cast<ptrdiff_t>(y) * recolored->pitch);
+        swap.apply(std::span<uint32_t>(row, static_cast<size_t>(recolored->w)));
+    }
+    return recolored;
+}
+
+PreparedSpriteSheets::PreparedSpriteSheets(std::shared_ptr<const CharacterPack> pack, std::vector<SDL_Surface*>&& surfaces)
+    : pack{std::move(pack)}, surfaces{std::move(surfaces)} {}
+
+PreparedSpriteSheets::~PreparedSpriteSheets() {
+    for (SDL_Surface* surface : this->surfaces) {
+        SDL_DestroySurface(surface);
+    }
+}
+
+PreparedSpriteSheets::PreparedSpriteSheets(PreparedSpriteSheets&& other) noexcept
+    : pack{std::move(other.pack)}, surfaces{std::exchange(other.surfaces, {})} {}
+
+PreparedSpriteSheets& PreparedSpriteSheets::operator=(PreparedSpriteSheets&& other) noexcept {
+    if (this != &other) {
+        for (SDL_Surface* surface : this->surfaces) {
+            SDL_DestroySurface(surface);
+        }
+        this->surfaces = std::exchange(other.surfaces, {});
+        this->pack = std::move(other.pack);
+    }
+    return *this;
+}
+
+std::span<SDL_Surface* const> PreparedSpriteSheets::getSurfaces() const {
+    return this->surfaces;
+}
+
+PreparedSpriteSheets CharacterRenderer::prepare(const std::string& name, const std::vector<std::vector<SDL_Color>>& palettes) {
+    // The base sprite sheet reads its pixels from the pack, so the pack goes with the sprite sheets.
+    std::shared_ptr<const CharacterPack> pack = openCharacterPack(name);
+    SDL_Surface* spriteSheet = loadSpriteSheet(name);
+    if (spriteSheet == nullptr) {
+        throw DataException<int>(std::string(__PRETTY_FUNCTION__) + " while loading sprite sheet for " + name, std::string(SDL_GetError()));
+    }
+    std::vector<SDL_Surface*> surfaces{spriteSheet};
+    surfaces.reserve(palettes.size());
+    try {
+        for (size_t palette = 1UZ; palette < palettes.size(); ++palette) {
+            surfaces.push_back(recolorSpriteSheet(spriteSheet, palettes.front(), palettes[palette]));
+        }
+    } catch (...) {
+        for (SDL_Surface* surface : surfaces) {
+            SDL_DestroySurface(surface);
+        }
+        throw;
+    }
+    return PreparedSpriteSheets(std::move(pack), std::move(surfaces));
+}
+
+CharacterRenderer::CharacterRenderer(const Character& character, SDL_Renderer*& renderer, const PreparedSpriteSheets& sheets)
+    : renderCoordinates{character.getCoordinates()} {
+    const std::span<SDL_Surface* const> surfaces = sheets.getSurfaces();
+    if (surfaces.size() != character.getAltPalettes().size()) {
+        throw DataException<int>(std::string(__PRETTY_FUNCTION__) + " while uploading sprite sheets for " + character.name, std::string("Not one sprite sheet per palette"), static_cast<int>(surfaces.size()));
+    }
+    try {
+        for (size_t palette = 0UZ; palette < surfaces.size(); ++palette) {
+            const std::string key = TextureAtlas::makeKey(character.name, static_cast<unsigned short>(palette));
+            SDL_Texture* texture = TextureAtlas::tryAcquire(key);
+            if (texture == nullptr) {
+                SDL_Surface* surface = surfaces[palette];
+                texture = TextureAtlas::acquire(renderer, key, surface);
+            }
+            this->textureKeys.push_back(key);
+            this->textures.push_back(texture);
+        }
+    } catch (...) {
+        for (const std::string& key : this->textureKeys) {
+            TextureAtlas::release(key);
+        }
+        throw;
+    }
+}
+
+CharacterRenderer::CharacterRenderer(const Character& character, SDL_Renderer*& renderer)
+    : renderCoordinates{character.getCoordinates()} {
+    const std::vector<SDL_Palette*>& palettes = character.getAltPalettes();
+    // The sprite sheet's pixels are read from the pack, so it stays mapped until every texture is uploaded.
+    const std::shared_ptr<const CharacterPack> pack = openCharacterPack(character.name);
+    SDL_Surface* spriteSheet = nullptr;
+    try {
+        for (size_t palette = 0UZ; palette < palettes.size(); ++palette) {
+            const std::string key = TextureAtlas::makeKey(character.name, static_cast<unsigned short>(palette));
+            // A mirror match uses the textures of the other player as they are.
+            SDL_Texture* texture = TextureAtlas::tryAcquire(key);
+            if (texture == nullptr) {
+                if (spriteSheet == nullptr) {
+                    spriteSheet = TextureAtlas::acquireSheet(character.name, loadSpriteSheet);
+                }
+                if (palette == 0UZ) {
+                    texture = TextureAtlas::acquire(renderer, key, spriteSheet);
+                } else {
+                    SDL_Surface* recolored = recolorSpriteSheet(spriteSheet, paletteColors(character.getBasePalette()), paletteColors(palettes[palette]));
+                    try {
+                        texture = TextureAtlas::acquire(renderer, key, recolored);
+                    } catch (...) {
+                        SDL_DestroySurface(recolored);
+                        throw;
+                    }
+                    SDL_DestroySurface(recolored);
+                }
+            }
+            this->textureKeys.push_back(key);
+            this->textures.push_back(texture);
+        }
+    } catch (...) {
+        for (const std::string& key : this->textureKeys) {
+            TextureAtlas::release(key);
+        }
+        if (spriteSheet != nullptr) {
+            TextureAtlas::releaseSheet(character.name);
+        }
+        throw;
+    }
+    // Every palette is uploaded, so the decoded sprite sheet is not needed anymore.
+    if (spriteSheet != nullptr) {
+        TextureAtlas::releaseSheet(character.name);
+    }
+}
+
+CharacterRenderer::~CharacterRenderer() {
+    for (const std::string& key : this->textureKeys) {
+        TextureAtlas::release(key);
+    }
+}
+
+void CharacterRenderer::render(SDL_Renderer*& renderer, Character& character) {
+    const Sprite& currentSprite = character.getCurrentSprite();
+    const SDL_FRect coordinates = character.getCoordinates();
+    this->renderCoordinates.x = coordinates.x + currentSprite.xOffset;
+    this->renderCoordinates.y = coordinates.y + currentSprite.yOffset;
+    this->renderCoordinates.w = coordinates.w;
+    this->renderCoordinates.h = coordinates.h;
+    if (!SDL_RenderTexture(renderer, this->textures.at(character.getPalette()), currentSprite.getSpriteSheetArea(), &this->renderCoordinates)) {
+        throw DataException<unsigned int>(std::string(__PRETTY_FUNCTION__) + " while rendering sprite texture", std::string(SDL_GetError()));
+    }
+#if DEBUG_RENDER_BOXES
+    for (const ActiveBox& active : character.getActiveBoxes()) {
+        const SDL_FRect rect = active.rect.toFRect();
+        if (!boxTypeToColor(renderer, active.box->boxType, false)) {
+            throw DataException<unsigned char>(std::string(__PRETTY_FUNCTION__) + " while setting box outline color", std::string(SDL_GetError()));
+        }
+        if (!SDL_RenderRect(renderer, &rect)) {
+            throw DataException<unsigned char>(std::string(__PRETTY_FUNCTION__) + " while rendering box outline", std::string(SDL_GetError()));
+        }
+        if (!boxTypeToColor(renderer, active.box->boxType, true)) {
+            throw DataException<unsigned char>(std::string(__PRETTY_FUNCTION__) + " while setting box color", std::string(SDL_GetError()));
+        }
+        if (!SDL_RenderFillRect(renderer, &rect)) {
+            throw DataException<unsigned char>(std::string(__PRETTY_FUNCTION__) + " while rendering box", std::string(SDL_GetError()));
+        }
+    }
+#endif
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "character.hpp"
+#include "character_pack.hpp"
+
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <SDL3/SDL.h>
+
+/**
+ * Determines whether to render the boxes.
+ */
+#define DEBUG_RENDER_BOXES true
+
+/**
+ * Converts a box type to a color, and modifies the renderer to use it.
+ * @param renderer The renderer to change the color of.
+ * @param boxType The box type, used for determining the color.
+ * @param outline Whether to render an outline (@c true) or a box (@c false).
+ * @return Whether changing the renderer's color was a success.
+ * @exception DataException When given an unknown box type.
+ */
+bool boxTypeToColor(SDL_Renderer*& renderer, BoxType boxType, bool outline);
+
+/**
+ * A character's sprite sheet in every palette, recolored off the render thread by @c CharacterRenderer::prepare so that
+ * making a @c CharacterRenderer only takes uploading it.
+ */
+class PreparedSpriteSheets {
+private:
+    std::shared_ptr<const CharacterPack> pack; /**< The character's pack, which holds the pixels of the base sprite sheet. */
+    std::vector<SDL_Surface*> surfaces; /**< The sprite sheet in each palette, starting with the base palette. */
+public:
+    /**
+     * Takes ownership of a character's sprite sheets.
+     * @param pack The character's pack, which the first sprite sheet reads its pixels from.
+     * @param surfaces The sprite sheet in each palette, starting with the base palette.
+     */
+    PreparedSpriteSheets(std::shared_ptr<const CharacterPack> pack, std::vector<SDL_Surface*>&& surfaces);
+    /**
+     * Destroys the sprite sheets.
+     */
+    ~PreparedSpriteSheets();
+    PreparedSpriteSheets(const PreparedSpriteSheets&) = delete;
+    PreparedSpriteSheets& operator=(const PreparedSpriteSheets&) = delete;
+    PreparedSpriteSheets(PreparedSpriteSheets&& other) noexcept;
+    PreparedSpriteSheets& operator=(PreparedSpriteSheets&& other) noexcept;
+    /**
+     * Gets the sprite sheets.
+     * @return The sprite sheet in each palette, in @c SDL_PIXELFORMAT_RGBA32 , which must not be changed.
+     */
+    std::span<SDL_Surface* const> getSurfaces() const;
+};
+
+/**
+ * Draws a @c Character onto the screen. The character itself only simulates, so that it can run without a renderer.
+ */
+class CharacterRenderer {
+private:
+    std::vector<std::string> textureKeys; /**< The key of the sprite sheet in each palette in the @c TextureAtlas . */
+    std::vector<SDL_Texture*> textures; /**< The texture of the whole sprite sheet in each palette, shared by every sprite. */
+    SDL_FRect renderCoordinates; /**< The current rendering coordinates of the character. */
+public:
+    /**
+     * Loads a character's sprite sheet, then recolors it and uploads it in every palette, unless another character
+     * already did. Switching palettes with @c Character::setPalette then only picks another texture.
+     * @param character The character to draw.
+     * @param renderer The renderer to render the character onto.
+     * @exception DataException Throws a @c DataException<int> when encountering issues loading the sprite sheet or creating its textures, or any of the exceptions thrown by @c openCharacterPack .
+     */
+    CharacterRenderer(const Character& character, SDL_Renderer*& renderer);
+    /**
+     * Uploads a character's sprite sheets, unless another character already did. Only this needs the render thread.
+     * @param character The character to draw.
+     * @param renderer The renderer to render the character onto.
+     * @param sheets The sprite sheets made by @c CharacterRenderer::prepare from the character's palettes, which can
+     * be destroyed once this returns.
+     * @exception DataException Throws a @c DataException<int> when there is not one sprite sheet per palette or the
+     * textures cannot be created.
+     */
+    CharacterRenderer(const Character& character, SDL_Renderer*& renderer, const PreparedSpriteSheets& sheets);
+    /**
+     * Recolors a character's sprite sheet in every palette, without touching the renderer or the @c TextureAtlas ,
+     * so that it can run on any thread.
+     * @param name The name of the character.
+     * @param palettes The color schemes of the character, starting with the base palette.
+     * @return The sprite sheets, for @c CharacterRenderer::CharacterRenderer .
+     * @exception DataException Throws a @c DataException<int> when the sprite sheet cannot be wrapped or recolored, or any of the exceptions thrown by @c openCharacterPack .
+     */
+    static PreparedSpriteSheets prepare(const std::string& name, const std::vector<std::vector<SDL_Color>>& palettes);
+    /**
+     * Releases the textures of the sprite sheet.
+     */
+    ~CharacterRenderer();
+    /**
+     * Renders the character onto the screen as of the last call to @c Character::update .
+     * @param renderer The renderer to render on.
+     * @param character The character to draw.
+     * @exception DataException Throws a <c>DataException<unsigned int></c> when running into issues rendering the texture, and a <c>DataException<unsigned char></c> when running into issues rendering the boxes.
+     */
+    void render(SDL_Renderer*& renderer, Character& character);
+};
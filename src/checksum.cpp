@@ -0,0 +1,104 @@
+#include "checksum.hpp"
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+constexpr uint64_t prime1 = 0x9E3779B185EBCA87ULL; /**< The first prime of XXH64. */
+constexpr uint64_t prime2 = 0xC2B2AE3D27D4EB4FULL; /**< The second prime of XXH64. */
+constexpr uint64_t prime3 = 0x165667B19E3779F9ULL; /**< The third prime of XXH64. */
+constexpr uint64_t prime4 = 0x85EBCA77C2B2AE63ULL; /**< The fourth prime of XXH64. */
+constexpr uint64_t prime5 = 0x27D4EB2F165667C5ULL; /**< The fifth prime of XXH64. */
+
+/**
+ * Reads 8 bytes as a little-endian number.
+ * @param bytes Where to read.
+ * @return The number.
+ */
+static inline uint64_t read64(const uint8_t* bytes) {
+    uint64_t value;
+    std::memcpy(&value, bytes, sizeof(value));
+    return value;
+}
+
+/**
+ * Reads 4 bytes as a little-endian number.
+ * @param bytes Where to read.
+ * @return The number.
+ */
+static inline uint32_t read32(const uint8_t* bytes) {
+    uint32_t value;
+    std::memcpy(&value, bytes, sizeof(value));
+    return value;
+}
+
+/**
+ * Mixes 8 bytes into one lane.
+ * @param lane The lane.
+ * @param input The bytes.
+ * @return The new lane.
+ */
+static inline uint64_t mixLane(uint64_t lane, const uint64_t input) {
+    lane += input * prime2;
+    lane = std::rotl(lane, 31);
+    return lane * prime1;
+}
+
+/**
+ * Mixes a lane into the checksum.
+ * @param hash The checksum so far.
+ * @param lane The lane.
+ * @return The new checksum.
+ */
+static inline uint64_t mergeRound(uint64_t hash, const uint64_t lane) {
+    hash ^= mixLane(0U, lane);
+    return hash * prime1 + prime4;
+}
+
+uint64_t checksum64(const std::span<const uint8_t> bytes, const uint64_t seed) {
+    const uint8_t* position = bytes.data();
+    const uint8_t* const end = position + bytes.size();
+    uint64_t hash;
+    if (bytes.size() >= 32UZ) {
+        uint64_t lane1 = seed + prime1 + prime2;
+        uint64_t lane2 = seed + prime2;
+        uint64_t lane3 = seed;
+        uint64_t lane4 = seed - prime1;
+        const uint8_t* const lastStripe = end - 32;
+        do {
+            lane1 = mixLane(lane1, read64(position));
+            lane2 = mixLane(lane2, read64(position + 8));
+            lane3 = mixLane(lane3, read64(position + 16));
+            lane4 = mixLane(lane4, read64(position + 24));
+            position += 32;
+        } while (position <= lastStripe);
+        hash = std::rotl(lane1, 1) + std::rotl(lane2, 7) + std::rotl(lane3, 12) + std::rotl(lane4, 18);
+        hash = mergeRound(hash, lane1);
+        hash = mergeRound(hash, lane2);
+        hash = mergeRound(hash, lane3);
+        hash = mergeRound(hash, lane4);
+    } else {
+        hash = seed + prime5;
+    }
+    hash += bytes.size();
+    for (; position + 8 <= end; position += 8) {
+        hash ^= mixLane(0U, read64(position));
+        hash = std::rotl(hash, 27) * prime1 + prime4;
+    }
+    if (position + 4 <= end) {
+        hash ^= static_cast<uint64_t>(read32(position)) * prime1;
+        hash = std::rotl(hash, 23) * prime2 + prime3;
+        position += 4;
+    }
+    for (; position < end; ++position) {
+        hash ^= *position * prime5;
+        hash = std::rotl(hash, 11) * prime1;
+    }
+    hash ^= hash >> 33;
+    hash *= prime2;
+    hash ^= hash >> 29;
+    hash *= prime3;
+    hash ^= hash >> 32;
+    return hash;
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+/**
+ * Computes a 64-bit checksum with the XXH64 algorithm. Bytes are read in four independent 8-byte lanes, which
+ * compilers can keep in registers and vectorize, so it runs at close to memory bandwidth.
+ * @param bytes The bytes to checksum.
+ * @param seed Changes the result, for checksums that must not collide with other kinds of data.
+ * @return The checksum, the same as the reference XXH64 implementation on little-endian machines.
+ */
+uint64_t checksum64(std::span<const uint8_t> bytes, uint64_t seed = 0U);
@@ -1,7 +1,16 @@
 #include "command_input_parser.hpp"
 
+#include "gamepad_poller.hpp"
 #include "input_history.hpp"
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <random>
+#include <utility>
+#include <vector>
+
 #include <SDL3/SDL.h>
 
 BaseCommandInputParser::BaseCommandInputParser(const bool verticalSOCDIsUp,
@@ -63,6 +72,70 @@ void BaseCommandInputParser::updateInput() {
     this->down = SDL_GetKeyboardState(nullptr)[this->downKey];
 }
 
+void BaseCommandInputParser::queueInput(const Uint64 timestamp, const InputControl control, const bool pressed) {
+    this->pendingInputs.push_back(InputEvent(timestamp, control, pressed));
+}
+
+void BaseCommandInputParser::handleEvent(const SDL_Event& event) {
+    if ((event.type != SDL_EVENT_KEY_DOWN && event.type != SDL_EVENT_KEY_UP) || event.key.repeat) {
+        return;
+    }
+    const std::array<SDL_Scancode, 8> keys = {this->leftKey, this->rightKey, this->upKey, this->downKey,
+        this->lightPunchKey, this->heavyPunchKey, this->lightKickKey, this->heavyKickKey};
+    for (size_t control = 0UZ; control < keys.size(); ++control) {
+        if (keys[control] != SDL_SCANCODE_COUNT && event.key.scancode == keys[control]) {
+            this->queueInput(event.key.timestamp, static_cast<InputControl>(control), event.key.down);
+        }
+    }
+}
+
+void BaseCommandInputParser::collectInputs() {}
+
+void BaseCommandInputParser::sampleInput(const Uint64 timestamp) {
+    this->collectInputs();
+    Uint64 oldestChange = timestamp;
+    bool changed = false;
+    size_t applied = 0UZ;
+    // Events are queued in the order they happened, so the ones due by this tick come first.
+    for (; applied < this->pendingInputs.size() && this->pendingInputs[applied].timestamp <= timestamp; ++applied) {
+        const InputEvent& input = this->pendingInputs[applied];
+        const uint16_t control = static_cast<uint16_t>(1U << input.control);
+        if (input.pressed == ((this->heldControls & control) != 0U)) {
+            continue;
+        }
+        if (input.pressed) {
+            this->heldControls |= control;
+            this->pressedControls |= control;
+        } else {
+            this->heldControls &= static_cast<uint16_t>(~control);
+        }
+        oldestChange = std::min(oldestChange, input.timestamp);
+        changed = true;
+    }
+    this->pendingInputs.erase(this->pendingInputs.begin(), this->pendingInputs.begin() + static_cast<std::ptrdiff_t>(applied));
+    this->inputTimestamp = changed ? oldestChange : 0U;
+    this->inputLatency = timestamp - oldestChange;
+
+    const uint16_t sampled = this->heldControls | this->pressedControls;
+    const auto isSampled = [sampled](const InputControl control) { return (sampled & (1U << control)) != 0U; };
+    this->left = isSampled(LEFT_CONTROL) || isSampled(STICK_LEFT_CONTROL);
+    this->right = isSampled(RIGHT_CONTROL) || isSampled(STICK_RIGHT_CONTROL);
+    this->up = isSampled(UP_CONTROL) || isSampled(STICK_UP_CONTROL);
+    this->down = isSampled(DOWN_CONTROL) || isSampled(STICK_DOWN_CONTROL);
+    const auto sampleButton = [this, isSampled](const InputControl control, const bool current) {
+        return (this->pressedControls & (1U << control)) != 0U || (current && isSampled(control));
+    };
+    this->buttons.setLightPunch(sampleButton(LIGHT_PUNCH_CONTROL, this->buttons.getLightPunch()));
+    this->buttons.setHeavyPunch(sampleButton(HEAVY_PUNCH_CONTROL, this->buttons.getHeavyPunch()));
+    this->buttons.setLightKick(sampleButton(LIGHT_KICK_CONTROL, this->buttons.getLightKick()));
+    this->buttons.setHeavyKick(sampleButton(HEAVY_KICK_CONTROL, this->buttons.getHeavyKick()));
+    this->pressedControls = 0U;
+}
+
+Uint64 BaseCommandInputParser::getInputLatency() const { return this->inputLatency; }
+
+Uint64 BaseCommandInputParser::getInputTimestamp() const { return this->inputTimestamp; }
+
 ButtonGroup& BaseCommandInputParser::getButton() { return this->buttons; }
 
 void BaseCommandInputParser::setButtons() {
@@ -90,7 +163,14 @@ bool BaseCommandInputParser::getDown() const { return this->down; }
 
 void BaseCommandInputParser::setDown(const bool newDown) { this->down = newDown; }
 
-InputHistory BaseCommandInputParser::updateRecentInputs() {
+void BaseCommandInputParser::setDirection(const Direction direction) {
+    this->left = direction == DOWN_BACK || direction == BACK || direction == UP_BACK;
+    this->right = direction == DOWN_FORWARD || direction == FORWARD || direction == UP_FORWARD;
+    this->up = direction == UP_BACK || direction == UP || direction == UP_FORWARD;
+    this->down = direction == DOWN_BACK || direction == DOWN || direction == DOWN_FORWARD;
+}
+
+const InputHistory& BaseCommandInputParser::updateRecentInputs() {
     Direction mostRecentDirection = this->inputToDirection();
     ButtonGroup currentButton = this->getButton();
     this->recentInputs.addEntry(InputHistoryEntry(mostRecentDirection, currentButton));
@@ -160,6 +240,67 @@ Direction ControllerCommandInputParser::inputToDirection() {
     }
 }
 
+void ControllerCommandInputParser::handleEvent(const SDL_Event& event) {
+    if (this->poller != nullptr) {
+        return;
+    }
+    switch (event.type) {
+        case SDL_EVENT_GAMEPAD_AXIS_MOTION:
+            if (event.gaxis.which != SDL_GetGamepadID(this->controller)) {
+                return;
+            }
+            if (event.gaxis.axis == SDL_GAMEPAD_AXIS_LEFTX) {
+                this->queueInput(event.gaxis.timestamp, STICK_LEFT_CONTROL, event.gaxis.value <= thresholdNegative);
+                this->queueInput(event.gaxis.timestamp, STICK_RIGHT_CONTROL, event.gaxis.value >= thresholdPositive);
+            } else if (event.gaxis.axis == SDL_GAMEPAD_AXIS_LEFTY) {
+                this->queueInput(event.gaxis.timestamp, STICK_UP_CONTROL, event.gaxis.value <= thresholdNegative);
+                this->queueInput(event.gaxis.timestamp, STICK_DOWN_CONTROL, event.gaxis.value >= thresholdPositive);
+            }
+            break;
+        case SDL_EVENT_GAMEPAD_BUTTON_DOWN:
+        case SDL_EVENT_GAMEPAD_BUTTON_UP: {
+            if (event.gbutton.which != SDL_GetGamepadID(this->controller)) {
+                return;
+            }
+            const std::array<int, 8> buttons = {SDL_GAMEPAD_BUTTON_DPAD_LEFT, SDL_GAMEPAD_BUTTON_DPAD_RIGHT,
+                SDL_GAMEPAD_BUTTON_DPAD_UP, SDL_GAMEPAD_BUTTON_DPAD_DOWN,
+                this->lightPunchButton, this->heavyPunchButton, this->lightKickButton, this->heavyKickButton};
+            for (size_t control = 0UZ; control < buttons.size(); ++control) {
+                if (buttons[control] != SDL_GAMEPAD_BUTTON_INVALID && event.gbutton.button == buttons[control]) {
+                    this->queueInput(event.gbutton.timestamp, static_cast<InputControl>(control), event.gbutton.down);
+                }
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void ControllerCommandInputParser::setPoller(GamepadPoller* const poller) { this->poller = poller; }
+
+void ControllerCommandInputParser::collectInputs() {
+    if (this->poller == nullptr) {
+        return;
+    }
+    const std::array<int, 8> buttons = {SDL_GAMEPAD_BUTTON_DPAD_LEFT, SDL_GAMEPAD_BUTTON_DPAD_RIGHT,
+        SDL_GAMEPAD_BUTTON_DPAD_UP, SDL_GAMEPAD_BUTTON_DPAD_DOWN,
+        this->lightPunchButton, this->heavyPunchButton, this->lightKickButton, this->heavyKickButton};
+    GamepadSample sample;
+    while (this->poller->takeSample(sample)) {
+        // Every control is queued, and the ones that did not change are skipped when they are applied.
+        for (size_t control = 0UZ; control < buttons.size(); ++control) {
+            if (buttons[control] != SDL_GAMEPAD_BUTTON_INVALID) {
+                this->queueInput(sample.timestamp, static_cast<InputControl>(control), (sample.buttons & (1U << buttons[control])) != 0U);
+            }
+        }
+        this->queueInput(sample.timestamp, STICK_LEFT_CONTROL, sample.stickLeft);
+        this->queueInput(sample.timestamp, STICK_RIGHT_CONTROL, sample.stickRight);
+        this->queueInput(sample.timestamp, STICK_UP_CONTROL, sample.stickUp);
+        this->queueInput(sample.timestamp, STICK_DOWN_CONTROL, sample.stickDown);
+    }
+}
+
 void ControllerCommandInputParser::updateInput() {
     this->left = SDL_GetGamepadAxis(this->controller, SDL_GAMEPAD_AXIS_LEFTX) <= thresholdNegative || SDL_GetGamepadButton(this->controller, SDL_GAMEPAD_BUTTON_DPAD_LEFT);
     this->right = SDL_GetGamepadAxis(this->controller, SDL_GAMEPAD_AXIS_LEFTX) >= thresholdPositive || SDL_GetGamepadButton(this->controller, SDL_GAMEPAD_BUTTON_DPAD_RIGHT);
@@ -173,3 +314,100 @@ void ControllerCommandInputParser::setButtons() {
     this->buttons.setLightKick(SDL_GetGamepadButton(this->controller, this->lightKickButton));
     this->buttons.setHeavyKick(SDL_GetGamepadButton(this->controller, this->heavyKickButton));
 }
+
+ScriptedCommandInputParser::ScriptedCommandInputParser(std::vector<InputHistoryEntry> script,
+                                                       const bool loop,
+                                                       const bool verticalSOCDIsUp)
+    : BaseCommandInputParser(verticalSOCDIsUp,
+                             SDL_SCANCODE_COUNT,
+                             SDL_SCANCODE_COUNT,
+                             SDL_SCANCODE_COUNT,
+                             SDL_SCANCODE_COUNT,
+                             SDL_SCANCODE_COUNT,
+                             SDL_SCANCODE_COUNT,
+                             SDL_SCANCODE_COUNT,
+                             SDL_SCANCODE_COUNT),
+      script{std::move(script)},
+      loop{loop} {}
+
+void ScriptedCommandInputParser::updateInput() {
+    if (this->position >= this->script.size()) {
+        if (!this->loop || this->script.empty()) {
+            this->setDirection(NEUTRAL);
+            this->buttons = ButtonGroup();
+            return;
+        }
+        this->position = 0UZ;
+    }
+    const InputHistoryEntry& entry = this->script[this->position];
+    this->setDirection(entry.getDirection());
+    this->buttons = entry.getButton();
+    if (this->elapsed >= entry.getDuration()) {
+        ++this->position;
+        this->elapsed = 0U;
+    } else {
+        ++this->elapsed;
+    }
+}
+
+void ScriptedCommandInputParser::setButtons() {}
+
+bool ScriptedCommandInputParser::finished() const {
+    return !this->loop && this->position >= this->script.size();
+}
+
+RandomCommandInputParser::RandomCommandInputParser(const uint_fast32_t seed,
+                                                   const unsigned short maxHold,
+                                                   const bool verticalSOCDIsUp)
+    : BaseCommandInputParser(verticalSOCDIsUp,
+                             SDL_SCANCODE_COUNT,
+                             SDL_SCANCODE_COUNT,
+                             SDL_SCANCODE_COUNT,
+                             SDL_SCANCODE_COUNT,
+                             SDL_SCANCODE_COUNT,
+                             SDL_SCANCODE_COUNT,
+                             SDL_SCANCODE_COUNT,
+                             SDL_SCANCODE_COUNT),
+      generator{seed},
+      maxHold{maxHold} {
+    this->setDirection(NEUTRAL);
+}
+
+void RandomCommandInputParser::updateInput() {
+    if (this->remaining > 0U) {
+        --this->remaining;
+        return;
+    }
+    std::uniform_int_distribution<int> direction(DOWN_BACK, UP_FORWARD);
+    std::uniform_int_distribution<int> bitfield(0x0, 0xF);
+    std::uniform_int_distribution<int> pressChance(0, 3);
+    std::uniform_int_distribution<int> hold(0, this->maxHold);
+    this->setDirection(static_cast<Direction>(direction(this->generator)));
+    // Mostly move around, and only press buttons a quarter of the time.
+    this->buttons = ButtonGroup(static_cast<unsigned char>(pressChance(this->generator) == 0 ? bitfield(this->generator) : 0x0));
+    this->remaining = static_cast<unsigned short>(hold(this->generator));
+}
+
+void RandomCommandInputParser::setButtons() {}
+
+PackedCommandInputParser::PackedCommandInputParser(const bool verticalSOCDIsUp)
+    : BaseCommandInputParser(verticalSOCDIsUp,
+                             SDL_SCANCODE_COUNT,
+                             SDL_SCANCODE_COUNT,
+                             SDL_SCANCODE_COUNT,
+                             SDL_SCANCODE_COUNT,
+                             SDL_SCANCODE_COUNT,
+                             SDL_SCANCODE_COUNT,
+                             SDL_SCANCODE_COUNT,
+                             SDL_SCANCODE_COUNT) {
+    this->setInput(neutralInput);
+}
+
+void PackedCommandInputParser::setInput(const uint8_t input) {
+    this->setDirection(unpackDirection(input));
+    this->buttons = unpackButtons(input);
+}
+
+void PackedCommandInputParser::updateInput() {}
+
+void PackedCommandInputParser::setButtons() {}
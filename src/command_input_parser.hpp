@@ -2,8 +2,15 @@
 
 #include "input_history.hpp"
 
+#include <cstdint>
+#include <deque>
+#include <random>
+#include <vector>
+
 #include <SDL3/SDL.h>
 
+class GamepadPoller;
+
 /**
  * Determines how much of an analog stick input is needed to register a positive direction.
  */
@@ -13,6 +20,34 @@ constexpr short thresholdPositive = 15000;
  */
 constexpr short thresholdNegative = -1 * thresholdPositive;
 
+/**
+ * A control that an input event can press or release. Directions are kept apart from the stick's, so that the D-pad
+ * and the stick can be held at the same time.
+ */
+enum InputControl : uint8_t {
+    LEFT_CONTROL, /**< Left, from a key or the D-pad. */
+    RIGHT_CONTROL, /**< Right, from a key or the D-pad. */
+    UP_CONTROL, /**< Up, from a key or the D-pad. */
+    DOWN_CONTROL, /**< Down, from a key or the D-pad. */
+    LIGHT_PUNCH_CONTROL, /**< Light punch. */
+    HEAVY_PUNCH_CONTROL, /**< Heavy punch. */
+    LIGHT_KICK_CONTROL, /**< Light kick. */
+    HEAVY_KICK_CONTROL, /**< Heavy kick. */
+    STICK_LEFT_CONTROL, /**< Left, from the analog stick. */
+    STICK_RIGHT_CONTROL, /**< Right, from the analog stick. */
+    STICK_UP_CONTROL, /**< Up, from the analog stick. */
+    STICK_DOWN_CONTROL /**< Down, from the analog stick. */
+};
+
+/**
+ * A control pressed or released, waiting for the tick that it happened before.
+ */
+struct InputEvent {
+    Uint64 timestamp; /**< When the event happened, in nanoseconds (from the event's timestamp). */
+    InputControl control; /**< The control. */
+    bool pressed; /**< Whether the control was pressed (@c true) or released (@c false). */
+};
+
 /**
  * Base class for parsing inputs.
  */
@@ -26,7 +61,26 @@ protected:
     bool right; /**< Whether a right input is being sent. */
     bool up; /**< Whether an up input is being sent. */
     bool down; /**< Whether a down input is being sent. */
+
+    /**
+     * Queues a control being pressed or released, to be applied by the first tick sampled after it happened.
+     * @param timestamp When it happened, in nanoseconds (from the event's timestamp).
+     * @param control The control.
+     * @param pressed Whether the control was pressed (@c true) or released (@c false).
+     */
+    void queueInput(Uint64 timestamp, InputControl control, bool pressed);
+    /**
+     * Queues inputs from wherever else they come from, right before @c BaseCommandInputParser::sampleInput applies
+     * them. Does nothing by default, since inputs come from @c BaseCommandInputParser::handleEvent .
+     */
+    virtual void collectInputs();
 private:
+    std::deque<InputEvent> pendingInputs; /**< The events not yet applied by a tick, oldest first, taken from the front. */
+    uint16_t heldControls = 0U; /**< The controls held, with bit @c n for the @c InputControl @c n . */
+    uint16_t pressedControls = 0U; /**< The controls pressed since the last tick, even if they were let go since. */
+    Uint64 inputTimestamp = 0U; /**< When the oldest event applied by the last tick happened, 0 if none changed anything. */
+    Uint64 inputLatency = 0U; /**< How long the oldest event applied by the last tick waited for it, in nanoseconds. */
+
     const SDL_Scancode leftKey = SDL_SCANCODE_COUNT; /**< The key used for left inputs. */
     const SDL_Scancode rightKey = SDL_SCANCODE_COUNT; /**< The key used for right inputs. */
     const SDL_Scancode upKey = SDL_SCANCODE_COUNT; /**< The key used for up inputs. */
@@ -73,6 +127,35 @@ public:
      */
     virtual ~BaseCommandInputParser() = default;
 
+    /**
+     * Queues the input of an event, if it is one of this parser's keys. Meant to be called for every event, with the
+     * input applied by @c BaseCommandInputParser::sampleInput instead of reading the device's whole state.
+     * @param event The event.
+     */
+    virtual void handleEvent(const SDL_Event& event);
+    /**
+     * Applies every queued input that happened by the time of a tick, then sets the direction and buttons of the
+     * tick. Meant to be called once per tick, before the tick is simulated.
+     *
+     * A control pressed since the last tick counts as held for this tick even if it has been let go already, so that
+     * a tap between two ticks is never lost. A button only turns on when it is pressed, so that a button used up by
+     * an attack stays used up while it is held.
+     * @param timestamp The time of the tick, in nanoseconds (from @c SDL_GetTicksNS ).
+     */
+    void sampleInput(Uint64 timestamp);
+    /**
+     * Gets how long the input of the last tick waited for it.
+     * @return The time from the oldest event applied by the last @c BaseCommandInputParser::sampleInput to the tick,
+     * in nanoseconds, or 0 if no input changed.
+     */
+    Uint64 getInputLatency() const;
+    /**
+     * Gets when the input of the last tick happened.
+     * @return The timestamp of the oldest event applied by the last @c BaseCommandInputParser::sampleInput , in
+     * nanoseconds, or 0 if no input changed.
+     */
+    Uint64 getInputTimestamp() const;
+
     /**
      * Gets the current button inputs.
      * @return The buttons being held.
@@ -133,11 +216,17 @@ public:
      */
     void setDown(bool newDown);
 
+    /**
+     * Sets the left, right, up and down inputs to match a direction.
+     * @param direction The direction to hold.
+     */
+    void setDirection(Direction direction);
+
     /**
      * Updates the input history.
-     * @return The input history.
+     * @return The input history, without copying it.
      */
-    InputHistory updateRecentInputs();
+    const InputHistory& updateRecentInputs();
 };
 
 /**
@@ -149,6 +238,11 @@ private:
     SDL_GamepadButton heavyPunchButton = SDL_GAMEPAD_BUTTON_INVALID; /**< The button to use for heavy punch. */
     SDL_GamepadButton lightKickButton = SDL_GAMEPAD_BUTTON_INVALID; /**< The button to use for light kick. */
     SDL_GamepadButton heavyKickButton = SDL_GAMEPAD_BUTTON_INVALID; /**< The button to use for heavy kick. */
+    GamepadPoller* poller = nullptr; /**< The thread reading the controller, @c nullptr to read it from events. */
+    /**
+     * Queues the inputs of every change read by the poller since the last tick.
+     */
+    void collectInputs() override;
 public:
     /**
      * Creates a controller.
@@ -176,6 +270,17 @@ private:
      */
     Direction inputToDirection() override;
 public:
+    /**
+     * Queues the input of an event, if it comes from this parser's controller.
+     * @param event The event.
+     */
+    void handleEvent(const SDL_Event& event) override;
+    /**
+     * Reads the controller from a thread instead of from events, or goes back to events.
+     * @param poller The thread reading this parser's controller, which must outlive its use, or @c nullptr to read the
+     * controller from events.
+     */
+    void setPoller(GamepadPoller* poller);
     /**
      * Updates input based on controller buttons.
      */
@@ -185,3 +290,87 @@ public:
      */
     void setButtons() override;
 };
+
+/**
+ * An extension of @c BaseCommandInputParser that plays back a script of inputs instead of reading a device, for running matches without a player.
+ */
+class ScriptedCommandInputParser : public BaseCommandInputParser {
+private:
+    const std::vector<InputHistoryEntry> script; /**< The inputs to play back, in order. */
+    const bool loop; /**< Whether to start the script over once it ends (@c true) or stay neutral (@c false). */
+    size_t position = 0UZ; /**< The index of the current entry of the script. */
+    unsigned short elapsed = 0U; /**< How many frames of the current entry have been played. */
+public:
+    /**
+     * Creates a scripted command input parser.
+     * @param script The inputs to play back, for example from @c readInputScript .
+     * @param loop Whether to start the script over once it ends (@c true) or stay neutral (@c false).
+     * @param verticalSOCDIsUp Whether up+down is meant to be interpreted as up (@c true) or neutral (@c false).
+     */
+    explicit ScriptedCommandInputParser(std::vector<InputHistoryEntry> script, bool loop = true, bool verticalSOCDIsUp = true);
+    /**
+     * Plays back the next frame of the script. Meant to be called once per frame.
+     */
+    void updateInput() override;
+    /**
+     * Does nothing, since the buttons are set along with the direction by @c ScriptedCommandInputParser::updateInput .
+     */
+    void setButtons() override;
+    /**
+     * Checks whether the script has been played to the end.
+     * @return Whether every input has been played, which never happens when looping.
+     */
+    bool finished() const;
+};
+
+/**
+ * An extension of @c BaseCommandInputParser that mashes random inputs, for running matches between bots.
+ */
+class RandomCommandInputParser : public BaseCommandInputParser {
+private:
+    std::mt19937 generator; /**< The source of the inputs, seeded so that a match can be played again. */
+    const unsigned short maxHold; /**< The most frames to hold an input for after its first one. */
+    unsigned short remaining = 0U; /**< How many more frames to hold the current input for. */
+public:
+    /**
+     * Creates a random command input parser.
+     * @param seed The seed of the inputs. The same seed always gives the same inputs.
+     * @param maxHold The most frames to hold an input for after its first one.
+     * @param verticalSOCDIsUp Whether up+down is meant to be interpreted as up (@c true) or neutral (@c false).
+     */
+    explicit RandomCommandInputParser(uint_fast32_t seed, unsigned short maxHold = 20U, bool verticalSOCDIsUp = true);
+    /**
+     * Holds the current input, or picks a new direction, buttons and duration once it has been held long enough.
+     * Meant to be called once per frame.
+     */
+    void updateInput() override;
+    /**
+     * Does nothing, since the buttons are set along with the direction by @c RandomCommandInputParser::updateInput .
+     */
+    void setButtons() override;
+};
+
+/**
+ * An extension of @c BaseCommandInputParser whose inputs are handed to it one frame at a time, for netplay and replays.
+ */
+class PackedCommandInputParser : public BaseCommandInputParser {
+public:
+    /**
+     * Creates a packed command input parser holding nothing.
+     * @param verticalSOCDIsUp Whether up+down is meant to be interpreted as up (@c true) or neutral (@c false).
+     */
+    explicit PackedCommandInputParser(bool verticalSOCDIsUp = true);
+    /**
+     * Sets the input for the next frame.
+     * @param input The direction and buttons, from @c packInput .
+     */
+    void setInput(uint8_t input);
+    /**
+     * Does nothing, since the input is set by @c PackedCommandInputParser::setInput .
+     */
+    void updateInput() override;
+    /**
+     * Does nothing, since the buttons are set by @c PackedCommandInputParser::setInput .
+     */
+    void setButtons() override;
+};
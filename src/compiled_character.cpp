@@ -0,0 +1,297 @@
+#include "compiled_character.hpp"
+
+#include "animation_table.hpp"
+#include "character_container.hpp"
+#include "character_data.hpp"
+#include "data_exception.hpp"
+#include "scalar.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <SDL3/SDL.h>
+
+/**
+ * Rounds an offset up to the alignment of every section.
+ * @param offset The offset.
+ * @return The next aligned offset.
+ */
+static size_t alignSection(const size_t offset) {
+    return (offset + compiledCharacterAlignment - 1UZ) & ~(compiledCharacterAlignment - 1UZ);
+}
+
+CompiledCharacter::CompiledCharacter(const std::span<const std::byte> data) : data{data} {
+    if (data.size() < sizeof(CompiledHeader)) {
+        throw DataException<long>(std::string(__PRETTY_FUNCTION__) + " while reading header", std::string("Reached EOF"), static_cast<long>(data.size()));
+    }
+    if (reinterpret_cast<uintptr_t>(data.data()) % compiledCharacterAlignment != 0U) {
+        throw DataException<long>(std::string(__PRETTY_FUNCTION__) + " while reading header", std::string("Compiled character is not aligned"), static_cast<long>(reinterpret_cast<uintptr_t>(data.data()) % compiledCharacterAlignment));
+    }
+    this->header = reinterpret_cast<const CompiledHeader*>(data.data());
+    if (this->header->magic != compiledCharacterMagic) {
+        throw DataException<unsigned short>(std::string(__PRETTY_FUNCTION__) + " while checking header", std::string("Invalid header"), static_cast<unsigned short>(this->header->magic));
+    }
+    if (this->header->byteOrder != 0x01020304U) {
+        throw DataException<unsigned short>(std::string(__PRETTY_FUNCTION__) + " while checking byte order", std::string("Compiled for a CPU with another byte order"));
+    }
+    if (this->header->version != compiledCharacterVersion) {
+        throw DataException<unsigned short>(std::string(__PRETTY_FUNCTION__) + " while checking version", std::string("Compiled by another version of the asset compiler"), static_cast<unsigned short>(this->header->version));
+    }
+    if (this->header->scalarFormat != compiledScalarFormat) {
+        throw DataException<unsigned short>(std::string(__PRETTY_FUNCTION__) + " while checking scalar format", std::string("Compiled for a build with other physics numbers (FOSS_FIGHT_FIXED_POINT)"), static_cast<unsigned short>(this->header->scalarFormat));
+    }
+    if (this->header->fileSize > data.size()) {
+        throw DataException<long>(std::string(__PRETTY_FUNCTION__) + " while checking size", std::string("Reached EOF"), static_cast<long>(this->header->fileSize));
+    }
+    if (this->header->paletteCount == 0U || this->header->colorCount == 0U) {
+        throw DataException<unsigned short>(std::string(__PRETTY_FUNCTION__) + " while checking palettes", std::string("No colors"));
+    }
+    if (this->header->sheetFormat != SDL_PIXELFORMAT_RGBA32 || this->header->sheetPitch < this->header->sheetWidth * 4U) {
+        throw DataException<unsigned short>(std::string(__PRETTY_FUNCTION__) + " while checking sprite sheet", std::string("Sprite sheet is not RGBA32"), static_cast<unsigned short>(this->header->sheetFormat));
+    }
+    // Each section is checked once here, so that reading it in place never goes out of bounds.
+    this->section<SDL_Color>(this->header->paletteOffset, static_cast<size_t>(this->header->paletteCount) * this->header->colorCount);
+    this->section<CompiledAnimation>(this->header->animationOffset, this->header->animationCount);
+    this->section<CompiledSprite>(this->header->spriteOffset, this->header->spriteCount);
+    this->section<CompiledBox>(this->header->boxOffset, this->header->boxCount);
+    this->section<std::byte>(this->header->pixelOffset, static_cast<size_t>(this->header->sheetPitch) * this->header->sheetHeight);
+}
+
+template <typename T>
+std::span<const T> CompiledCharacter::section(const uint32_t offset, const size_t count) const {
+    if (offset % compiledCharacterAlignment != 0U
+        || offset > this->header->fileSize
+        || count > (this->header->fileSize - offset) / sizeof(T)) {
+        throw DataException<long>(std::string(__PRETTY_FUNCTION__) + " while finding section", std::string("Section does not fit in the compiled character"), static_cast<long>(offset));
+    }
+    return std::span<const T>(reinterpret_cast<const T*>(this->data.data() + offset), count);
+}
+
+const CompiledHeader& CompiledCharacter::getHeader() const {
+    return *this->header;
+}
+
+std::span<const SDL_Color> CompiledCharacter::getPalette(const size_t index) const {
+    if (index >= this->header->paletteCount) {
+        throw std::out_of_range(std::string("No palette ") + std::to_string(index) + " in compiled character");
+    }
+    return this->section<SDL_Color>(this->header->paletteOffset, static_cast<size_t>(this->header->paletteCount) * this->header->colorCount)
+        .subspan(index * this->header->colorCount, this->header->colorCount);
+}
+
+std::span<const CompiledAnimation> CompiledCharacter::getAnimations() const {
+    return this->section<CompiledAnimation>(this->header->animationOffset, this->header->animationCount);
+}
+
+std::span<const CompiledSprite> CompiledCharacter::getSprites() const {
+    return this->section<CompiledSprite>(this->header->spriteOffset, this->header->spriteCount);
+}
+
+std::span<const CompiledBox> CompiledCharacter::getBoxes() const {
+    return this->section<CompiledBox>(this->header->boxOffset, this->header->boxCount);
+}
+
+std::span<const std::byte> CompiledCharacter::getPixels() const {
+    return this->section<std::byte>(this->header->pixelOffset, static_cast<size_t>(this->header->sheetPitch) * this->header->sheetHeight);
+}
+
+/**
+ * Appends a section to compiled data, aligned to @c compiledCharacterAlignment .
+ * @tparam T The type of the records in the section.
+ * @param out The compiled data.
+ * @param records The records of the section.
+ * @return Where the section starts.
+ */
+template <typename T>
+static uint32_t appendSection(std::vector<std::byte>& out, const std::span<const T> records) {
+    const size_t offset = alignSection(out.size());
+    out.resize(offset + records.size_bytes());
+    if (!records.empty()) {
+        std::memcpy(out.data() + offset, records.data(), records.size_bytes());
+    }
+    return static_cast<uint32_t>(offset);
+}
+
+std::vector<std::byte> compileCharacter(const CharacterData& data, const SDL_Surface* spriteSheet) {
+    if (spriteSheet->format != SDL_PIXELFORMAT_RGBA32) {
+        throw DataException<unsigned short>(std::string(__PRETTY_FUNCTION__) + " while checking sprite sheet", std::string("Sprite sheet is not RGBA32"), static_cast<unsigned short>(spriteSheet->format));
+    }
+    if (!data.animations.contains(IDLE)) {
+        throw DataException<unsigned short>(std::string(__PRETTY_FUNCTION__) + " while checking animations", std::string("No idle animation"), IDLE);
+    }
+    if (data.palettes.empty() || data.palettes.front().empty()) {
+        throw DataException<unsigned short>(std::string(__PRETTY_FUNCTION__) + " while checking palettes", std::string("No colors"));
+    }
+    std::vector<SDL_Color> colors;
+    colors.reserve(data.palettes.size() * data.palettes.front().size());
+    for (size_t i = 0UZ; i < data.palettes.size(); ++i) {
+        if (data.palettes[i].size() != data.palettes.front().size()) {
+            throw DataException<unsigned short>(std::string(__PRETTY_FUNCTION__) + " while checking palettes", std::string("Palette has a different number of colors than the base palette"), static_cast<unsigned short>(i));
+        }
+        colors.insert(colors.end(), data.palettes[i].begin(), data.palettes[i].end());
+    }
+    std::vector<CompiledAnimation> animations;
+    std::vector<CompiledSprite> sprites;
+    std::vector<CompiledBox> boxes;
+    sprites.reserve(data.animations.allFrames().size());
+    for (const unsigned short type : data.animations.types()) {
+        const std::span<const Sprite> frames = data.animations.at(type);
+        animations.emplace_back(type, static_cast<uint16_t>(frames.size()), static_cast<uint32_t>(sprites.size()));
+        for (const Sprite& frame : frames) {
+            const SDL_FRect* area = frame.getSpriteSheetArea();
+            if (area->x < 0.0F || area->y < 0.0F
+                || area->x + area->w > static_cast<float>(spriteSheet->w)
+                || area->y + area->h > static_cast<float>(spriteSheet->h)) {
+                throw DataException<unsigned short>(std::string(__PRETTY_FUNCTION__) + " while checking sprite sheet area", std::string("Sprite is outside of the sprite sheet"), type);
+            }
+            if (frame.charBoxes.size() > UINT16_MAX) {
+                throw DataException<unsigned short>(std::string(__PRETTY_FUNCTION__) + " while checking boxes", std::string("Too many boxes in one sprite"), type);
+            }
+            sprites.emplace_back(*area, static_cast<uint32_t>(boxes.size()), static_cast<uint16_t>(frame.charBoxes.size()),
+                                 frame.getLength(), frame.xOffset, frame.yOffset, 0U);
+            for (const CharacterBox& box : frame.charBoxes) {
+                const HitboxProperties& properties = box.hitboxProperties;
+                boxes.emplace_back(box.rect, static_cast<uint16_t>(box.boxType),
+                                   properties.hitStun, properties.blockStun, properties.hitPushback, properties.blockPushback,
+                                   properties.xKnockback, properties.yKnockback, static_cast<uint16_t>(0U));
+            }
+        }
+    }
+    CompiledHeader header{};
+    header.magic = compiledCharacterMagic;
+    header.version = compiledCharacterVersion;
+    header.byteOrder = 0x01020304U;
+    header.scalarFormat = compiledScalarFormat;
+    header.stats = data.stats;
+    header.paletteCount = static_cast<uint32_t>(data.palettes.size());
+    header.colorCount = static_cast<uint32_t>(data.palettes.front().size());
+    header.animationCount = static_cast<uint32_t>(animations.size());
+    header.spriteCount = static_cast<uint32_t>(sprites.size());
+    header.boxCount = static_cast<uint32_t>(boxes.size());
+    header.sheetWidth = static_cast<uint32_t>(spriteSheet->w);
+    header.sheetHeight = static_cast<uint32_t>(spriteSheet->h);
+    header.sheetPitch = static_cast<uint32_t>(spriteSheet->w) * 4U;
+    header.sheetFormat = SDL_PIXELFORMAT_RGBA32;
+    std::vector<std::byte> out(sizeof(CompiledHeader));
+    header.paletteOffset = appendSection(out, std::span<const SDL_Color>(colors));
+    header.animationOffset = appendSection(out, std::span<const CompiledAnimation>(animations));
+    header.spriteOffset = appendSection(out, std::span<const CompiledSprite>(sprites));
+    header.boxOffset = appendSection(out, std::span<const CompiledBox>(boxes));
+    // The rows are packed, whatever padding the decoder left at the end of each of them.
+    header.pixelOffset = static_cast<uint32_t>(alignSection(out.size()));
+    out.resize(header.pixelOffset + static_cast<size_t>(header.sheetPitch) * header.sheetHeight);
+    for (uint32_t y = 0U; y < header.sheetHeight; ++y) {
+        std::memcpy(out.data() + header.pixelOffset + static_cast<size_t>(y) * header.sheetPitch,
+                    static_cast<const std::byte*>(spriteSheet->pixels) + static_cast<ptrdiff_t>(y) * spriteSheet->pitch,
+                    header.sheetPitch);
+    }
+    out.resize(alignSection(out.size()));
+    if (out.size() > UINT32_MAX) {
+        throw DataException<unsigned short>(std::string(__PRETTY_FUNCTION__) + " while checking size", std::string("Compiled character is larger than 4 GiB"));
+    }
+    header.fileSize = static_cast<uint32_t>(out.size());
+    std::memcpy(out.data(), &header, sizeof(CompiledHeader));
+    return out;
+}
+
+CompiledRecords CompiledCharacter::getRecords() const {
+    return CompiledRecords(this->header->stats,
+                           this->header->paletteCount,
+                           this->header->colorCount,
+                           this->section<SDL_Color>(this->header->paletteOffset, static_cast<size_t>(this->header->paletteCount) * this->header->colorCount),
+                           this->getAnimations(),
+                           this->getSprites(),
+                           this->getBoxes());
+}
+
+/**
+ * Reads the sprites of one animation of a compiled character.
+ * @param records The records of the character.
+ * @param animation The animation.
+ * @return The sprites, with their boxes.
+ * @exception DataException Throws a @c DataException<long> when the animation refers to sprites or boxes that do not exist.
+ */
+static std::vector<Sprite> readCompiledAnimation(const CompiledRecords& records, const CompiledAnimation& animation) {
+    const std::span<const CompiledSprite> sprites = records.sprites;
+    const std::span<const CompiledBox> boxes = records.boxes;
+    if (animation.firstSprite > sprites.size() || animation.frameCount > sprites.size() - animation.firstSprite) {
+        throw DataException<long>(std::string(__PRETTY_FUNCTION__) + " while reading animation", std::string("Animation refers to sprites that do not exist"), static_cast<long>(animation.type));
+    }
+    std::vector<Sprite> frames;
+    frames.reserve(animation.frameCount);
+    for (const CompiledSprite& sprite : sprites.subspan(animation.firstSprite, animation.frameCount)) {
+        if (sprite.firstBox > boxes.size() || sprite.boxCount > boxes.size() - sprite.firstBox) {
+            throw DataException<long>(std::string(__PRETTY_FUNCTION__) + " while reading sprite", std::string("Sprite refers to boxes that do not exist"), static_cast<long>(sprite.firstBox));
+        }
+        std::vector<CharacterBox> charBoxes;
+        charBoxes.reserve(sprite.boxCount);
+        for (const CompiledBox& box : boxes.subspan(sprite.firstBox, sprite.boxCount)) {
+            const BoxType type = static_cast<BoxType>(box.boxType);
+            HitboxProperties properties;
+            if (type >= HITBOX_BEGIN && type <= HITBOX_END) {
+                properties = HitboxProperties(static_cast<uint8_t>(type % 256));
+            }
+            properties.hitStun = box.hitStun;
+            properties.blockStun = box.blockStun;
+            properties.hitPushback = box.hitPushback;
+            properties.blockPushback = box.blockPushback;
+            properties.xKnockback = box.xKnockback;
+            properties.yKnockback = box.yKnockback;
+            charBoxes.emplace_back(type, properties, box.rect);
+        }
+        frames.emplace_back(sprite.length, sprite.spriteSheetArea, sprite.xOffset, sprite.yOffset, std::move(charBoxes));
+    }
+    return frames;
+}
+
+DeferredAnimations::DeferredAnimations(const CompiledRecords& records, std::shared_ptr<const void> owner) :
+    records{records}, owner{std::move(owner)} {}
+
+std::vector<Sprite> DeferredAnimations::read(const unsigned short type) const {
+    const auto it = std::ranges::lower_bound(this->records.animations, type, {}, &CompiledAnimation::type);
+    if (it == this->records.animations.end() || it->type != type || !isRarelyUsedAnimation(type)) {
+        return std::vector<Sprite>();
+    }
+    return readCompiledAnimation(this->records, *it);
+}
+
+CharacterData readCompiledRecords(const CompiledRecords& records, const bool includeRarelyUsed, std::shared_ptr<const void> owner) {
+    CharacterData data;
+    data.stats = records.stats;
+    if (records.colors.size() != static_cast<size_t>(records.paletteCount) * records.colorCount) {
+        throw DataException<long>(std::string(__PRETTY_FUNCTION__) + " while reading palettes", std::string("Palettes do not have as many colors as they should"), static_cast<long>(records.colors.size()));
+    }
+    data.palettes.reserve(records.paletteCount);
+    for (size_t i = 0UZ; i < records.paletteCount; ++i) {
+        const std::span<const SDL_Color> colors = records.colors.subspan(i * records.colorCount, records.colorCount);
+        data.palettes.emplace_back(colors.begin(), colors.end());
+    }
+    // The animations are already sorted, so they go straight into the table without being grouped first. Room is made
+    // for every sprite, so that adding a deferred animation to this table later does not have to reallocate it.
+    data.animations.reserve(records.sprites.size());
+    for (const CompiledAnimation& animation : records.animations) {
+        if (!includeRarelyUsed && isRarelyUsedAnimation(animation.type)) {
+            if (data.deferred == nullptr) {
+                data.deferred = std::make_shared<const DeferredAnimations>(records, owner);
+            }
+            continue;
+        }
+        if (data.animations.contains(animation.type)) {
+            throw DataException<long>(std::string(__PRETTY_FUNCTION__) + " while reading animation", std::string("Animation is stored twice"), static_cast<long>(animation.type));
+        }
+        data.animations.add(animation.type, readCompiledAnimation(records, animation));
+    }
+    return data;
+}
+
+CharacterData readCompiledCharacter(const CompiledCharacter& compiled, const bool includeRarelyUsed, std::shared_ptr<const void> owner) {
+    return readCompiledRecords(compiled.getRecords(), includeRarelyUsed, std::move(owner));
+}
@@ -0,0 +1,233 @@
+#pragma once
+
+#include "character_data.hpp"
+#include "scalar.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include <SDL3/SDL.h>
+
+/**
+ * The first bytes of a compiled character, @c FFC followed by a 0.
+ */
+constexpr uint32_t compiledCharacterMagic = 0x00434646U;
+
+/**
+ * The version of the compiled character layout, which changes whenever the layout does.
+ */
+constexpr uint32_t compiledCharacterVersion = 1U;
+
+/**
+ * The alignment of every section of a compiled character, from the start of the data.
+ */
+constexpr size_t compiledCharacterAlignment = 16UZ;
+
+/**
+ * The kind of number that the boxes of a compiled character are stored in, which must match the game's @c Scalar .
+ */
+constexpr uint32_t compiledScalarFormat = FOSS_FIGHT_FIXED_POINT ? 1U : 0U;
+
+/**
+ * The header at the start of a compiled character. Every offset is in bytes from the start of the header, and every
+ * number is stored in the CPU's byte order, which the asset compiler and the game share.
+ */
+struct CompiledHeader {
+    uint32_t magic; /**< Always @c compiledCharacterMagic . */
+    uint32_t version; /**< Always @c compiledCharacterVersion . */
+    uint32_t byteOrder; /**< @c 0x01020304 , which reads differently on a CPU with another byte order. */
+    uint32_t scalarFormat; /**< @c compiledScalarFormat of the asset compiler. */
+    uint32_t fileSize; /**< The size of the whole compiled character. */
+    CharacterStats stats; /**< The stats of the character. */
+    uint32_t paletteCount; /**< How many palettes the character has. */
+    uint32_t colorCount; /**< How many colors each palette has. */
+    uint32_t paletteOffset; /**< Where the colors of every palette are, back to back, as @c SDL_Color . */
+    uint32_t animationCount; /**< How many animations the character has. */
+    uint32_t animationOffset; /**< Where the @c CompiledAnimation records are, sorted by type. */
+    uint32_t spriteCount; /**< How many sprites all the animations have. */
+    uint32_t spriteOffset; /**< Where the @c CompiledSprite records are. */
+    uint32_t boxCount; /**< How many boxes all the sprites have. */
+    uint32_t boxOffset; /**< Where the @c CompiledBox records are. */
+    uint32_t sheetWidth; /**< The width of the sprite sheet in pixels. */
+    uint32_t sheetHeight; /**< The height of the sprite sheet in pixels. */
+    uint32_t sheetPitch; /**< The bytes between the start of two rows of the sprite sheet. */
+    uint32_t sheetFormat; /**< The @c SDL_PixelFormat of the sprite sheet, always @c SDL_PIXELFORMAT_RGBA32 . */
+    uint32_t pixelOffset; /**< Where the pixels of the sprite sheet are, ready to be uploaded. */
+};
+
+/**
+ * An animation of a compiled character.
+ */
+struct CompiledAnimation {
+    uint16_t type; /**< The @c AnimationType . */
+    uint16_t frameCount; /**< How many sprites the animation has. */
+    uint32_t firstSprite; /**< The index of the animation's first sprite. */
+};
+
+/**
+ * A sprite of a compiled character, with any copied data already resolved.
+ */
+struct CompiledSprite {
+    SDL_FRect spriteSheetArea; /**< The area of the sprite sheet where the sprite's image is located. */
+    uint32_t firstBox; /**< The index of the sprite's first box. */
+    uint16_t boxCount; /**< How many boxes the sprite has. */
+    uint16_t length; /**< How many frames (1/60 of a second) to show the sprite for. */
+    int16_t xOffset; /**< The horizontal offset of the sprite. */
+    int16_t yOffset; /**< The vertical offset of the sprite. */
+    uint32_t reserved; /**< Always 0. */
+};
+
+/**
+ * A box of a compiled character, already scaled to the character's size.
+ */
+struct CompiledBox {
+    ScalarRect rect; /**< The box, relative to the top-left corner of the character. */
+    uint16_t boxType; /**< The @c BoxType , whose low byte holds the properties of a hitbox. */
+    uint16_t hitStun; /**< The hit stun of a hitbox. */
+    uint16_t blockStun; /**< The block stun of a hitbox. */
+    int16_t hitPushback; /**< The pushback on hit of a hitbox. */
+    int16_t blockPushback; /**< The pushback on block of a hitbox. */
+    uint16_t xKnockback; /**< The x-velocity of a hitbox's knockdown. */
+    int16_t yKnockback; /**< The y-velocity of a hitbox's knockdown. */
+    uint16_t reserved; /**< Always 0. */
+};
+
+/**
+ * The records of a compiled character, wherever they are stored.
+ */
+struct CompiledRecords {
+    CharacterStats stats; /**< The stats of the character. */
+    uint32_t paletteCount; /**< How many palettes the character has. */
+    uint32_t colorCount; /**< How many colors each palette has. */
+    std::span<const SDL_Color> colors; /**< The colors of every palette, back to back. */
+    std::span<const CompiledAnimation> animations; /**< The animations, sorted by type. */
+    std::span<const CompiledSprite> sprites; /**< The sprites of every animation, back to back. */
+    std::span<const CompiledBox> boxes; /**< The boxes of every sprite, back to back. */
+};
+
+static_assert(std::is_trivially_copyable_v<CompiledHeader> && sizeof(CompiledHeader) == 104UZ, "CompiledHeader must have no padding");
+static_assert(std::is_trivially_copyable_v<CompiledAnimation> && sizeof(CompiledAnimation) == 8UZ, "CompiledAnimation must have no padding");
+static_assert(std::is_trivially_copyable_v<CompiledSprite> && sizeof(CompiledSprite) == 32UZ, "CompiledSprite must have no padding");
+static_assert(std::is_trivially_copyable_v<CompiledBox> && sizeof(CompiledBox) == 32UZ, "CompiledBox must have no padding");
+
+/**
+ * A character compiled by @c foss-fight-asset-compiler , read in place. Nothing is copied or converted: the sections are
+ * checked to be within the data once, then handed out as they are.
+ */
+class CompiledCharacter {
+private:
+    std::span<const std::byte> data; /**< The whole compiled character. */
+    const CompiledHeader* header; /**< The header at the start of @c CompiledCharacter::data . */
+    /**
+     * Gets a section of the data as an array.
+     * @tparam T The type of the records in the section.
+     * @param offset Where the section starts.
+     * @param count How many records it has.
+     * @return The records.
+     */
+    template <typename T>
+    std::span<const T> section(uint32_t offset, size_t count) const;
+public:
+    /**
+     * Checks compiled data and reads it in place.
+     * @param data The compiled character, aligned to @c compiledCharacterAlignment , which must outlive this object.
+     * @exception DataException Throws a <c>DataException<unsigned short></c> when the data is not a compiled character of this build, and a @c DataException<long> when a section does not fit in the data.
+     */
+    explicit CompiledCharacter(std::span<const std::byte> data);
+    /**
+     * Gets the header.
+     * @return The header, with the stats and the sprite sheet's dimensions.
+     */
+    const CompiledHeader& getHeader() const;
+    /**
+     * Gets the colors of one palette.
+     * @param index The index of the palette, where 0 is the base palette.
+     * @return The colors.
+     * @exception std::out_of_range There is no such palette.
+     */
+    std::span<const SDL_Color> getPalette(size_t index) const;
+    /**
+     * Gets every animation.
+     * @return The animations, sorted by type.
+     */
+    std::span<const CompiledAnimation> getAnimations() const;
+    /**
+     * Gets every sprite of every animation.
+     * @return The sprites, back to back.
+     */
+    std::span<const CompiledSprite> getSprites() const;
+    /**
+     * Gets every box of every sprite.
+     * @return The boxes, back to back.
+     */
+    std::span<const CompiledBox> getBoxes() const;
+    /**
+     * Gets the pixels of the sprite sheet.
+     * @return The pixels, @c CompiledHeader::sheetPitch bytes per row.
+     */
+    std::span<const std::byte> getPixels() const;
+    /**
+     * Gets every record of the character.
+     * @return The stats, palettes, animations, sprites and boxes.
+     */
+    CompiledRecords getRecords() const;
+};
+
+/**
+ * Compiles a character into the layout read by @c CompiledCharacter .
+ * @param data The character's data, as read by @c readCharacterData .
+ * @param spriteSheet The sprite sheet, in @c SDL_PIXELFORMAT_RGBA32 .
+ * @return The compiled character.
+ * @exception DataException Throws a <c>DataException<unsigned short></c> when the data cannot be used by the game, such as a character without an idle animation, palettes of different sizes or a sprite outside of the sprite sheet.
+ */
+std::vector<std::byte> compileCharacter(const CharacterData& data, const SDL_Surface* spriteSheet);
+
+/**
+ * The animations of a compiled character that were left out of its data because @c isRarelyUsedAnimation is @c true
+ * for them, read from its records the first time that they are used.
+ */
+class DeferredAnimations {
+private:
+    CompiledRecords records; /**< The records of the character. */
+    std::shared_ptr<const void> owner; /**< Keeps the records mapped, @c nullptr when they live as long as the game. */
+public:
+    /**
+     * Keeps the records of a character to read its rarely used animations from.
+     * @param records The records of the character.
+     * @param owner What the records are stored in, kept alive as long as this object, or @c nullptr if they live as long as the game.
+     */
+    DeferredAnimations(const CompiledRecords& records, std::shared_ptr<const void> owner);
+    /**
+     * Reads a rarely used animation.
+     * @param type The @c AnimationType .
+     * @return The sprites, empty if the character has no such animation or if it is not a rarely used one.
+     * @exception DataException Throws a @c DataException<long> when the animation refers to sprites or boxes that do not exist.
+     */
+    std::vector<Sprite> read(unsigned short type) const;
+};
+
+/**
+ * Turns the records of a compiled character into the data that a @c Character is made of. This copies each sprite and
+ * its boxes into the animation table, which is the only work done per sprite when a character is loaded, so that a
+ * @c Character is made of the same data however it was loaded.
+ * @param records The records.
+ * @param includeRarelyUsed Whether to read the animations for which @c isRarelyUsedAnimation is @c true now, rather than leaving them to @c CharacterData::deferred .
+ * @param owner What the records are stored in, which @c CharacterData::deferred keeps alive, or @c nullptr if they live as long as the game.
+ * @return The character's data.
+ * @exception DataException Throws a @c DataException<long> when a sprite or an animation refers to records that do not exist.
+ */
+CharacterData readCompiledRecords(const CompiledRecords& records, bool includeRarelyUsed = true, std::shared_ptr<const void> owner = nullptr);
+
+/**
+ * Turns a compiled character back into the data that a @c Character is made of.
+ * @param compiled The compiled character.
+ * @param includeRarelyUsed Whether to read the animations for which @c isRarelyUsedAnimation is @c true now, rather than leaving them to @c CharacterData::deferred .
+ * @param owner What the compiled character is stored in, which @c CharacterData::deferred keeps alive.
+ * @return The character's data.
+ * @exception DataException Throws a @c DataException<long> when a sprite or an animation refers to records that do not exist.
+ */
+CharacterData readCompiledCharacter(const CompiledCharacter& compiled, bool includeRarelyUsed = true, std::shared_ptr<const void> owner = nullptr);
@@ -0,0 +1,482 @@
+#pragma once
+
+#include "character_container.hpp"
+#include "character_data.hpp"
+#include "compiled_character.hpp"
+#include "packbits.hpp"
+#include "scalar.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <SDL3/SDL.h>
+
+/**
+ * Reports that a character's data file is malformed. It is deliberately not @c constexpr : when a character is parsed
+ * while the game is being compiled, reaching it stops the build, and the compiler's message shows the reason.
+ * @param reason What is wrong with the data.
+ * @exception std::invalid_argument Always, when parsing while the game is running.
+ */
+[[noreturn]] inline void malformedCharacterData(const char* reason) {
+    throw std::invalid_argument(reason);
+}
+
+/**
+ * Reads the big-endian numbers of a *.ff file while compiling.
+ */
+class ConstexprReader {
+private:
+    std::span<const unsigned char> data; /**< The whole *.ff file. */
+    size_t position = 0UZ; /**< The next byte to read. */
+public:
+    /**
+     * Starts reading a *.ff file.
+     * @param data The whole *.ff file.
+     */
+    constexpr explicit ConstexprReader(const std::span<const unsigned char> data) : data{data} {}
+    /**
+     * Counts the bytes left to read.
+     * @return The bytes after the current position.
+     */
+    constexpr size_t remaining() const {
+        return this->data.size() - this->position;
+    }
+    /**
+     * Reads one byte.
+     * @return The byte.
+     */
+    constexpr uint8_t readU8() {
+        if (this->remaining() < 1UZ) {
+            malformedCharacterData("Reached EOF");
+        }
+        return this->data[this->position++];
+    }
+    /**
+     * Reads a big-endian unsigned short.
+     * @return The number.
+     */
+    constexpr uint16_t readU16() {
+        const uint8_t high = this->readU8();
+        return static_cast<uint16_t>((high << 8) | this->readU8());
+    }
+    /**
+     * Reads a big-endian unsigned int.
+     * @return The number.
+     */
+    constexpr uint32_t readU32() {
+        const uint32_t high = this->readU16();
+        return (high << 16) | this->readU16();
+    }
+    /**
+     * Reads a big-endian signed short.
+     * @return The number.
+     */
+    constexpr int16_t readS16() {
+        return static_cast<int16_t>(this->readU16());
+    }
+    /**
+     * Reads a big-endian @c float .
+     * @return The number.
+     */
+    constexpr float readFloat() {
+        return std::bit_cast<float>(this->readU32());
+    }
+};
+
+/**
+ * Finds a section of a *.ff container while compiling.
+ * @param data The whole *.ff file.
+ * @param offset Where the section starts.
+ * @param length How many bytes the section takes.
+ * @return The section.
+ */
+constexpr std::span<const unsigned char> constexprSection(const std::span<const unsigned char> data, const size_t offset, const size_t length) {
+    if (offset > data.size() || length > data.size() - offset) {
+        malformedCharacterData("Section does not fit in the file");
+    }
+    return data.subspan(offset, length);
+}
+
+/**
+ * A sprite parsed while compiling, with its own boxes until every animation has been read.
+ */
+struct ConstexprSprite {
+    CompiledSprite sprite; /**< The sprite, whose @c CompiledSprite::firstBox is only known once flattened. */
+    std::vector<CompiledBox> boxes; /**< The sprite's boxes, not scaled yet. */
+};
+
+/**
+ * An animation parsed while compiling.
+ */
+struct ConstexprAnimation {
+    uint16_t type; /**< The @c AnimationType . */
+    std::vector<ConstexprSprite> frames; /**< The animation's sprites. */
+};
+
+/**
+ * A character parsed while compiling, flattened into the records of a compiled character.
+ */
+struct ConstexprParse {
+    CharacterStats stats; /**< The stats of the character. */
+    uint32_t paletteCount = 0U; /**< How many palettes the character has. */
+    uint32_t colorCount = 0U; /**< How many colors each palette has. */
+    std::vector<SDL_Color> colors; /**< The colors of every palette, back to back. */
+    std::vector<CompiledAnimation> animations; /**< The animations, sorted by type. */
+    std::vector<CompiledSprite> sprites; /**< The sprites of every animation, back to back. */
+    std::vector<CompiledBox> boxes; /**< The boxes of every sprite, back to back and scaled to the character's size. */
+};
+
+/**
+ * Reads one box, the same way as @c parseCharacterData .
+ * @param reader The reader.
+ * @param boxType The type of the box.
+ * @return The box, not scaled yet.
+ */
+constexpr CompiledBox readConstexprBox(ConstexprReader& reader, const uint16_t boxType) {
+    CompiledBox box{};
+    box.boxType = boxType;
+    const int16_t x = reader.readS16();
+    const int16_t y = reader.readS16();
+    const int16_t w = reader.readS16();
+    const int16_t h = reader.readS16();
+    box.rect = ScalarRect::fromFRect(SDL_FRect(static_cast<float>(x), static_cast<float>(y), static_cast<float>(w), static_cast<float>(h)));
+    if (boxType >= HITBOX_BEGIN && boxType <= HITBOX_END) {
+        if (HitboxProperties(static_cast<uint8_t>(boxType % 256)).knockback == KNOCKS_DOWN) {
+            box.xKnockback = reader.readU16();
+            box.blockStun = reader.readU16();
+            box.yKnockback = reader.readS16();
+            box.blockPushback = reader.readS16();
+        } else {
+            box.hitStun = reader.readU16();
+            box.blockStun = reader.readU16();
+            box.hitPushback = reader.readS16();
+            box.blockPushback = reader.readS16();
+        }
+    }
+    return box;
+}
+
+/**
+ * Reads boxes until a @c NULL_TERMINATOR .
+ * @param reader The reader.
+ * @param boxes The boxes to add to.
+ */
+constexpr void readConstexprBoxes(ConstexprReader& reader, std::vector<CompiledBox>& boxes) {
+    for (uint16_t boxType = reader.readU16(); boxType != NULL_TERMINATOR; boxType = reader.readU16()) {
+        const uint16_t count = reader.readU16();
+        for (uint16_t i = 0U; i < count; ++i) {
+            boxes.push_back(readConstexprBox(reader, boxType));
+        }
+    }
+}
+
+/**
+ * Reads one sprite, resolving a copy of another sprite the same way as @c parseCharacterData .
+ * @param reader The reader.
+ * @param animations The animations read so far, which copies refer to.
+ * @return The sprite.
+ */
+constexpr ConstexprSprite readConstexprSprite(ConstexprReader& reader, const std::vector<ConstexprAnimation>& animations) {
+    ConstexprSprite result{};
+    const uint16_t length = reader.readU16();
+    if (length < 0xFF00U) {
+        result.sprite.length = length;
+        const uint16_t x = reader.readU16();
+        const uint16_t y = reader.readU16();
+        const uint16_t w = reader.readU16();
+        const uint16_t h = reader.readU16();
+        result.sprite.spriteSheetArea = SDL_FRect(static_cast<float>(x), static_cast<float>(y), static_cast<float>(w), static_cast<float>(h));
+        result.sprite.xOffset = reader.readS16();
+        result.sprite.yOffset = reader.readS16();
+        readConstexprBoxes(reader, result.boxes);
+        return result;
+    }
+    const uint16_t animationType = reader.readU16();
+    const uint16_t index = reader.readU16();
+    const uint8_t copy = static_cast<uint8_t>(length % 256);
+    const auto animation = std::ranges::find(animations, animationType, &ConstexprAnimation::type);
+    if (animation == animations.end() || index >= animation->frames.size()) {
+        malformedCharacterData("Copies a sprite that does not exist");
+    }
+    const ConstexprSprite& reference = animation->frames[index];
+    result.sprite = reference.sprite;
+    if (!(copy & (1 << 7))) {
+        result.sprite.length = reader.readU16();
+    }
+    if (!(copy & (1 << 6))) {
+        const uint16_t x = reader.readU16();
+        const uint16_t y = reader.readU16();
+        const uint16_t w = reader.readU16();
+        const uint16_t h = reader.readU16();
+        result.sprite.spriteSheetArea = SDL_FRect(static_cast<float>(x), static_cast<float>(y), static_cast<float>(w), static_cast<float>(h));
+    }
+    if (!(copy & (1 << 5))) {
+        result.sprite.xOffset = reader.readS16();
+        result.sprite.yOffset = reader.readS16();
+    }
+    if ((copy & 0b00011111U) != 0b00011111U) {
+        readConstexprBoxes(reader, result.boxes);
+    }
+    for (const CompiledBox& box : reference.boxes) {
+        bool mustCopy;
+        switch (box.boxType) {
+            case NULL_TERMINATOR:
+                mustCopy = false;
+                break;
+            case HURTBOX:
+                mustCopy = copy & (1 << 4);
+                break;
+            case COMMAND_GRAB:
+                mustCopy = copy & (1 << 3);
+                break;
+            case THROW_PUSH_GROUND_COLLISION:
+                mustCopy = copy & (1 << 2);
+                break;
+            case PROXIMITY_GUARD:
+                mustCopy = copy & (1 << 1);
+                break;
+            default:
+                mustCopy = copy & (1 << 0);
+                break;
+        }
+        if (mustCopy) {
+            result.boxes.push_back(box);
+        }
+    }
+    return result;
+}
+
+/**
+ * Reads the colors of every palette.
+ * @param reader The reader, at the first color.
+ * @param parse The character, whose palette and color counts are already read.
+ */
+constexpr void readConstexprColors(ConstexprReader& reader, ConstexprParse& parse) {
+    if (parse.paletteCount == 0U || parse.colorCount == 0U) {
+        malformedCharacterData("No colors");
+    }
+    parse.colors.reserve(static_cast<size_t>(parse.paletteCount) * parse.colorCount);
+    for (size_t i = 0UZ; i < static_cast<size_t>(parse.paletteCount) * parse.colorCount; ++i) {
+        const uint8_t r = reader.readU8();
+        const uint8_t g = reader.readU8();
+        const uint8_t b = reader.readU8();
+        parse.colors.push_back(SDL_Color(r, g, b, 0xFFU));
+    }
+}
+
+/**
+ * Reads the stats of a character.
+ * @param reader The reader, at the first stat.
+ * @return The stats.
+ */
+constexpr CharacterStats readConstexprStats(ConstexprReader& reader) {
+    CharacterStats stats;
+    stats.size = reader.readFloat();
+    stats.walkForwardSpeed = reader.readFloat();
+    stats.walkBackwardSpeed = reader.readFloat();
+    stats.jumpForwardXVelocity = reader.readFloat();
+    stats.jumpBackwardXVelocity = reader.readFloat();
+    stats.initialJumpVelocity = reader.readFloat();
+    stats.gravity = reader.readFloat();
+    return stats;
+}
+
+/**
+ * Reads the animations of a sequential *.ff file, the same way as @c parseCharacterData .
+ * @param reader The reader, after the stats.
+ * @return The animations, in the order they are stored.
+ */
+constexpr std::vector<ConstexprAnimation> readConstexprSequential(ConstexprReader& reader) {
+    std::vector<ConstexprAnimation> animations;
+    while (reader.remaining() >= 2UZ) {
+        const uint16_t animationType = reader.readU16();
+        const uint16_t numberOfFrames = reader.readU16();
+        for (uint16_t i = 0U; i < numberOfFrames; ++i) {
+            ConstexprSprite sprite = readConstexprSprite(reader, animations);
+            auto animation = std::ranges::find(animations, animationType, &ConstexprAnimation::type);
+            if (animation == animations.end()) {
+                animations.push_back(ConstexprAnimation(animationType, {}));
+                animation = animations.end() - 1;
+            }
+            animation->frames.push_back(std::move(sprite));
+        }
+    }
+    return animations;
+}
+
+/**
+ * Reads a *.ff container, the same way as @c CharacterContainer .
+ * @param data The whole *.ff file.
+ * @param reader The reader, after the version.
+ * @param parse The character, which gets its palettes and stats.
+ * @return The animations, sorted by type.
+ */
+constexpr std::vector<ConstexprAnimation> readConstexprContainer(const std::span<const unsigned char> data, ConstexprReader& reader, ConstexprParse& parse) {
+    reader.readU16();
+    parse.paletteCount = reader.readU16();
+    parse.colorCount = reader.readU16();
+    const uint32_t paletteOffset = reader.readU32();
+    parse.stats = readConstexprStats(reader);
+    const uint32_t animationCount = reader.readU32();
+    const uint32_t directoryOffset = reader.readU32();
+    const uint32_t fileSize = reader.readU32();
+    const std::span<const unsigned char> file = constexprSection(data, 0UZ, fileSize);
+    ConstexprReader colors(constexprSection(file, paletteOffset, file.size() - std::min<size_t>(paletteOffset, file.size())));
+    readConstexprColors(colors, parse);
+    ConstexprReader directory(constexprSection(file, directoryOffset, static_cast<size_t>(animationCount) * characterDirectoryEntrySize));
+    std::vector<ConstexprAnimation> animations;
+    for (uint32_t i = 0U; i < animationCount; ++i) {
+        const uint16_t type = directory.readU16();
+        const uint16_t frameCount = directory.readU16();
+        const uint8_t compression = directory.readU8();
+        directory.readU8();
+        directory.readU16();
+        const uint32_t offset = directory.readU32();
+        const uint32_t length = directory.readU32();
+        if (!animations.empty() && type <= animations.back().type) {
+            malformedCharacterData("Animations are not sorted by type");
+        }
+        std::span<const unsigned char> section = constexprSection(file, offset, length);
+        std::vector<unsigned char> unpacked;
+        if (compression == PACK_BITS) {
+            if (!unpackBits(section, unpacked)) {
+                malformedCharacterData("Reached EOF");
+            }
+            section = unpacked;
+        } else if (compression != UNCOMPRESSED) {
+            malformedCharacterData("Unknown compression");
+        }
+        // Copies may only refer to earlier sprites of the same animation.
+        std::vector<ConstexprAnimation> current{ConstexprAnimation(type, {})};
+        ConstexprReader sprites(section);
+        for (uint16_t j = 0U; j < frameCount; ++j) {
+            ConstexprSprite sprite = readConstexprSprite(sprites, current);
+            current.front().frames.push_back(std::move(sprite));
+        }
+        if (sprites.remaining() != 0UZ) {
+            malformedCharacterData("Section is longer than its sprites");
+        }
+        animations.push_back(std::move(current.front()));
+    }
+    return animations;
+}
+
+/**
+ * Parses a *.ff file the same way as @c parseCharacterData , meant to run while compiling.
+ * @param data The whole *.ff file.
+ * @return The character, flattened into compiled records with every box scaled to the character's size.
+ */
+constexpr ConstexprParse parseConstexprData(const std::span<const unsigned char> data) {
+    ConstexprReader reader(data);
+    ConstexprParse parse;
+    if (reader.readU16() != characterDataHeader) {
+        malformedCharacterData("Invalid header");
+    }
+    std::vector<ConstexprAnimation> animations;
+    parse.paletteCount = reader.readU16();
+    // A container has no palettes where a sequential file would, followed by its version instead of a color count.
+    parse.colorCount = reader.readU16();
+    if (parse.paletteCount == 0U && parse.colorCount == characterContainerVersion) {
+        animations = readConstexprContainer(data, reader, parse);
+    } else {
+        readConstexprColors(reader, parse);
+        parse.stats = readConstexprStats(reader);
+        animations = readConstexprSequential(reader);
+    }
+    if (std::ranges::find(animations, static_cast<uint16_t>(IDLE), &ConstexprAnimation::type) == animations.end()) {
+        malformedCharacterData("No idle animation");
+    }
+    std::ranges::sort(animations, {}, &ConstexprAnimation::type);
+    const Scalar size(parse.stats.size);
+    for (const ConstexprAnimation& animation : animations) {
+        if (animation.frames.size() > UINT16_MAX) {
+            malformedCharacterData("Animation has too many frames");
+        }
+        parse.animations.push_back(CompiledAnimation(animation.type, static_cast<uint16_t>(animation.frames.size()), static_cast<uint32_t>(parse.sprites.size())));
+        for (const ConstexprSprite& sprite : animation.frames) {
+            if (sprite.boxes.size() > UINT16_MAX) {
+                malformedCharacterData("Sprite has too many boxes");
+            }
+            CompiledSprite& compiled = parse.sprites.emplace_back(sprite.sprite);
+            compiled.firstBox = static_cast<uint32_t>(parse.boxes.size());
+            compiled.boxCount = static_cast<uint16_t>(sprite.boxes.size());
+            for (CompiledBox box : sprite.boxes) {
+                box.rect.x *= size;
+                box.rect.y *= size;
+                box.rect.w *= size;
+                box.rect.h *= size;
+                parse.boxes.push_back(box);
+            }
+        }
+    }
+    return parse;
+}
+
+/**
+ * How many records a character parsed while compiling has, which sizes its arrays.
+ */
+struct ConstexprCharacterSizes {
+    size_t colorCount; /**< How many colors all the palettes have. */
+    size_t animationCount; /**< How many animations the character has. */
+    size_t spriteCount; /**< How many sprites all the animations have. */
+    size_t boxCount; /**< How many boxes all the sprites have. */
+};
+
+/**
+ * Counts the records of a *.ff file, so that @c parseConstexprCharacter knows how large to make its arrays.
+ * @param data The whole *.ff file.
+ * @return How many records the character has.
+ */
+constexpr ConstexprCharacterSizes measureConstexprCharacter(const std::span<const unsigned char> data) {
+    const ConstexprParse parse = parseConstexprData(data);
+    return ConstexprCharacterSizes(parse.colors.size(), parse.animations.size(), parse.sprites.size(), parse.boxes.size());
+}
+
+/**
+ * A character parsed while compiling the game, stored in arrays that need no initialization when the game starts.
+ * @tparam sizes How many records the character has, from @c measureConstexprCharacter .
+ */
+template <ConstexprCharacterSizes sizes>
+struct ConstexprCharacter {
+    CharacterStats stats; /**< The stats of the character. */
+    uint32_t paletteCount = 0U; /**< How many palettes the character has. */
+    uint32_t colorCount = 0U; /**< How many colors each palette has. */
+    std::array<SDL_Color, sizes.colorCount> colors{}; /**< The colors of every palette, back to back. */
+    std::array<CompiledAnimation, sizes.animationCount> animations{}; /**< The animations, sorted by type. */
+    std::array<CompiledSprite, sizes.spriteCount> sprites{}; /**< The sprites of every animation, back to back. */
+    std::array<CompiledBox, sizes.boxCount> boxes{}; /**< The boxes of every sprite, back to back. */
+    /**
+     * Gets every record of the character.
+     * @return The stats, palettes, animations, sprites and boxes.
+     */
+    constexpr CompiledRecords getRecords() const {
+        return CompiledRecords(this->stats, this->paletteCount, this->colorCount, this->colors, this->animations, this->sprites, this->boxes);
+    }
+};
+
+/**
+ * Parses a *.ff file into arrays, meant to initialize a @c constexpr variable so that malformed data stops the build.
+ * @tparam sizes How many records the character has, from @c measureConstexprCharacter .
+ * @param data The whole *.ff file.
+ * @return The parsed character.
+ */
+template <ConstexprCharacterSizes sizes>
+constexpr ConstexprCharacter<sizes> parseConstexprCharacter(const std::span<const unsigned char> data) {
+    const ConstexprParse parse = parseConstexprData(data);
+    ConstexprCharacter<sizes> character;
+    character.stats = parse.stats;
+    character.paletteCount = parse.paletteCount;
+    character.colorCount = parse.colorCount;
+    std::ranges::copy(parse.colors, character.colors.begin());
+    std::ranges::copy(parse.animations, character.animations.begin());
+    std::ranges::copy(parse.sprites, character.sprites.begin());
+    std::ranges::copy(parse.boxes, character.boxes.begin());
+    return character;
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <bitset>
+#include <concepts>
+#include <exception>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+/**
+ * Formats a number to look pretty when printed.
+ *
+ * @tparam T Any kind of whole number.
+ * @param number The number to format.
+ * @param hex Whether to format in hexadecimal (@c true) or binary/decimal (@c false).
+ * @param binary Whether to format in binary (@c true) or decimal (@c false).
+ * @param uppercase Whether hex digits and suffixes (U, L, etc.) are uppercase (@c true) or lowercase (@c false).
+ * @return The formatted version of the number.
+ */
+template <std::integral T>
+std::string format_number(T number, bool hex = true, bool binary = true, bool uppercase = true);
+
+/**
+ * Exception to be thrown when having issues reading a data file.
+ * @tparam T Any kind of whole number.
+ */
+template <std::integral T>
+class DataException : public std::exception {
+private:
+    const std::string origin; /**< The function that threw the exception. */
+    const std::string error; /**< The error in question. */
+    const T data; /**< The data surrounding the error. */
+    std::string result;  /**< A formatted string of the exception information. */
+public:
+    /**
+     * Constructs a @c DataException .
+     * @param origin The function that threw the exception.
+     * @param error The error in question.
+     * @param data The data surrounding the error.
+     */
+    DataException(std::string origin, std::string error, T data = {});
+    /**
+     * Describes the exception.
+     * @return A formatted string of the exception information.
+     */
+    const char* what() const noexcept override;
+};
+
+template <std::integral T>
+std::string format_number(T number, const bool hex, const bool binary, const bool uppercase) {
+    std::stringstream ss;
+    if (uppercase) {
+        ss << std::uppercase;
+    }
+    if (hex) {
+        ss << std::hex << "0x" << std::setfill('0') << std::setw(sizeof(T) * 2);
+        if (std::is_same_v<T, char> || std::is_same_v<T, unsigned char>) {
+            ss << static_cast<short>(number);
+        } else {
+            ss << number;
+        }
+    } else if (binary) {
+        ss << "0b" << std::setfill('0') << std::setw(sizeof(T) * 8);
+        std::bitset<sizeof(T) * 8> bits(number);
+        ss << bits;
+    } else {
+        if (std::is_same_v<T, char> || std::is_same_v<T, unsigned char>) {
+            ss << static_cast<short>(number);
+        } else {
+            ss << number;
+        }
+    }
+    if (!std::is_signed_v<T>) {
+        ss << (uppercase ? 'U' : 'u');
+    }
+    if (std::is_same_v<T, long> || std::is_same_v<T, unsigned long>) {
+        ss << (uppercase ? 'L' : 'l');
+    } else if (std::is_same_v<T, long long> || std::is_same_v<T, unsigned long long>) {
+        ss << (uppercase ? 'L' : 'l') << (uppercase ? 'L' : 'l');
+    }
+    return ss.str();
+}
+
+template <std::integral T>
+DataException<T>::DataException(std::string origin, std::string error, const T data) : origin{std::move(origin)}, error{std::move(error)}, data{data} {
+    std::stringstream ss;
+    ss << "Origin: " << this->origin << std::endl << "Error: " << this->error << std::endl << "Data: " << format_number<T>(this->data) << std::endl;
+    this->result = ss.str();
+}
+
+template <std::integral T>
+const char* DataException<T>::what() const noexcept {
+    return this->result.c_str();
+}
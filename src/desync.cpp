@@ -0,0 +1,236 @@
+#include "desync.hpp"
+
+#include "character.hpp"
+#include "input_history.hpp"
+#include "motion_recognizer.hpp"
+#include "scalar.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/**
+ * Marks the start of a file written by @c writeFrameTrace .
+ */
+constexpr std::array<char, 4> frameTraceMagic = {'F', 'F', 'T', 'R'};
+/**
+ * The version of the files written by @c writeFrameTrace .
+ */
+constexpr uint16_t frameTraceVersion = 1U;
+
+/**
+ * Converts a field to text.
+ * @param value The value of the field.
+ * @return The value, as printed by a stream.
+ */
+template <typename T>
+static std::string fieldToString(const T& value) {
+    std::ostringstream text;
+    text << value;
+    return text.str();
+}
+
+#if FOSS_FIGHT_FIXED_POINT
+/**
+ * Converts a fixed-point field to text, as the number it stands for. Float builds use the template instead, since a
+ * @c Scalar is a @c float there and this overload would call itself.
+ * @param value The value of the field.
+ * @return The value, as printed by a stream.
+ */
+static std::string fieldToString(const Scalar value) {
+    return fieldToString(toFloat(value));
+}
+#endif
+
+static std::string fieldToString(const uint8_t value) {
+    return std::to_string(value);
+}
+
+/**
+ * Adds a field to a list of differences if it differs.
+ * @param differences The list to add to.
+ * @param field The name of the field.
+ * @param expected The value in the reference state.
+ * @param actual The value in the state being checked.
+ */
+template <typename T>
+static void compareField(std::vector<FieldDifference>& differences, const std::string& field, const T& expected, const T& actual) {
+    if (!(expected == actual)) {
+        differences.push_back(FieldDifference(field, fieldToString(expected), fieldToString(actual)));
+    }
+}
+
+/**
+ * Converts a saved input history entry to text.
+ * @param state The saved input history.
+ * @param index The index of the entry.
+ * @return The entry, as printed by @c operator<<(std::ostream&,const InputHistoryEntry&) .
+ */
+static std::string entryToString(const InputHistoryState& state, const size_t index) {
+    if (index >= state.count) {
+        return "(none)";
+    }
+    return fieldToString(InputHistoryEntry(unpackDirection(state.inputs[index]), unpackButtons(state.inputs[index]), state.durations[index]));
+}
+
+/**
+ * Adds every field of a saved character that differs to a list of differences.
+ * @param differences The list to add to.
+ * @param player The name of the player, for example @c player1 .
+ * @param expected The reference state.
+ * @param actual The state being checked.
+ */
+static void diffCharacterStates(std::vector<FieldDifference>& differences, const std::string& player,
+                                const CharacterState& expected, const CharacterState& actual) {
+    const size_t reported = differences.size();
+    compareField(differences, player + ".coordinates.x", expected.coordinates.x, actual.coordinates.x);
+    compareField(differences, player + ".coordinates.y", expected.coordinates.y, actual.coordinates.y);
+    compareField(differences, player + ".coordinates.w", expected.coordinates.w, actual.coordinates.w);
+    compareField(differences, player + ".coordinates.h", expected.coordinates.h, actual.coordinates.h);
+    compareField(differences, player + ".currentXVelocity", expected.currentXVelocity, actual.currentXVelocity);
+    compareField(differences, player + ".currentYVelocity", expected.currentYVelocity, actual.currentYVelocity);
+    compareField(differences, player + ".frame", expected.frame, actual.frame);
+    compareField(differences, player + ".currentHealth", expected.currentHealth, actual.currentHealth);
+    compareField(differences, player + ".currentAnimation", expected.currentAnimation, actual.currentAnimation);
+    compareField(differences, player + ".previousAnimation", expected.previousAnimation, actual.previousAnimation);
+    compareField(differences, player + ".previousAction", expected.previousAction, actual.previousAction);
+    compareField(differences, player + ".currentAttack", expected.currentAttack, actual.currentAttack);
+    compareField(differences, player + ".spriteIndex", expected.spriteIndex, actual.spriteIndex);
+    compareField(differences, player + ".midair", expected.midair, actual.midair);
+    compareField(differences, player + ".jumpArc", expected.jumpArc, actual.jumpArc);
+    compareField(differences, player + ".inputs.count", expected.inputs.count, actual.inputs.count);
+    const size_t entries = std::max(expected.inputs.count, actual.inputs.count);
+    for (size_t i = 0UZ; i < std::min(entries, savedInputHistoryLength); ++i) {
+        const std::string expectedEntry = entryToString(expected.inputs, i);
+        const std::string actualEntry = entryToString(actual.inputs, i);
+        compareField(differences, player + ".inputs[" + std::to_string(i) + "]", expectedEntry, actualEntry);
+    }
+    for (size_t motion = 0UZ; motion < MOTION_INPUT_COUNT; ++motion) {
+        const std::string field = player + ".motions[" + std::to_string(motion) + "]";
+        compareField(differences, field + ".state", expected.motions.states[motion], actual.motions.states[motion]);
+        compareField(differences, field + ".progressAge", expected.motions.progressAges[motion], actual.motions.progressAges[motion]);
+        compareField(differences, field + ".completedAge", expected.motions.completedAges[motion], actual.motions.completedAges[motion]);
+    }
+    for (size_t charge = 0UZ; charge < expected.motions.heldCharges.size(); ++charge) {
+        const std::string field = player + ".motions.charges[" + std::to_string(charge) + "]";
+        compareField(differences, field + ".held", expected.motions.heldCharges[charge], actual.motions.heldCharges[charge]);
+        compareField(differences, field + ".releasedAge", expected.motions.releasedChargeAges[charge], actual.motions.releasedChargeAges[charge]);
+    }
+    compareField(differences, player + ".motions.direction", expected.motions.direction, actual.motions.direction);
+    compareField(differences, player + ".motions.buttons", expected.motions.buttons, actual.motions.buttons);
+    compareField(differences, player + ".motions.pressedButtons", expected.motions.pressedButtons, actual.motions.pressedButtons);
+    // The checksum covers every byte, so a field left out above must still show up rather than leave the report empty.
+    if (differences.size() == reported && std::memcmp(&expected, &actual, sizeof(CharacterState)) != 0) {
+        const auto* expectedBytes = reinterpret_cast<const uint8_t*>(&expected);
+        const auto* actualBytes = reinterpret_cast<const uint8_t*>(&actual);
+        for (size_t i = 0UZ; i < sizeof(CharacterState); ++i) {
+            compareField(differences, player + ".bytes[" + std::to_string(i) + "]", expectedBytes[i], actualBytes[i]);
+        }
+    }
+}
+
+std::vector<FieldDifference> diffMatchStates(const MatchState& expected, const MatchState& actual) {
+    std::vector<FieldDifference> differences;
+    compareField(differences, "frame", expected.frame, actual.frame);
+    diffCharacterStates(differences, "player1", expected.player1, actual.player1);
+    diffCharacterStates(differences, "player2", expected.player2, actual.player2);
+    return differences;
+}
+
+std::ostream& operator<<(std::ostream& stream, const FieldDifference& difference) {
+    stream << difference.field << ": " << difference.expected << " -> " << difference.actual;
+    return stream;
+}
+
+Desync findDesync(const FrameTrace& expected, const FrameTrace& actual) {
+    Desync desync;
+    const size_t frames = std::min(expected.checksums.size(), actual.checksums.size());
+    size_t frame = 0UZ;
+    while (frame < frames && expected.checksums[frame] == actual.checksums[frame]) {
+        ++frame;
+    }
+    if (frame == frames && expected.checksums.size() == actual.checksums.size()) {
+        return desync;
+    }
+    desync.found = true;
+    desync.frame = frame + 1UZ;
+    if (frame < frames) {
+        desync.expectedChecksum = expected.checksums[frame];
+        desync.actualChecksum = actual.checksums[frame];
+        if (frame < expected.states.size() && frame < actual.states.size()) {
+            desync.fields = diffMatchStates(expected.states[frame], actual.states[frame]);
+        }
+    }
+    return desync;
+}
+
+/**
+ * Writes a number in the machine's byte order.
+ * @param stream The stream to write to.
+ * @param value The number to write.
+ */
+template <typename T>
+static void writeRaw(std::ostream& stream, const T& value) {
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+/**
+ * Reads a number in the machine's byte order.
+ * @param stream The stream to read from.
+ * @return The number read.
+ * @exception std::invalid_argument The stream ended early.
+ */
+template <typename T>
+static T readRaw(std::istream& stream) {
+    T value;
+    if (!stream.read(reinterpret_cast<char*>(&value), sizeof(T))) {
+        throw std::invalid_argument("Frame trace ended early");
+    }
+    return value;
+}
+
+void writeFrameTrace(std::ostream& stream, const FrameTrace& trace) {
+    if (trace.states.size() != trace.checksums.size()) {
+        throw std::invalid_argument("Frame trace has no states to write");
+    }
+    stream.write(frameTraceMagic.data(), frameTraceMagic.size());
+    writeRaw<uint16_t>(stream, frameTraceVersion);
+    writeRaw<uint16_t>(stream, FOSS_FIGHT_FIXED_POINT ? 1U : 0U);
+    writeRaw<uint32_t>(stream, sizeof(MatchState));
+    writeRaw<uint64_t>(stream, trace.checksums.size());
+    for (size_t frame = 0UZ; frame < trace.checksums.size(); ++frame) {
+        writeRaw(stream, trace.checksums[frame]);
+        writeRaw(stream, trace.states[frame]);
+    }
+}
+
+FrameTrace readFrameTrace(std::istream& stream) {
+    std::array<char, 4> magic;
+    if (!stream.read(magic.data(), magic.size()) || magic != frameTraceMagic) {
+        throw std::invalid_argument("Not a frame trace");
+    }
+    const uint16_t version = readRaw<uint16_t>(stream);
+    if (version != frameTraceVersion) {
+        throw std::invalid_argument("Unsupported frame trace version " + std::to_string(version));
+    }
+    if (readRaw<uint16_t>(stream) != (FOSS_FIGHT_FIXED_POINT ? 1U : 0U)) {
+        throw std::invalid_argument("Frame trace was recorded with a different kind of physics");
+    }
+    if (readRaw<uint32_t>(stream) != sizeof(MatchState)) {
+        throw std::invalid_argument("Frame trace was recorded with a different match state layout");
+    }
+    const uint64_t frames = readRaw<uint64_t>(stream);
+    FrameTrace trace;
+    trace.keepStates = true;
+    for (uint64_t frame = 0U; frame < frames; ++frame) {
+        trace.checksums.push_back(readRaw<uint64_t>(stream));
+        trace.states.push_back(readRaw<MatchState>(stream));
+    }
+    return trace;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "match.hpp"
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * One field that differs between two saved matches.
+ */
+struct FieldDifference {
+    std::string field; /**< The name of the field, for example @c player1.coordinates.x . */
+    std::string expected; /**< The value in the reference state. */
+    std::string actual; /**< The value in the state being checked. */
+};
+
+/**
+ * Compares two saved matches field by field. A character whose bytes differ in no field that is compared by name is
+ * reported byte by byte instead, so that a difference is never missed.
+ * @param expected The reference state.
+ * @param actual The state being checked.
+ * @return Every field that differs, in the order they are declared, empty only if the states are the same byte for byte.
+ */
+std::vector<FieldDifference> diffMatchStates(const MatchState& expected, const MatchState& actual);
+
+/**
+ * Prints a field that differs, as @c field: expected -> actual .
+ * @param stream The stream to print to.
+ * @param difference The field to print.
+ * @return The stream.
+ */
+std::ostream& operator<<(std::ostream& stream, const FieldDifference& difference);
+
+/**
+ * A record of a match, taken after every frame.
+ */
+struct FrameTrace {
+    std::vector<uint64_t> checksums; /**< The @c Match::checksum after each frame. */
+    std::vector<MatchState> states; /**< The state after each frame, only filled when @c keepStates is set. */
+    bool keepStates = false; /**< Whether to keep every state as well as its checksum, to find out which fields differ. */
+};
+
+/**
+ * Where two records of the same match first stop agreeing.
+ */
+struct Desync {
+    bool found = false; /**< Whether the records differ at all. */
+    size_t frame = 0UZ; /**< The first frame that differs, counting from 1. */
+    uint64_t expectedChecksum = 0U; /**< The checksum of that frame in the reference record. */
+    uint64_t actualChecksum = 0U; /**< The checksum of that frame in the record being checked. */
+    std::vector<FieldDifference> fields; /**< The fields that differ on that frame, empty if either record has no states. */
+};
+
+/**
+ * Finds the first frame on which two records of a match differ. Checksums are compared first, and the states of the
+ * first frame that differs are compared field by field. A record that ends early differs on the frame after its last.
+ * @param expected The reference record.
+ * @param actual The record being checked.
+ * @return Where the records first differ.
+ */
+Desync findDesync(const FrameTrace& expected, const FrameTrace& actual);
+
+/**
+ * Writes a record of a match with its states, to check later runs against. States are written in the machine's byte
+ * order, so the file can only be read on machines of the same kind with the same kind of physics.
+ * @param stream The stream to write to, opened in binary mode.
+ * @param trace The record to write, which must have its states.
+ * @exception std::invalid_argument The record has no states.
+ */
+void writeFrameTrace(std::ostream& stream, const FrameTrace& trace);
+
+/**
+ * Reads a record of a match written by @c writeFrameTrace .
+ * @param stream The stream to read from, opened in binary mode.
+ * @return The record, with its states.
+ * @exception std::invalid_argument The stream is not a record, or was written by a different kind of build.
+ */
+FrameTrace readFrameTrace(std::istream& stream);
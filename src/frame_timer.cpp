@@ -0,0 +1,60 @@
+#include "frame_timer.hpp"
+
+#include <SDL3/SDL.h>
+
+FixedTimestep::FixedTimestep(const Uint64 tickRate, const unsigned int maxCatchUpTicks)
+    : tickRate{tickRate}, maxCatchUpTicks{maxCatchUpTicks} {}
+
+void FixedTimestep::start(const Uint64 now) {
+    this->previousTime = now;
+    this->accumulator = 0U;
+}
+
+unsigned int FixedTimestep::advance(const Uint64 now) {
+    if (now > this->previousTime) {
+        this->accumulator += (now - this->previousTime) * this->tickRate;
+    }
+    this->previousTime = now;
+    Uint64 due = this->accumulator / SDL_NS_PER_SECOND;
+    this->accumulator %= SDL_NS_PER_SECOND;
+    if (due > this->maxCatchUpTicks) {
+        this->droppedTicks += due - this->maxCatchUpTicks;
+        due = this->maxCatchUpTicks;
+    }
+    this->totalTicks += due;
+    return static_cast<unsigned int>(due);
+}
+
+Uint64 FixedTimestep::nanosecondsUntilNextTick(const Uint64 now) const {
+    const Uint64 elapsed = now > this->previousTime ? (now - this->previousTime) * this->tickRate : 0U;
+    const Uint64 accumulated = this->accumulator + elapsed;
+    if (accumulated >= SDL_NS_PER_SECOND) {
+        return 0U;
+    }
+    return (SDL_NS_PER_SECOND - accumulated + this->tickRate - 1U) / this->tickRate;
+}
+
+Uint64 FixedTimestep::getTotalTicks() const { return this->totalTicks; }
+
+Uint64 FixedTimestep::getDroppedTicks() const { return this->droppedTicks; }
+
+FrameLimiter::FrameLimiter(const Uint64 framesPerSecond) : framesPerSecond{framesPerSecond} {}
+
+void FrameLimiter::start(const Uint64 now) {
+    this->startTime = now;
+    this->frames = 0U;
+}
+
+void FrameLimiter::wait() {
+    if (this->framesPerSecond == 0U) {
+        return;
+    }
+    ++this->frames;
+    const Uint64 deadline = this->startTime + this->frames * SDL_NS_PER_SECOND / this->framesPerSecond;
+    const Uint64 now = SDL_GetTicksNS();
+    if (now < deadline) {
+        SDL_DelayPrecise(deadline - now);
+    } else if (now - deadline > SDL_NS_PER_SECOND / this->framesPerSecond) {
+        this->start(now);
+    }
+}
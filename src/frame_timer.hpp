@@ -0,0 +1,83 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+/**
+ * The number of simulation ticks per second. Frame data (hitstun, charge time, etc.) is counted in these ticks.
+ */
+constexpr Uint64 ticksPerSecond = 60U;
+
+/**
+ * Decides how many fixed-length simulation ticks to run, regardless of how long rendering takes.
+ *
+ * Elapsed time is accumulated in units of nanoseconds multiplied by the tick rate, so a tick costs exactly
+ * @c SDL_NS_PER_SECOND units and 1/60 of a second is never rounded.
+ */
+class FixedTimestep {
+private:
+    const Uint64 tickRate; /**< The number of ticks per second. */
+    const unsigned int maxCatchUpTicks; /**< The most ticks to run at once when behind, after which the extra time is dropped. */
+    Uint64 previousTime = 0U; /**< The time of the previous call to @c FixedTimestep::advance , in nanoseconds. */
+    Uint64 accumulator = 0U; /**< Time not yet simulated, in nanoseconds multiplied by @c FixedTimestep::tickRate . */
+    Uint64 totalTicks = 0U; /**< The number of ticks simulated since starting. */
+    Uint64 droppedTicks = 0U; /**< The number of ticks skipped because the simulation fell too far behind. */
+public:
+    /**
+     * Constructs a fixed timestep.
+     * @param tickRate The number of ticks per second.
+     * @param maxCatchUpTicks The most ticks to run at once when behind.
+     */
+    explicit FixedTimestep(Uint64 tickRate = ticksPerSecond, unsigned int maxCatchUpTicks = 5U);
+    /**
+     * Starts counting time.
+     * @param now The current time, in nanoseconds (from @c SDL_GetTicksNS ).
+     */
+    void start(Uint64 now);
+    /**
+     * Accumulates the time since the last call, and takes out the ticks that are due.
+     * @param now The current time, in nanoseconds (from @c SDL_GetTicksNS ).
+     * @return How many ticks to simulate now, at most the maximum catch-up.
+     */
+    unsigned int advance(Uint64 now);
+    /**
+     * Gets how long until the next tick is due.
+     * @param now The current time, in nanoseconds (from @c SDL_GetTicksNS ).
+     * @return The time until the next tick, in nanoseconds.
+     */
+    Uint64 nanosecondsUntilNextTick(Uint64 now) const;
+    /**
+     * Gets the number of ticks simulated since starting.
+     * @return The number of ticks.
+     */
+    Uint64 getTotalTicks() const;
+    /**
+     * Gets the number of ticks skipped because the simulation fell too far behind.
+     * @return The number of dropped ticks.
+     */
+    Uint64 getDroppedTicks() const;
+};
+
+/**
+ * Limits how often frames are rendered when vsync is not used.
+ */
+class FrameLimiter {
+private:
+    const Uint64 framesPerSecond; /**< The most frames to render per second, 0 for no limit. */
+    Uint64 frames = 0U; /**< The number of frames rendered since starting. */
+    Uint64 startTime = 0U; /**< When the limiter started, in nanoseconds. */
+public:
+    /**
+     * Constructs a frame limiter.
+     * @param framesPerSecond The most frames to render per second, 0 for no limit.
+     */
+    explicit FrameLimiter(Uint64 framesPerSecond);
+    /**
+     * Starts counting time.
+     * @param now The current time, in nanoseconds (from @c SDL_GetTicksNS ).
+     */
+    void start(Uint64 now);
+    /**
+     * Waits until the next frame is due, measuring from the start so that rounding never accumulates.
+     */
+    void wait();
+};
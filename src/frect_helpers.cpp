@@ -1,5 +1,7 @@
 #include "frect_helpers.hpp"
 
+#include "scalar.hpp"
+
 #include <SDL3/SDL.h>
 
 void setCoordinatesRect(SDL_FRect*& rect, const float x, const float y,
@@ -40,4 +42,21 @@ void moveRect(SDL_FRect*& rect, const float dx, const float dy) {
         rect->x += dx;
         rect->y += dy;
     }
-}
\ No newline at end of file
+}
+
+void multiplySizeRect(ScalarRect& rect, const Scalar factor) {
+    rect.x *= factor;
+    rect.y *= factor;
+    rect.w *= factor;
+    rect.h *= factor;
+}
+
+void changeDimensionsRect(ScalarRect& rect, const Scalar width, const Scalar height) {
+    rect.w = width;
+    rect.h = height;
+}
+
+void moveRect(ScalarRect& rect, const Scalar dx, const Scalar dy) {
+    rect.x += dx;
+    rect.y += dy;
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "scalar.hpp"
+
 #include <SDL3/SDL.h>
 
 /**
@@ -41,4 +43,27 @@ void changeDimensionsRect(SDL_FRect*& rect, float width, float height);
  * @param dx The change in x-coordinate.
  * @param dy The change in y-coordinate.
  */
-void moveRect(SDL_FRect*& rect, float dx, float dy);
\ No newline at end of file
+void moveRect(SDL_FRect*& rect, float dx, float dy);
+
+/**
+ * Changes the scale of a @c ScalarRect .
+ * @param rect The rectangle to change the scaling of.
+ * @param factor The factor of scaling.
+ */
+void multiplySizeRect(ScalarRect& rect, Scalar factor);
+
+/**
+ * Changes the dimensions of a @c ScalarRect .
+ * @param rect The rectangle to change the dimensions of.
+ * @param width The new width.
+ * @param height The new height.
+ */
+void changeDimensionsRect(ScalarRect& rect, Scalar width, Scalar height);
+
+/**
+ * Moves a @c ScalarRect .
+ * @param rect The rectangle to move.
+ * @param dx The change in x-coordinate.
+ * @param dy The change in y-coordinate.
+ */
+void moveRect(ScalarRect& rect, Scalar dx, Scalar dy);
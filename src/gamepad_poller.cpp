@@ -0,0 +1,68 @@
+#include "gamepad_poller.hpp"
+
+#include "command_input_parser.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+
+#include <SDL3/SDL.h>
+
+GamepadPoller::GamepadPoller(SDL_Gamepad* const gamepad, const Uint64 pollsPerSecond)
+    : gamepad{gamepad}, pollsPerSecond{pollsPerSecond} {
+    if (pollsPerSecond == 0U) {
+        throw std::invalid_argument("A gamepad must be polled at least once per second");
+    }
+    // Only started once the rate is known to be valid, since the thread divides by it.
+    this->thread = std::thread(&GamepadPoller::run, this);
+}
+
+GamepadPoller::~GamepadPoller() {
+    this->stopping.store(true, std::memory_order_release);
+    this->thread.join();
+}
+
+void GamepadPoller::run() {
+    GamepadSample queued;
+    Uint64 nextPoll = SDL_GetTicksNS();
+    while (!this->stopping.load(std::memory_order_acquire)) {
+        GamepadSample sample;
+        // SDL's joystick state is shared with the main thread, which updates it while pumping events.
+        SDL_LockJoysticks();
+        SDL_UpdateGamepads();
+        sample.timestamp = SDL_GetTicksNS();
+        for (int button = 0; button < SDL_GAMEPAD_BUTTON_COUNT; ++button) {
+            if (SDL_GetGamepadButton(this->gamepad, static_cast<SDL_GamepadButton>(button))) {
+                sample.buttons |= 1U << button;
+            }
+        }
+        const Sint16 leftX = SDL_GetGamepadAxis(this->gamepad, SDL_GAMEPAD_AXIS_LEFTX);
+        const Sint16 leftY = SDL_GetGamepadAxis(this->gamepad, SDL_GAMEPAD_AXIS_LEFTY);
+        SDL_UnlockJoysticks();
+        sample.stickLeft = leftX <= thresholdNegative;
+        sample.stickRight = leftX >= thresholdPositive;
+        sample.stickUp = leftY <= thresholdNegative;
+        sample.stickDown = leftY >= thresholdPositive;
+        // Only remember what was queued once it actually was, so that a full queue delays a change instead of losing it.
+        if ((sample.buttons != queued.buttons
+             || sample.stickLeft != queued.stickLeft || sample.stickRight != queued.stickRight
+             || sample.stickUp != queued.stickUp || sample.stickDown != queued.stickDown)
+            && this->samples.tryPush(sample)) {
+            queued = sample;
+        }
+
+        nextPoll += SDL_NS_PER_SECOND / this->pollsPerSecond;
+        const Uint64 now = SDL_GetTicksNS();
+        if (nextPoll > now) {
+            SDL_DelayPrecise(nextPoll - now);
+        } else {
+            // Fell behind, so poll again right away rather than bunching up polls to catch up.
+            nextPoll = now;
+        }
+    }
+}
+
+bool GamepadPoller::takeSample(GamepadSample& sample) {
+    return this->samples.tryPop(sample);
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "spsc_queue.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#include <SDL3/SDL.h>
+
+/**
+ * How many times per second a @c GamepadPoller reads its gamepad by default.
+ */
+constexpr Uint64 defaultPollsPerSecond = 1000U;
+/**
+ * The most samples waiting between a @c GamepadPoller and the simulation, more than a second of constant change.
+ */
+constexpr size_t gamepadSampleQueueLength = 1024UZ;
+
+/**
+ * The state of a gamepad at one moment.
+ */
+struct GamepadSample {
+    Uint64 timestamp = 0U; /**< When the gamepad was read, in nanoseconds (from @c SDL_GetTicksNS ). */
+    uint32_t buttons = 0U; /**< The buttons held, with bit @c n for the @c SDL_GamepadButton @c n . */
+    bool stickLeft = false; /**< Whether the left stick is pushed left past @c thresholdNegative . */
+    bool stickRight = false; /**< Whether the left stick is pushed right past @c thresholdPositive . */
+    bool stickUp = false; /**< Whether the left stick is pushed up past @c thresholdNegative . */
+    bool stickDown = false; /**< Whether the left stick is pushed down past @c thresholdPositive . */
+};
+
+static_assert(SDL_GAMEPAD_BUTTON_COUNT <= 32, "Every gamepad button must fit in GamepadSample::buttons");
+
+/**
+ * Reads a gamepad on its own thread at a fixed rate, and hands every change to the simulation through a lock-free
+ * queue. Since the thread updates the gamepad itself instead of waiting for the main thread to pump events, inputs
+ * keep being read and timestamped while a frame stalls, for example on a slow present.
+ *
+ * The stick is turned into directions with the same thresholds as @c ControllerCommandInputParser , and only changes
+ * to those directions or to the buttons are queued, so that the noise of a stick at rest does not fill the queue. The
+ * gamepad is read with the joysticks locked, since the main thread keeps pumping events at the same time. If the queue is full, the change is queued once there is room, so the latest state always
+ * gets through, but presses and releases in between can be lost.
+ */
+class GamepadPoller {
+private:
+    SDL_Gamepad* const gamepad; /**< The gamepad to read, which must outlive the poller. */
+    const Uint64 pollsPerSecond; /**< How many times per second to read the gamepad. */
+    SpscQueue<GamepadSample, gamepadSampleQueueLength> samples; /**< The changes not yet taken by the simulation. */
+    std::atomic<bool> stopping = false; /**< Whether the thread is meant to exit. */
+    std::thread thread; /**< The thread reading the gamepad. */
+    /**
+     * Reads the gamepad until the poller stops.
+     */
+    void run();
+public:
+    /**
+     * Starts reading a gamepad.
+     * @param gamepad The gamepad to read, which must outlive the poller.
+     * @param pollsPerSecond How many times per second to read the gamepad.
+     * @exception std::invalid_argument @c pollsPerSecond is 0.
+     */
+    explicit GamepadPoller(SDL_Gamepad* gamepad, Uint64 pollsPerSecond = defaultPollsPerSecond);
+    /**
+     * Stops reading the gamepad.
+     */
+    ~GamepadPoller();
+    GamepadPoller(const GamepadPoller&) = delete;
+    GamepadPoller& operator=(const GamepadPoller&) = delete;
+    /**
+     * Takes the oldest change. Only to be called by one thread, usually the one running the simulation.
+     * @param sample Where to put the change.
+     * @return Whether there was a change.
+     */
+    bool takeSample(GamepadSample& sample);
+};
@@ -0,0 +1,402 @@
+#include "batch_runner.hpp"
+#include "desync.hpp"
+#include "replay.hpp"
+#include "input_history.hpp"
+#include "roster.hpp"
+#include "scalar.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/**
+ * Reads a script of inputs from a file.
+ * @param path The path of the script, an empty string for no inputs.
+ * @return The inputs in the script.
+ * @exception std::runtime_error The file could not be opened.
+ * @exception std::invalid_argument A line of the script is malformed.
+ */
+static std::vector<InputHistoryEntry> loadScript(const std::string& path) {
+    if (path.empty()) {
+        return {};
+    }
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error("Could not open input script " + path);
+    }
+    return readInputScript(file);
+}
+
+/**
+ * Splits a comma-separated list of character names.
+ * @param list The names, for example @c Debuggy,Godette .
+ * @return The names, in order.
+ */
+static std::vector<std::string> splitRoster(const std::string& list) {
+    std::vector<std::string> roster;
+    std::istringstream names(list);
+    std::string name;
+    while (std::getline(names, name, ',')) {
+        if (!name.empty()) {
+            roster.push_back(name);
+        }
+    }
+    return roster;
+}
+
+/**
+ * Writes the hash of every frame of a match to a file, one hexadecimal number per line.
+ * @param path The path of the file.
+ * @param hashes The hash of each frame.
+ * @exception std::runtime_error The file could not be written.
+ */
+static void writeFrameHashes(const std::string& path, const std::vector<uint64_t>& hashes) {
+    std::ofstream file(path);
+    if (!file) {
+        throw std::runtime_error("Could not open " + path + " for writing");
+    }
+    file << "# FOSS Fight frame hashes, " << (FOSS_FIGHT_FIXED_POINT ? "fixed-point" : "float") << " physics" << std::endl;
+    for (const uint64_t hash : hashes) {
+        file << std::hex << std::setw(16) << std::setfill('0') << hash << std::endl;
+    }
+}
+
+/**
+ * Reads the hash of every frame of a match from a file written by @c writeFrameHashes .
+ * @param path The path of the file.
+ * @return The hash of each frame.
+ * @exception std::runtime_error The file could not be opened.
+ * @exception std::invalid_argument A line is not a hash.
+ */
+static std::vector<uint64_t> readFrameHashes(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error("Could not open " + path);
+    }
+    std::vector<uint64_t> hashes;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line.front() == '#') {
+            continue;
+        }
+        size_t parsed = 0UZ;
+        hashes.push_back(std::stoull(line, &parsed, 16));
+        if (parsed != line.size()) {
+            throw std::invalid_argument("Invalid frame hash: " + line);
+        }
+    }
+    return hashes;
+}
+
+/**
+ * Prints where two records of a match first differ.
+ * @param desync Where the records differ.
+ * @param expectedName What the reference record is.
+ * @param actualName What the record being checked is.
+ */
+static void printDesync(const Desync& desync, const std::string& expectedName, const std::string& actualName) {
+    std::cerr << "Frame " << desync.frame << " differs between " << expectedName << " and " << actualName;
+    if (desync.expectedChecksum == desync.actualChecksum) {
+        std::cerr << ": only one of them has this frame" << std::endl;
+        return;
+    }
+    std::cerr << ": checksum " << std::hex << desync.expectedChecksum << " -> " << desync.actualChecksum << std::dec << std::endl;
+    for (const FieldDifference& difference : desync.fields) {
+        std::cerr << "  " << difference << std::endl;
+    }
+    if (desync.fields.empty()) {
+        std::cerr << "  Saved states match, so only the active boxes differ, or no states were recorded" << std::endl;
+    }
+}
+
+/**
+ * Plays the match that the determinism checks look at.
+ * @param config What to play, if there is no replay.
+ * @param replay The replay to play, @c nullptr to play the first match of the batch.
+ * @param trace Where to record the match after every frame.
+ */
+static void playCheckedMatch(const BatchConfig& config, const Replay* replay, FrameTrace* trace) {
+    if (replay != nullptr) {
+        playReplay(*replay, trace);
+    } else {
+        playBatchMatch(config, 0UZ, trace);
+    }
+}
+
+/**
+ * Plays a replay over and over, to measure how fast the simulation runs.
+ * @param replay The replay to play.
+ * @param times How many times to play it.
+ */
+static void benchmarkReplay(const Replay& replay, const size_t times) {
+    MatchResult result;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0UZ; i < times; ++i) {
+        result = playReplay(replay);
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << replay.characters[0] << " vs " << replay.characters[1] << ": " << result.frames << " frames, "
+              << result.player1Health << " to " << result.player2Health << " health" << std::endl;
+    const double ticks = static_cast<double>(result.frames) * static_cast<double>(times);
+    std::cout << "Played the replay " << times << " time(s), " << ticks << " ticks in " << elapsed.count() << " s" << std::endl;
+    if (elapsed.count() > 0.0) {
+        std::cout << "Ticks per second: " << ticks / elapsed.count()
+                  << " (" << ticks / elapsed.count() / 60.0 << "x real time)" << std::endl;
+    }
+}
+
+/**
+ * Plays the first match of a batch again and checks every frame against recorded hashes.
+ * @param config What to play.
+ * @param replay The replay to play instead, or @c nullptr .
+ * @param path The path of the recorded hashes.
+ * @return Whether every frame matched.
+ */
+static bool verifyFrameHashes(const BatchConfig& config, const Replay* replay, const std::string& path) {
+    FrameTrace expected;
+    expected.checksums = readFrameHashes(path);
+    FrameTrace actual;
+    playCheckedMatch(config, replay, &actual);
+    const Desync desync = findDesync(expected, actual);
+    if (desync.found) {
+        printDesync(desync, path, "this run");
+        return false;
+    }
+    std::cout << "All " << actual.checksums.size() << " frames match " << path << std::endl;
+    return true;
+}
+
+/**
+ * Plays the first match of a batch again and checks every frame against a recorded trace, field by field.
+ * @param config What to play.
+ * @param replay The replay to play instead, or @c nullptr .
+ * @param path The path of the trace from @c writeFrameTrace .
+ * @return Whether every frame matched.
+ * @exception std::runtime_error The file could not be opened.
+ * @exception std::invalid_argument The file is not a trace from this kind of build.
+ */
+static bool verifyFrameTrace(const BatchConfig& config, const Replay* replay, const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Could not open " + path);
+    }
+    const FrameTrace expected = readFrameTrace(file);
+    FrameTrace actual;
+    actual.keepStates = true;
+    playCheckedMatch(config, replay, &actual);
+    const Desync desync = findDesync(expected, actual);
+    if (desync.found) {
+        printDesync(desync, path, "this run");
+        return false;
+    }
+    std::cout << "All " << actual.checksums.size() << " frames match " << path << std::endl;
+    return true;
+}
+
+/**
+ * Plays the first match of a batch on two separate instances and checks that every frame is the same, to catch
+ * state that leaks between matches or is never initialized.
+ * @param config What to play.
+ * @param replay The replay to play instead, or @c nullptr .
+ * @return Whether every frame matched.
+ */
+static bool compareInstances(const BatchConfig& config, const Replay* replay) {
+    FrameTrace first;
+    first.keepStates = true;
+    FrameTrace second;
+    second.keepStates = true;
+    playCheckedMatch(config, replay, &first);
+    playCheckedMatch(config, replay, &second);
+    const Desync desync = findDesync(first, second);
+    if (desync.found) {
+        printDesync(desync, "the first instance", "the second instance");
+        return false;
+    }
+    std::cout << "Both instances match on all " << first.checksums.size() << " frames" << std::endl;
+    return true;
+}
+
+/**
+ * Prints how to use the headless driver.
+ * @param program The name the program was started with.
+ */
+static void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [options]" << std::endl
+              << "  --roster <a,b,...>  Characters to play against each other, mirrors included (default: Debuggy)" << std::endl
+              << "  --character <name>  Shorthand for a roster of one character" << std::endl
+              << "  --p1 <file>         Input script for player 1 (default: neutral, or random with --random)" << std::endl
+              << "  --p2 <file>         Input script for player 2 (default: neutral, or random with --random)" << std::endl
+              << "  --random            Mash random inputs for players without a script" << std::endl
+              << "  --seed <n>          Seed of the random inputs (default: 0)" << std::endl
+              << "  --ticks <n>         Frames to simulate per match (default: 3600)" << std::endl
+              << "  --matches <n>       Number of matches to run per pair of characters (default: 1)" << std::endl
+              << "  --threads <n>       Number of threads, 0 for one per hardware thread (default: 0)" << std::endl
+              << "  --characters <dir>  Directory of the character packs (default: characters next to the program)" << std::endl
+              << "Replays:" << std::endl
+              << "  --record-replay <file>  Record the inputs of the first match" << std::endl
+              << "  --replay <file>         Play a replay --matches times instead of the batch, as fast as possible" << std::endl
+              << "Determinism check (plays only the replay or the first match, on one thread):" << std::endl
+              << "  --record-hashes <file>  Write the hash of the state after every frame" << std::endl
+              << "  --verify-hashes <file>  Check the state after every frame against recorded hashes" << std::endl
+              << "  --record-trace <file>   Write the hash and the whole state after every frame" << std::endl
+              << "  --verify-trace <file>   Check every frame against a recorded trace, listing the fields that differ" << std::endl
+              << "  --compare-instances     Play the match on two instances and check that every frame is the same" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    BatchConfig config;
+    std::string player1Script;
+    std::string player2Script;
+    std::string recordHashes;
+    std::string verifyHashes;
+    std::string recordTrace;
+    std::string verifyTrace;
+    bool checkInstances = false;
+    std::string recordReplay;
+    std::string replayPath;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string argument = argv[i];
+        if (argument == "--help" || argument == "-h") {
+            printUsage(argv[0]);
+            return 0;
+        }
+        if (argument == "--random") {
+            config.randomInputs = true;
+            continue;
+        }
+        if (argument == "--compare-instances") {
+            checkInstances = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Error: missing value for " << argument << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+        const std::string value = argv[++i];
+        if (argument == "--roster") {
+            config.roster = splitRoster(value);
+        } else if (argument == "--character") {
+            config.roster = {value};
+        } else if (argument == "--p1") {
+            player1Script = value;
+        } else if (argument == "--p2") {
+            player2Script = value;
+        } else if (argument == "--seed") {
+            config.seed = static_cast<uint_fast32_t>(std::strtoul(value.c_str(), nullptr, 10));
+        } else if (argument == "--ticks") {
+            config.ticks = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (argument == "--matches") {
+            config.matchesPerPairing = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (argument == "--threads") {
+            config.threads = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (argument == "--characters") {
+            setCharacterDirectory(value);
+        } else if (argument == "--record-hashes") {
+            recordHashes = value;
+        } else if (argument == "--verify-hashes") {
+            verifyHashes = value;
+        } else if (argument == "--record-replay") {
+            recordReplay = value;
+        } else if (argument == "--replay") {
+            replayPath = value;
+        } else if (argument == "--record-trace") {
+            recordTrace = value;
+        } else if (argument == "--verify-trace") {
+            verifyTrace = value;
+        } else {
+            std::cerr << "Error: unknown option " << argument << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (config.roster.empty() || config.matchesPerPairing == 0UZ) {
+        std::cerr << "Error: nothing to play" << std::endl;
+        return 1;
+    }
+
+    try {
+        config.player1Script = loadScript(player1Script);
+        config.player2Script = loadScript(player2Script);
+        std::optional<Replay> replay;
+        if (!replayPath.empty()) {
+            replay.emplace(loadReplay(replayPath));
+            if (replay->buildHash != replayBuildHash()) {
+                std::cerr << "Warning: " << replayPath << " was recorded with a different build, and may not play back the same" << std::endl;
+            }
+        }
+        const Replay* checkedReplay = replay.has_value() ? &replay.value() : nullptr;
+
+        if (!recordReplay.empty()) {
+            ReplayRecorder recorder({config.roster[0], config.roster[0]}, {0U, 0U});
+            playBatchMatch(config, 0UZ, nullptr, &recorder);
+            saveReplay(recordReplay, recorder.getReplay());
+            std::cout << "Recorded " << recorder.getReplay().frames << " frames to " << recordReplay << std::endl;
+            return 0;
+        }
+
+        if (!recordHashes.empty()) {
+            FrameTrace trace;
+            playCheckedMatch(config, checkedReplay, &trace);
+            writeFrameHashes(recordHashes, trace.checksums);
+            std::cout << "Recorded " << trace.checksums.size() << " frame hashes to " << recordHashes << std::endl;
+            return 0;
+        }
+        if (!verifyHashes.empty()) {
+            return verifyFrameHashes(config, checkedReplay, verifyHashes) ? 0 : 1;
+        }
+        if (!recordTrace.empty()) {
+            FrameTrace trace;
+            trace.keepStates = true;
+            playCheckedMatch(config, checkedReplay, &trace);
+            std::ofstream file(recordTrace, std::ios::binary);
+            if (!file) {
+                throw std::runtime_error("Could not open " + recordTrace + " for writing");
+            }
+            writeFrameTrace(file, trace);
+            std::cout << "Recorded " << trace.checksums.size() << " frames to " << recordTrace << std::endl;
+            return 0;
+        }
+        if (!verifyTrace.empty()) {
+            return verifyFrameTrace(config, checkedReplay, verifyTrace) ? 0 : 1;
+        }
+        if (checkInstances) {
+            return compareInstances(config, checkedReplay) ? 0 : 1;
+        }
+        if (checkedReplay != nullptr) {
+            benchmarkReplay(*checkedReplay, config.matchesPerPairing);
+            return 0;
+        }
+
+        const BatchReport report = runBatch(config);
+
+        for (const PairingResult& pairing : report.pairings) {
+            std::cout << pairing.player1 << " vs " << pairing.player2 << ": " << pairing.matches << " match(es), "
+                      << pairing.player1Wins << " P1 win(s), " << pairing.player2Wins << " P2 win(s), "
+                      << pairing.draws << " draw(s)" << std::endl;
+        }
+        std::cout << "Simulated " << report.matches << " match(es), " << report.frames << " ticks in "
+                  << report.seconds << " s on " << report.threads << " thread(s)" << std::endl;
+        if (report.seconds > 0.0) {
+            std::cout << "Matches per second: " << static_cast<double>(report.matches) / report.seconds << std::endl
+                      << "Ticks per second: " << static_cast<double>(report.frames) / report.seconds
+                      << " (" << static_cast<double>(report.frames) / report.seconds / 60.0 << "x real time)" << std::endl;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -1,10 +1,21 @@
 #include "input_history.hpp"
 
+#include <algorithm>
+#include <istream>
 #include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
 #include <vector>
 
 ButtonGroup::ButtonGroup() : lightPunch{false}, heavyPunch{false}, lightKick{false}, heavyKick{false} {}
 
+ButtonGroup::ButtonGroup(const unsigned char bitfield)
+    : lightPunch{(bitfield & (1U << 3U)) != 0U},
+      heavyPunch{(bitfield & (1U << 1U)) != 0U},
+      lightKick{(bitfield & (1U << 2U)) != 0U},
+      heavyKick{(bitfield & 1U) != 0U} {}
+
 unsigned char ButtonGroup::toBitfield() const {
     return (this->heavyKick) | (this->heavyPunch << 1U) | (this->lightKick << 2U) | (this->lightPunch << 3U);
 }
@@ -65,10 +76,15 @@ bool operator==(const ButtonGroup& lhs, const ButtonGroup& rhs) {
            lhs.getHeavyKick() == rhs.getHeavyKick();
 }
 
+InputHistoryEntry::InputHistoryEntry() : direction{NEUTRAL}, duration{0U}, button{ButtonGroup()} {}
+
 InputHistoryEntry::InputHistoryEntry(Direction direction, ButtonGroup button)
     : direction{direction}, duration{0U}, button{button} {}
 
-void InputHistoryEntry::incrementDuration() { if (this->duration < 9999U) { ++this->duration; } }
+InputHistoryEntry::InputHistoryEntry(Direction direction, ButtonGroup button, const unsigned short duration)
+    : direction{direction}, duration{duration}, button{button} {}
+
+void InputHistoryEntry::incrementDuration() { if (this->duration < maxInputDuration) { ++this->duration; } }
 
 Direction InputHistoryEntry::getDirection() const { return this->direction; }
 
@@ -85,16 +101,112 @@ bool operator==(const InputHistoryEntry& lhs, const InputHistoryEntry& rhs) {
     return lhs.getDirection() == rhs.getDirection() && lhs.getButton() == rhs.getButton();
 }
 
-InputHistory::InputHistory() : history{} {}
+uint8_t packInput(const Direction direction, const ButtonGroup button) {
+    return static_cast<uint8_t>((direction << 4) | button.toBitfield());
+}
+
+Direction unpackDirection(const uint8_t input) {
+    const uint8_t direction = input >> 4;
+    if (direction < DOWN_BACK || direction > UP_FORWARD) {
+        return NEUTRAL;
+    }
+    return static_cast<Direction>(direction);
+}
+
+ButtonGroup unpackButtons(const uint8_t input) {
+    return ButtonGroup(static_cast<unsigned char>(input & 0x0FU));
+}
+
+InputHistory::InputHistory() : entries{} {}
+
+void InputHistory::store(const size_t slot, const InputHistoryEntry& entry) {
+    this->entries[slot] = entry;
+    this->entries[slot + inputHistoryCapacity] = entry;
+}
 
 void InputHistory::addEntry(InputHistoryEntry entry) {
-    if (!this->history.empty() && this->history.back() == entry) {
-        this->history.back().incrementDuration();
-    } else {
-        this->history.push_back(entry);
+    if (this->count != 0UZ) {
+        const size_t last = (this->next - 1UZ) & (inputHistoryCapacity - 1UZ);
+        InputHistoryEntry& previous = this->entries[last];
+        if (previous == entry) {
+            previous.incrementDuration();
+            this->entries[last + inputHistoryCapacity] = previous;
+            return;
+        }
     }
+    this->store(this->next, entry);
+    this->next = (this->next + 1UZ) & (inputHistoryCapacity - 1UZ);
+    this->count = std::min(this->count + 1UZ, inputHistoryCapacity);
 }
 
-std::vector<InputHistoryEntry> InputHistory::getHistory() {
-    return this->history;
-}
\ No newline at end of file
+std::span<const InputHistoryEntry> InputHistory::getHistory() const {
+    return this->getRecent(this->count);
+}
+
+std::span<const InputHistoryEntry> InputHistory::getRecent(size_t count) const {
+    count = std::min(count, this->count);
+    return std::span<const InputHistoryEntry>(this->entries.data() + this->next + inputHistoryCapacity - count, count);
+}
+
+size_t InputHistory::size() const { return this->count; }
+
+uint8_t InputHistory::getLastInput() const {
+    if (this->count == 0UZ) {
+        return neutralInput;
+    }
+    const InputHistoryEntry& last = this->entries[this->next + inputHistoryCapacity - 1UZ];
+    return packInput(last.getDirection(), last.getButton());
+}
+
+void InputHistory::saveState(InputHistoryState& state) const {
+    const std::span<const InputHistoryEntry> recent = this->getRecent(savedInputHistoryLength);
+    for (size_t i = 0UZ; i < recent.size(); ++i) {
+        state.inputs[i] = packInput(recent[i].getDirection(), recent[i].getButton());
+        state.durations[i] = recent[i].getDuration();
+    }
+    for (size_t i = recent.size(); i < savedInputHistoryLength; ++i) {
+        state.inputs[i] = 0U;
+        state.durations[i] = 0U;
+    }
+    state.count = static_cast<uint8_t>(recent.size());
+    state.reserved = 0U;
+}
+
+void InputHistory::loadState(const InputHistoryState& state) {
+    this->count = std::min(static_cast<size_t>(state.count), savedInputHistoryLength);
+    this->next = this->count & (inputHistoryCapacity - 1UZ);
+    for (size_t i = 0UZ; i < this->count; ++i) {
+        this->store(i, InputHistoryEntry(unpackDirection(state.inputs[i]), unpackButtons(state.inputs[i]), state.durations[i]));
+    }
+}
+
+std::vector<InputHistoryEntry> readInputScript(std::istream& is) {
+    std::vector<InputHistoryEntry> script;
+    std::string line;
+    size_t lineNumber = 0UZ;
+    while (std::getline(is, line)) {
+        ++lineNumber;
+        if (line.empty() || line.front() == '#') {
+            continue;
+        }
+        std::istringstream fields(line);
+        std::string input;
+        unsigned short duration;
+        if (!(fields >> input >> duration) || input.front() < '1' || input.front() > '9') {
+            throw std::invalid_argument(std::string("Invalid input on line ") + std::to_string(lineNumber) + ": " + line);
+        }
+        const std::string buttons = input.substr(1UZ);
+        bool found = false;
+        for (unsigned char bitfield = 0U; bitfield < 16U; ++bitfield) {
+            if (buttons == ButtonGroup(bitfield).toString()) {
+                script.emplace_back(static_cast<Direction>(input.front() - '0'), ButtonGroup(bitfield), duration);
+                found = true;
+                break;
+            }
+        }
+        if (!found) {
+            throw std::invalid_argument(std::string("Invalid buttons on line ") + std::to_string(lineNumber) + ": " + buttons);
+        }
+    }
+    return script;
+}
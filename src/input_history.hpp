@@ -1,6 +1,10 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
+#include <istream>
 #include <ostream>
+#include <span>
 #include <vector>
 
 /**
@@ -27,17 +31,21 @@ private:
     bool heavyPunch = false; /**< The heavy punch button. */
     bool lightKick = false; /**< The light kick button. */
     bool heavyKick = false; /**< The heavy kick button. */
-
-    /**
-     * Converts buttons to numbers.
-     * @return A number representing the current buttons being held.
-     */
-    unsigned char toBitfield() const;
 public:
     /**
      * Constructs a button with all buttons as @c false .
      */
     ButtonGroup();
+    /**
+     * Constructs a button out of a number from @c ButtonGroup::toBitfield .
+     * @param bitfield The buttons being held, with LP as bit 3, LK as bit 2, HP as bit 1 and HK as bit 0.
+     */
+    explicit ButtonGroup(unsigned char bitfield);
+    /**
+     * Converts buttons to numbers.
+     * @return A number representing the current buttons being held.
+     */
+    unsigned char toBitfield() const;
     /**
      * Destructs a button.
      */
@@ -101,23 +109,39 @@ public:
  */
 bool operator==(const ButtonGroup& lhs, const ButtonGroup& rhs);
 
+/**
+ * The longest an input history entry can last after its first frame. Holding an input for longer does not count.
+ */
+constexpr unsigned short maxInputDuration = 9999U;
+
 /**
  * One entry of input history.
  */
 class InputHistoryEntry {
 public:
+    /**
+     * Creates an entry of holding nothing, for filling empty slots of an @c InputHistory .
+     */
+    InputHistoryEntry();
     /**
      * Creates an entry in the input history.
      * @param direction The direction of this input.
      * @param button The button of this input.
      */
     InputHistoryEntry(Direction direction, ButtonGroup button);
+    /**
+     * Creates an entry in the input history that has already lasted a while.
+     * @param direction The direction of this input.
+     * @param button The button of this input.
+     * @param duration How many frames the input lasts after its first one.
+     */
+    InputHistoryEntry(Direction direction, ButtonGroup button, unsigned short duration);
     /**
      * Destroys an input history entry.
      */
     ~InputHistoryEntry() = default;
     /**
-     * Adds 1 frame to the duration of this entry.
+     * Adds 1 frame to the duration of this entry, up to @c maxInputDuration .
      */
     void incrementDuration();
     /**
@@ -136,9 +160,9 @@ public:
      */
     ButtonGroup getButton() const;
 private:
-    const Direction direction; /**< The direction of this entry. */
+    Direction direction; /**< The direction of this entry. */
     unsigned short duration; /**< The duration of this entry. */
-    const ButtonGroup button; /**< The buttons of this entry. */
+    ButtonGroup button; /**< The buttons of this entry. */
     /**
      * Outputs the entry to a @c std::ostream& .
      * @param os The @c std::ostream& to output to.
@@ -151,7 +175,60 @@ private:
 bool operator==(const InputHistoryEntry& lhs, const InputHistoryEntry& rhs);
 
 /**
- * A collection of @c InputHistoryEntry s.
+ * Packs one frame of input into a byte, for saving and sending over the network.
+ * @param direction The direction being held.
+ * @param button The buttons being held.
+ * @return The direction in the high 4 bits, and the buttons (from @c ButtonGroup::toBitfield ) in the low 4 bits.
+ */
+uint8_t packInput(Direction direction, ButtonGroup button);
+
+/**
+ * Gets the direction out of a byte from @c packInput .
+ * @param input The packed input.
+ * @return The direction being held, @c NEUTRAL if the byte is not a valid input.
+ */
+Direction unpackDirection(uint8_t input);
+
+/**
+ * Gets the buttons out of a byte from @c packInput .
+ * @param input The packed input.
+ * @return The buttons being held.
+ */
+ButtonGroup unpackButtons(uint8_t input);
+
+/**
+ * A packed input of holding nothing.
+ */
+constexpr uint8_t neutralInput = NEUTRAL << 4;
+
+/**
+ * The number of most recent entries kept when saving an @c InputHistory .
+ */
+constexpr size_t savedInputHistoryLength = 32UZ;
+
+/**
+ * A fixed-size copy of the most recent entries of an @c InputHistory , which can be copied with @c std::memcpy .
+ */
+struct InputHistoryState {
+    std::array<uint16_t, savedInputHistoryLength> durations; /**< The duration of each entry, oldest first. */
+    std::array<uint8_t, savedInputHistoryLength> inputs; /**< The direction and buttons of each entry from @c packInput , oldest first. */
+    uint8_t count; /**< The number of entries saved. */
+    uint8_t reserved; /**< Always 0, so that the state has no padding and can be compared or hashed byte by byte. */
+};
+
+/**
+ * The number of most recent entries kept by an @c InputHistory . A power of two, so that wrapping around is a mask.
+ */
+constexpr size_t inputHistoryCapacity = 64UZ;
+
+static_assert((inputHistoryCapacity & (inputHistoryCapacity - 1UZ)) == 0UZ, "inputHistoryCapacity must be a power of two");
+static_assert(inputHistoryCapacity >= savedInputHistoryLength, "InputHistory must keep every entry that is saved");
+
+/**
+ * The most recent @c InputHistoryEntry s, in a ring buffer that never allocates.
+ *
+ * Every entry is stored twice, @c inputHistoryCapacity slots apart, so that the most recent entries are always
+ * contiguous and can be viewed as a span no matter where the ring wraps around.
  */
 class InputHistory {
 public:
@@ -164,15 +241,61 @@ public:
      */
     ~InputHistory() = default;
     /**
-     * Adds an entry, incrementing the previous one if identical.
+     * Adds an entry, incrementing the previous one if identical. Once full, the oldest entry is dropped.
      * @param entry The entry to add.
      */
     void addEntry(InputHistoryEntry entry);
     /**
-     * Gets the input history.
-     * @return The history of the inputs.
+     * Gets every entry kept.
+     * @return The last @c inputHistoryCapacity entries at most, oldest first, valid until the next change.
+     */
+    std::span<const InputHistoryEntry> getHistory() const;
+    /**
+     * Gets the most recent entries.
+     * @param count The most entries to get.
+     * @return Up to @p count entries, oldest first, valid until the next change.
+     */
+    std::span<const InputHistoryEntry> getRecent(size_t count) const;
+    /**
+     * Gets the number of entries kept.
+     * @return The number of entries, at most @c inputHistoryCapacity .
+     */
+    size_t size() const;
+    /**
+     * Gets the most recent input.
+     * @return The direction and buttons of the last entry from @c packInput , @c neutralInput if there are none.
+     */
+    uint8_t getLastInput() const;
+    /**
+     * Saves the most recent entries.
+     * @param state Where to save the entries.
      */
-    std::vector<InputHistoryEntry> getHistory();
+    void saveState(InputHistoryState& state) const;
+    /**
+     * Replaces the history with saved entries. Entries older than the saved ones are dropped.
+     * @param state The entries to restore.
+     */
+    void loadState(const InputHistoryState& state);
 private:
-    std::vector<InputHistoryEntry> history; /**< The history of the inputs. */
-};
\ No newline at end of file
+    alignas(64) std::array<InputHistoryEntry, inputHistoryCapacity * 2UZ> entries; /**< Each entry, stored at its slot and again @c inputHistoryCapacity slots later. */
+    size_t next = 0UZ; /**< The slot that the next entry goes in, below @c inputHistoryCapacity . */
+    size_t count = 0UZ; /**< The number of entries kept. */
+    /**
+     * Writes an entry to both of its slots.
+     * @param slot The slot, below @c inputHistoryCapacity .
+     * @param entry The entry.
+     */
+    void store(size_t slot, const InputHistoryEntry& entry);
+};
+
+/**
+ * Reads a script of inputs, one @c InputHistoryEntry per line in the same format it is printed in.
+ *
+ * Each line is a direction in numpad notation, the buttons from @c ButtonGroup::toString , a space, and how many
+ * frames the input lasts after its first one (for example, @c 2LP @c 0 is a single frame of crouching light punch).
+ * Blank lines and lines starting with @c # are ignored.
+ * @param is The stream to read from.
+ * @return The inputs of the script, in order.
+ * @exception std::invalid_argument A line is not a valid input.
+ */
+std::vector<InputHistoryEntry> readInputScript(std::istream& is);
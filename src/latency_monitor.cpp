@@ -0,0 +1,134 @@
+#include "latency_monitor.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <ostream>
+#include <vector>
+
+#include <SDL3/SDL.h>
+
+/**
+ * The name of each stage, in the order of @c LatencyStage .
+ */
+constexpr std::array<const char*, LATENCY_STAGE_COUNT> latencyStageNames = {"event->tick", "tick->submit", "submit->present", "event->present"};
+
+void LatencyMonitor::inputSampled(const Uint64 tick, const Uint64 eventTime, const Uint64 tickTime) {
+    if (this->hasPending) {
+        return;
+    }
+    this->pending.tick = tick;
+    this->pending.eventTime = eventTime;
+    this->pending.tickTime = tickTime;
+    this->hasPending = true;
+}
+
+void LatencyMonitor::frameSubmitted(const Uint64 now) {
+    this->pending.submitTime = now;
+}
+
+void LatencyMonitor::framePresented(const Uint64 now) {
+    if (!this->hasPending) {
+        return;
+    }
+    const Uint64 index = this->written.load(std::memory_order_relaxed);
+    // Pairs with the fence in getSamples, so that a reader that sees any part of this frame also sees the count
+    // published before it, and knows to leave the slot out.
+    std::atomic_thread_fence(std::memory_order_release);
+    Slot& slot = this->slots[index % latencyHistoryLength];
+    slot.tick.store(this->pending.tick, std::memory_order_relaxed);
+    slot.eventTime.store(this->pending.eventTime, std::memory_order_relaxed);
+    slot.tickTime.store(this->pending.tickTime, std::memory_order_relaxed);
+    slot.submitTime.store(this->pending.submitTime, std::memory_order_relaxed);
+    slot.presentTime.store(now, std::memory_order_relaxed);
+    this->written.store(index + 1U, std::memory_order_release);
+    this->hasPending = false;
+}
+
+std::vector<LatencySample> LatencyMonitor::getSamples() const {
+    const Uint64 end = this->written.load(std::memory_order_acquire);
+    const Uint64 start = end > latencyHistoryLength ? end - latencyHistoryLength : 0U;
+    std::vector<LatencySample> samples;
+    samples.reserve(static_cast<size_t>(end - start));
+    for (Uint64 index = start; index < end; ++index) {
+        const Slot& slot = this->slots[index % latencyHistoryLength];
+        samples.push_back(LatencySample(slot.tick.load(std::memory_order_relaxed),
+                                        slot.eventTime.load(std::memory_order_relaxed),
+                                        slot.tickTime.load(std::memory_order_relaxed),
+                                        slot.submitTime.load(std::memory_order_relaxed),
+                                        slot.presentTime.load(std::memory_order_relaxed)));
+    }
+    // Anything measured while copying went over the oldest slots, which may now hold a mix of two frames, and the frame
+    // being measured right now, which is not counted yet, may be halfway through going over the slot after those.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const Uint64 after = this->written.load(std::memory_order_relaxed);
+    const Uint64 overwritten = after + 1U > start + latencyHistoryLength ? after + 1U - start - latencyHistoryLength : 0U;
+    samples.erase(samples.begin(), samples.begin() + static_cast<std::ptrdiff_t>(std::min<Uint64>(overwritten, samples.size())));
+    return samples;
+}
+
+/**
+ * Summarizes a list of times.
+ * @param times The times, which are sorted.
+ * @return The summary.
+ */
+static LatencySummary summarizeTimes(std::vector<Uint64>& times) {
+    LatencySummary summary;
+    if (times.empty()) {
+        return summary;
+    }
+    std::sort(times.begin(), times.end());
+    summary.count = times.size();
+    summary.min = times.front();
+    summary.p50 = times[(times.size() - 1UZ) / 2UZ];
+    summary.p99 = times[(times.size() - 1UZ) * 99UZ / 100UZ];
+    summary.max = times.back();
+    return summary;
+}
+
+std::array<LatencySummary, LATENCY_STAGE_COUNT> LatencyMonitor::summarize() const {
+    const std::vector<LatencySample> samples = this->getSamples();
+    std::array<std::vector<Uint64>, LATENCY_STAGE_COUNT> times;
+    for (const LatencySample& sample : samples) {
+        times[EVENT_TO_TICK].push_back(sample.tickTime - sample.eventTime);
+        times[TICK_TO_SUBMIT].push_back(sample.submitTime > sample.tickTime ? sample.submitTime - sample.tickTime : 0U);
+        times[SUBMIT_TO_PRESENT].push_back(sample.presentTime - sample.submitTime);
+        times[EVENT_TO_PRESENT].push_back(sample.presentTime - sample.eventTime);
+    }
+    std::array<LatencySummary, LATENCY_STAGE_COUNT> summaries;
+    for (size_t stage = 0UZ; stage < LATENCY_STAGE_COUNT; ++stage) {
+        summaries[stage] = summarizeTimes(times[stage]);
+    }
+    return summaries;
+}
+
+void LatencyMonitor::writeCsv(std::ostream& stream) const {
+    stream << "tick,event_ns,tick_ns,submit_ns,present_ns,event_to_present_ns\n";
+    for (const LatencySample& sample : this->getSamples()) {
+        stream << sample.tick << ',' << sample.eventTime << ',' << sample.tickTime << ',' << sample.submitTime << ','
+               << sample.presentTime << ',' << sample.presentTime - sample.eventTime << '\n';
+    }
+}
+
+void LatencyMonitor::renderOverlay(SDL_Renderer* renderer, const float x, const float y, const Uint64 now) {
+    const Uint64 written = this->written.load(std::memory_order_relaxed);
+    if (written != this->overlayWritten && now - this->overlayTime >= SDL_NS_PER_SECOND / latencyOverlayRefreshesPerSecond) {
+        this->overlaySummaries = this->summarize();
+        this->overlayWritten = written;
+        this->overlayTime = now;
+    }
+    const std::array<LatencySummary, LATENCY_STAGE_COUNT>& summaries = this->overlaySummaries;
+    // SDL_RenderDebugText draws 8x8 characters.
+    constexpr float lineHeight = 10.0F;
+    std::array<char, 96> line;
+    std::snprintf(line.data(), line.size(), "%-16s %7s %7s %7s (ms, %zu inputs)", "", "min", "p50", "p99", summaries[EVENT_TO_PRESENT].count);
+    SDL_RenderDebugText(renderer, x, y, line.data());
+    for (size_t stage = 0UZ; stage < LATENCY_STAGE_COUNT; ++stage) {
+        const LatencySummary& summary = summaries[stage];
+        std::snprintf(line.data(), line.size(), "%-16s %7.2f %7.2f %7.2f", latencyStageNames[stage],
+                      static_cast<double>(summary.min) / 1e6, static_cast<double>(summary.p50) / 1e6, static_cast<double>(summary.p99) / 1e6);
+        SDL_RenderDebugText(renderer, x, y + lineHeight * static_cast<float>(stage + 1UZ), line.data());
+    }
+}
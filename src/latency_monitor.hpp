@@ -0,0 +1,128 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#include <SDL3/SDL.h>
+
+/**
+ * The number of frames that a @c LatencyMonitor remembers.
+ */
+constexpr size_t latencyHistoryLength = 1024UZ;
+
+/**
+ * How many times per second the overlay of a @c LatencyMonitor summarizes the frames again.
+ */
+constexpr Uint64 latencyOverlayRefreshesPerSecond = 4U;
+
+/**
+ * The path of the file that the game writes its latency measurements to.
+ */
+constexpr const char* latencyCsvPath = "latency.csv";
+
+/**
+ * The times at which one input went through each part of the game, in nanoseconds (from @c SDL_GetTicksNS ).
+ */
+struct LatencySample {
+    Uint64 tick; /**< The number of the tick that used the input. */
+    Uint64 eventTime; /**< When the input's event happened. */
+    Uint64 tickTime; /**< When the tick that used the input was due. */
+    Uint64 submitTime; /**< When the first frame showing the tick was done being drawn, just before presenting it. */
+    Uint64 presentTime; /**< When @c SDL_RenderPresent returned for that frame. */
+};
+
+/**
+ * A part of the path from an input to the screen.
+ */
+enum LatencyStage {
+    EVENT_TO_TICK, /**< From the event to the tick that used it. */
+    TICK_TO_SUBMIT, /**< From the tick to the frame showing it being drawn. */
+    SUBMIT_TO_PRESENT, /**< From the frame being drawn to @c SDL_RenderPresent returning. */
+    EVENT_TO_PRESENT, /**< The whole path. */
+    LATENCY_STAGE_COUNT /**< The number of stages. */
+};
+
+/**
+ * The distribution of how long a stage took, in nanoseconds.
+ */
+struct LatencySummary {
+    size_t count = 0UZ; /**< The number of inputs measured. */
+    Uint64 min = 0U; /**< The shortest time. */
+    Uint64 p50 = 0U; /**< The median time. */
+    Uint64 p99 = 0U; /**< The time that 99% of inputs were at or under. */
+    Uint64 max = 0U; /**< The longest time. */
+};
+
+/**
+ * Measures how long inputs take to reach the screen, remembering the last @c latencyHistoryLength frames that showed
+ * a new input.
+ *
+ * Measurements are written by the thread running the game, into a ring that other threads can read without locking.
+ * Frames that may have been written over while being read, including the one being written, are left out of what is
+ * read.
+ */
+class LatencyMonitor {
+private:
+    /**
+     * A slot of the ring, whose parts can be read while they are written.
+     */
+    struct Slot {
+        std::atomic<Uint64> tick; /**< @c LatencySample::tick */
+        std::atomic<Uint64> eventTime; /**< @c LatencySample::eventTime */
+        std::atomic<Uint64> tickTime; /**< @c LatencySample::tickTime */
+        std::atomic<Uint64> submitTime; /**< @c LatencySample::submitTime */
+        std::atomic<Uint64> presentTime; /**< @c LatencySample::presentTime */
+    };
+    std::array<Slot, latencyHistoryLength> slots{}; /**< The frames measured, with frame @c n in slot @c n modulo the length. */
+    std::atomic<Uint64> written = 0U; /**< The number of frames ever measured. */
+    LatencySample pending{}; /**< The input waiting for the next frame to be presented. */
+    bool hasPending = false; /**< Whether an input is waiting for the next frame to be presented. */
+    std::array<LatencySummary, LATENCY_STAGE_COUNT> overlaySummaries{}; /**< What the overlay shows, since summarizing sorts every frame remembered. */
+    Uint64 overlayWritten = 0U; /**< The number of frames measured when the overlay was last summarized. */
+    Uint64 overlayTime = 0U; /**< When the overlay was last summarized, in nanoseconds (from @c SDL_GetTicksNS ). */
+public:
+    /**
+     * Notes that a tick used a new input. Only the oldest input until the next frame is presented is measured.
+     * @param tick The number of the tick.
+     * @param eventTime When the input's event happened, from @c BaseCommandInputParser::getInputTimestamp .
+     * @param tickTime When the tick was due.
+     */
+    void inputSampled(Uint64 tick, Uint64 eventTime, Uint64 tickTime);
+    /**
+     * Notes that a frame is done being drawn and is about to be presented.
+     * @param now The current time, in nanoseconds (from @c SDL_GetTicksNS ).
+     */
+    void frameSubmitted(Uint64 now);
+    /**
+     * Notes that a frame was presented, measuring the input that it shows, if any.
+     * @param now The current time, in nanoseconds (from @c SDL_GetTicksNS ).
+     */
+    void framePresented(Uint64 now);
+    /**
+     * Copies the frames measured. Safe to call from any thread.
+     * @return The remembered frames that showed a new input, oldest first.
+     */
+    std::vector<LatencySample> getSamples() const;
+    /**
+     * Summarizes how long each stage took over the remembered frames.
+     * @return The summary of each stage, in the order of @c LatencyStage .
+     */
+    std::array<LatencySummary, LATENCY_STAGE_COUNT> summarize() const;
+    /**
+     * Writes the remembered frames as CSV, with one row per input and times in nanoseconds.
+     * @param stream Where to write.
+     */
+    void writeCsv(std::ostream& stream) const;
+    /**
+     * Draws the summary of each stage, in milliseconds. The summary is only worked out again
+     * @c latencyOverlayRefreshesPerSecond times per second, and only if new frames were measured.
+     * @param renderer The renderer to draw with.
+     * @param x The left of the text.
+     * @param y The top of the text.
+     * @param now The current time, in nanoseconds (from @c SDL_GetTicksNS ).
+     */
+    void renderOverlay(SDL_Renderer* renderer, float x, float y, Uint64 now);
+};
@@ -1,7 +1,19 @@
 #include "character.hpp"
+#include "character_renderer.hpp"
 #include "command_input_parser.hpp"
+#include "frame_timer.hpp"
+#include "gamepad_poller.hpp"
+#include "latency_monitor.hpp"
+#include "match.hpp"
+#include "roster_loader.hpp"
 
+#include <chrono>
+#include <exception>
+#include <fstream>
+#include <future>
+#include <initializer_list>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -12,8 +24,13 @@
 #if DEBUG_CONTROLLER
 #define CHAR_CONSTRUCT(name) \
     Character* name = nullptr; \
+    CharacterRenderer* name##Renderer = nullptr; \
     try { \
-        name = new Character(#name, renderer, &controller, ground); \
+        const std::shared_ptr<const LoadedCharacter> name##Loaded = name##Load.get(); \
+        name = new Character(#name, CharacterData(name##Loaded->data), &controller, ground); \
+        name##Renderer = new CharacterRenderer(*name, renderer, name##Loaded->sheets); \
+        name##Load = std::shared_future<std::shared_ptr<const LoadedCharacter>>(); \
+        loader.release(#name); \
     } catch (const DataException<boxConstructionError>& e) { \
         std::cerr << "ERROR constructing " << #name << "! (Box Construction Error)" << std::endl << e.what() << std::endl; \
         return 1; \
@@ -35,12 +52,20 @@
     } catch (const DataException<paletteReadingError>& e) { \
         std::cerr << "ERROR constructing " << #name << "! (Palette Reading Error)" << std::endl << e.what() << std::endl; \
         return 1; \
+    } catch (const std::exception& e) { \
+        std::cerr << "ERROR constructing " << #name << "! (Loading Error)" << std::endl << e.what() << std::endl; \
+        return 1; \
     }
 #else
 #define CHAR_CONSTRUCT(name) \
     Character* name = nullptr; \
+    CharacterRenderer* name##Renderer = nullptr; \
     try { \
-        name = new Character(#name, renderer, &kip, ground); \
+        const std::shared_ptr<const LoadedCharacter> name##Loaded = name##Load.get(); \
+        name = new Character(#name, CharacterData(name##Loaded->data), &kip, ground); \
+        name##Renderer = new CharacterRenderer(*name, renderer, name##Loaded->sheets); \
+        name##Load = std::shared_future<std::shared_ptr<const LoadedCharacter>>(); \
+        loader.release(#name); \
     } catch (const DataException<boxConstructionError>& e) { \
         std::cerr << "ERROR constructing " << #name << "! (Box Construction Error)" << std::endl << e.what() << std::endl; \
         return 1; \
@@ -62,14 +87,89 @@
     } catch (const DataException<paletteReadingError>& e) { \
         std::cerr << "ERROR constructing " << #name << "! (Palette Reading Error)" << std::endl << e.what() << std::endl; \
         return 1; \
+    } catch (const std::exception& e) { \
+        std::cerr << "ERROR constructing " << #name << "! (Loading Error)" << std::endl << e.what() << std::endl; \
+        return 1; \
     }
 #endif
 
-constexpr int height = 720;
+constexpr int height = stageHeight;
 constexpr int width = height * 16 / 9;
-constexpr int groundLength = 150;
 
-constexpr unsigned int fpsDelay = 1000 / 60;
+/**
+ * Whether to wait for the display's vertical sync when presenting a frame.
+ */
+constexpr bool useVSync = true;
+/**
+ * The most frames to render per second when vsync is off, 0 to render once per simulation tick.
+ */
+constexpr unsigned int frameLimit = 0U;
+/**
+ * The most simulation ticks to run in one go after a stall, after which the missed time is dropped.
+ */
+constexpr unsigned int maxCatchUpTicks = 5U;
+/**
+ * Whether to read the gamepad on its own thread, which keeps reading inputs while a frame stalls.
+ */
+constexpr bool useGamepadPoller = true;
+/**
+ * The key that switches to the character's next palette.
+ */
+constexpr SDL_Scancode paletteKey = SDL_SCANCODE_P;
+/**
+ * The key that shows or hides how long inputs take to reach the screen.
+ */
+constexpr SDL_Scancode latencyOverlayKey = SDL_SCANCODE_F11;
+/**
+ * The key that writes how long inputs took to reach the screen to @c latencyCsvPath .
+ */
+constexpr SDL_Scancode latencyCsvKey = SDL_SCANCODE_F12;
+
+/**
+ * How many threads load characters in the background, leaving the rest of the CPU to the game.
+ */
+constexpr size_t loaderThreads = 2UZ;
+
+/**
+ * Shows how far the roster has loaded until some characters are ready, drawing one frame per tick so that the window
+ * stays responsive. Only the loading happens in the background: the characters still have to be given to the match.
+ * @param renderer The renderer to draw on.
+ * @param loader The loader of the characters.
+ * @param characters The characters to wait for.
+ * @return Whether they are ready, @c false if the window was closed first.
+ */
+static bool showLoadingScreen(SDL_Renderer* renderer, const RosterLoader& loader,
+                              const std::initializer_list<std::shared_future<std::shared_ptr<const LoadedCharacter>>> characters) {
+    const auto ready = [&characters] {
+        for (const std::shared_future<std::shared_ptr<const LoadedCharacter>>& character : characters) {
+            if (character.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                return false;
+            }
+        }
+        return true;
+    };
+    while (!ready()) {
+        SDL_Event event;
+        while (SDL_PollEvent(&event)) {
+            if (event.type == SDL_EVENT_QUIT) {
+                return false;
+            }
+        }
+        const float fraction = loader.getProgress().fraction();
+        const SDL_FRect outline(width / 4.0F, height / 2.0F - 8.0F, width / 2.0F, 16.0F);
+        const SDL_FRect bar(outline.x, outline.y, outline.w * fraction, outline.h);
+        SDL_SetRenderDrawColor(renderer, 0x00U, 0x00U, 0x00U, 0xFFU);
+        SDL_RenderClear(renderer);
+        SDL_SetRenderDrawColor(renderer, 0xFFU, 0xFFU, 0xFFU, 0xFFU);
+        SDL_RenderRect(renderer, &outline);
+        SDL_RenderFillRect(renderer, &bar);
+        SDL_RenderPresent(renderer);
+        if (!useVSync) {
+            SDL_DelayPrecise(SDL_NS_PER_SECOND / ticksPerSecond);
+        }
+    }
+    return true;
+}
 
 typedef char boxConstructionError;
 typedef unsigned char boxRenderError;
@@ -106,6 +206,10 @@ int main() {
 
     SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND_PREMULTIPLIED);
 
+    if (!SDL_SetRenderVSync(renderer, useVSync ? 1 : 0)) {
+        std::cerr << "Error setting vsync: " << SDL_GetError() << std::endl;
+    }
+
     bool running = true;
 
 #if DEBUG_CONTROLLER
@@ -132,6 +236,11 @@ int main() {
         }
     }
     ControllerCommandInputParser controller = controllers.at(0);
+    std::unique_ptr<GamepadPoller> poller;
+    if (useGamepadPoller) {
+        poller = std::make_unique<GamepadPoller>(pads.at(0));
+        controller.setPoller(poller.get());
+    }
 #else
     BaseCommandInputParser kip(true,
         SDL_SCANCODE_A, SDL_SCANCODE_D, SDL_SCANCODE_SPACE, SDL_SCANCODE_S,
@@ -140,50 +249,92 @@ int main() {
 
     const SDL_FRect* ground = new SDL_FRect(-1000, height - groundLength, width + 2000, groundLength + 1000);
 
+    RosterLoader loader(loaderThreads);
+    std::shared_future<std::shared_ptr<const LoadedCharacter>> DebuggyLoad = loader.load("Debuggy");
+    if (!showLoadingScreen(renderer, loader, {DebuggyLoad})) {
+        delete ground;
+        SDL_DestroyRenderer(renderer);
+        SDL_DestroyWindow(window);
+        SDL_Quit();
+        return 0;
+    }
+
+    // The rest of the roster loads while the match runs, ready for the next one. Asked for before the characters in the
+    // match are released, so that they are not loaded again.
+    loader.preloadRoster();
+
 CHAR_CONSTRUCT(Debuggy)
 
+    FixedTimestep timestep(ticksPerSecond, maxCatchUpTicks);
+    FrameLimiter limiter(frameLimit);
+    LatencyMonitor latency;
+    bool showLatency = false;
+    timestep.start(SDL_GetTicksNS());
+    limiter.start(SDL_GetTicksNS());
+
     while (running) {
         SDL_Event event;
         while (SDL_PollEvent(&event)) {
-            switch (event.type) {
-                case SDL_EVENT_QUIT:
-                    running = false;
-                    break;
-#if DEBUG_CONTROLLER
-                case SDL_EVENT_JOYSTICK_AXIS_MOTION:
-                case SDL_EVENT_GAMEPAD_BUTTON_DOWN:
-                case SDL_EVENT_GAMEPAD_BUTTON_UP:
-                    dynamic_cast<ControllerCommandInputParser*>(debuggy->controller)->updateInput();
-                    dynamic_cast<ControllerCommandInputParser*>(debuggy->controller)->setButtons();
-                    break;
-#else
-                case SDL_EVENT_KEY_DOWN:
-                case SDL_EVENT_KEY_UP:
-                    Debuggy->controller->updateInput();
-                    Debuggy->controller->setButtons();
-                    break;
-#endif
-                default:
-                    break;
+            if (event.type == SDL_EVENT_QUIT) {
+                running = false;
+            } else if (event.type == SDL_EVENT_KEY_DOWN && !event.key.repeat && event.key.scancode == paletteKey) {
+                Debuggy->setPalette(static_cast<unsigned short>((Debuggy->getPalette() + 1U) % Debuggy->getAltPalettes().size()));
+            } else if (event.type == SDL_EVENT_KEY_DOWN && !event.key.repeat && event.key.scancode == latencyOverlayKey) {
+                showLatency = !showLatency;
+            } else if (event.type == SDL_EVENT_KEY_DOWN && !event.key.repeat && event.key.scancode == latencyCsvKey) {
+                std::ofstream csv(latencyCsvPath);
+                latency.writeCsv(csv);
+                if (!csv) {
+                    std::cerr << "Error writing " << latencyCsvPath << std::endl;
+                }
+            }
+            Debuggy->controller->handleEvent(event);
+        }
+        const Uint64 now = SDL_GetTicksNS();
+        const unsigned int ticks = timestep.advance(now);
+        for (unsigned int i = 0U; i < ticks; ++i) {
+            // When catching up, give each tick only the inputs that happened before it was due.
+            const Uint64 tickTime = now - (ticks - 1U - i) * SDL_NS_PER_SECOND / ticksPerSecond;
+            Debuggy->controller->sampleInput(tickTime);
+            if (Debuggy->controller->getInputTimestamp() != 0U) {
+                latency.inputSampled(timestep.getTotalTicks() - ticks + i, Debuggy->controller->getInputTimestamp(), tickTime);
             }
+            Debuggy->update();
         }
         SDL_RenderClear(renderer);
+        SDL_SetRenderDrawColor(renderer, 0x80U, 0x80U, 0x80U, 0xFFU);
+        SDL_RenderFillRect(renderer, ground);
         try {
-            Debuggy->render(renderer);
-        } catch (const char* e) {
-            std::cerr << "ERROR rendering: " << e << std::endl;
+            DebuggyRenderer->render(renderer, *Debuggy);
+        } catch (const std::exception& e) {
+            std::cerr << "ERROR rendering: " << e.what() << std::endl;
             return 1;
         }
         SDL_SetRenderDrawColor(renderer, 0xFFU, 0xFFU, 0xFFU, 0xFFU);
+        if (showLatency) {
+            latency.renderOverlay(renderer, 8.0F, 8.0F, SDL_GetTicksNS());
+        }
+        latency.frameSubmitted(SDL_GetTicksNS());
         SDL_RenderPresent(renderer);
+        latency.framePresented(SDL_GetTicksNS());
 
-        SDL_Delay(fpsDelay);
+        if (!useVSync) {
+            if (frameLimit == 0U) {
+                SDL_DelayPrecise(timestep.nanosecondsUntilNextTick(SDL_GetTicksNS()));
+            } else {
+                limiter.wait();
+            }
+        }
     }
 
 #if DEBUG_CONTROLLER
     SDL_free(gamepads);
 #endif
 
+    delete DebuggyRenderer;
+    delete Debuggy;
+    delete ground;
+
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
     SDL_Quit();
@@ -0,0 +1,71 @@
+#include "match.hpp"
+
+#include "box_overlap.hpp"
+#include "character.hpp"
+#include "checksum.hpp"
+#include "command_input_parser.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <span>
+
+#include <SDL3/SDL.h>
+
+uint64_t checksumMatchState(const MatchState& state) {
+    return checksum64(std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(&state), sizeof(MatchState)));
+}
+
+Match::Match(const char* player1Name,
+             BaseCommandInputParser* player1Controller,
+             const char* player2Name,
+             BaseCommandInputParser* player2Controller)
+    : groundBox{SDL_FRect(-1000, stageHeight - groundLength, stageWidth + 2000, groundLength + 1000)} {
+    this->player1 = std::make_unique<Character>(player1Name, player1Controller, this->ground);
+    this->player2 = std::make_unique<Character>(player2Name, player2Controller, this->ground);
+}
+
+void Match::step() {
+    this->player1->controller->updateInput();
+    this->player1->controller->setButtons();
+    this->player2->controller->updateInput();
+    this->player2->controller->setButtons();
+    this->player1->update();
+    this->player2->update();
+    this->player1Boxes.pack(this->player1->getActiveBoxes());
+    this->player2Boxes.pack(this->player2->getActiveBoxes());
+    collideBoxes(this->player1Boxes, this->player2Boxes, this->collisions);
+    ++this->frame;
+}
+
+void Match::saveState(MatchState& state) const {
+    state.frame = this->frame;
+    this->player1->saveState(state.player1);
+    this->player2->saveState(state.player2);
+}
+
+void Match::loadState(const MatchState& state) {
+    this->frame = state.frame;
+    this->player1->loadState(state.player1);
+    this->player2->loadState(state.player2);
+}
+
+uint64_t Match::checksum() const {
+    MatchState state;
+    this->saveState(state);
+    return this->checksumState(state);
+}
+
+uint64_t Match::checksumState(const MatchState& state) const {
+    const uint64_t hash = this->player1->checksumBoxes(state.player1, checksumMatchState(state));
+    return this->player2->checksumBoxes(state.player2, hash);
+}
+
+const BoxCollisions& Match::getCollisions() const { return this->collisions; }
+
+const SDL_FRect* Match::getGround() const { return this->ground; }
+
+Character& Match::getPlayer1() { return *this->player1; }
+
+Character& Match::getPlayer2() { return *this->player2; }
+
+unsigned long long Match::getFrame() const { return this->frame; }
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "box_overlap.hpp"
+#include "character.hpp"
+#include "command_input_parser.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+#include <SDL3/SDL.h>
+
+/**
+ * The width of the stage, in pixels.
+ */
+constexpr int stageWidth = 1280;
+/**
+ * The height of the stage, in pixels.
+ */
+constexpr int stageHeight = 720;
+/**
+ * The height of the visible part of the ground, in pixels.
+ */
+constexpr int groundLength = 150;
+
+/**
+ * Everything about a @c Match that changes from frame to frame, in a fixed-size blob that can be copied with
+ * @c std::memcpy .
+ */
+struct MatchState {
+    uint64_t frame; /**< The number of frames simulated since the match started. */
+    CharacterState player1; /**< The state of player 1's character. */
+    CharacterState player2; /**< The state of player 2's character. */
+};
+
+static_assert(std::is_trivially_copyable_v<MatchState>, "MatchState must be copyable with memcpy");
+static_assert(sizeof(MatchState) == sizeof(uint64_t) + 2UZ * sizeof(CharacterState), "MatchState must have no padding");
+
+/**
+ * Checksums a saved match, to check cheaply whether two matches are in the same state.
+ * @param state The state to checksum.
+ * @return The @c checksum64 of every byte of the state.
+ */
+uint64_t checksumMatchState(const MatchState& state);
+
+/**
+ * A match between two characters, simulated one frame at a time. Needs no window or renderer.
+ */
+class Match {
+private:
+    const SDL_FRect groundBox; /**< The ground that the characters stand on. */
+    const SDL_FRect* ground = &groundBox; /**< Points to @c Match::groundBox , for the characters to hold on to. */
+    std::unique_ptr<Character> player1; /**< The character controlled by player 1. */
+    std::unique_ptr<Character> player2; /**< The character controlled by player 2. */
+    unsigned long long frame = 0ULL; /**< The number of frames simulated since the match started. */
+    CharacterBoxColumns player1Boxes; /**< Player 1's active boxes, packed on every step. */
+    CharacterBoxColumns player2Boxes; /**< Player 2's active boxes, packed on every step. */
+    BoxCollisions collisions; /**< The boxes that overlapped on the last step. */
+public:
+    /**
+     * Loads both characters and places them on the stage.
+     * @param player1Name The name of player 1's character.
+     * @param player1Controller The command input parser of player 1.
+     * @param player2Name The name of player 2's character.
+     * @param player2Controller The command input parser of player 2.
+     * @exception DataException Any of the exceptions thrown by @c Character::Character .
+     */
+    Match(const char* player1Name, BaseCommandInputParser* player1Controller, const char* player2Name, BaseCommandInputParser* player2Controller);
+    /**
+     * Destroys both characters.
+     */
+    ~Match() = default;
+    Match(const Match&) = delete;
+    Match& operator=(const Match&) = delete;
+    /**
+     * Advances the match by one frame (1/60 of a second), reading the next input of both controllers, then finds the
+     * boxes that overlap.
+     */
+    void step();
+    /**
+     * Saves everything about the match that changes from frame to frame. The controllers are not saved.
+     * @param state Where to save the match.
+     */
+    void saveState(MatchState& state) const;
+    /**
+     * Restores the match to a saved state, for example to roll back to an earlier frame.
+     * @param state The state to restore, saved from a match between the same characters.
+     */
+    void loadState(const MatchState& state);
+    /**
+     * Checksums everything about the match that changes from frame to frame, including the boxes on the stage.
+     * @return The @c Match::checksumState of the match's current state.
+     */
+    uint64_t checksum() const;
+    /**
+     * Checksums a saved match together with the boxes that both characters have on the stage in it, so that a
+     * snapshot checksums the same as the match did when it was saved.
+     * @param state A state saved from a match between the same characters.
+     * @return The @c checksumMatchState of the state, with both characters' active boxes in it added.
+     */
+    uint64_t checksumState(const MatchState& state) const;
+    /**
+     * Gets the boxes that overlapped, as of the last call to @c Match::step .
+     * @return Every pair of overlapping boxes, by their index in each character's active boxes.
+     */
+    const BoxCollisions& getCollisions() const;
+    /**
+     * Gets the ground of the stage.
+     * @return The box representing the ground.
+     */
+    const SDL_FRect* getGround() const;
+    /**
+     * Gets player 1's character.
+     * @return The character controlled by player 1.
+     */
+    Character& getPlayer1();
+    /**
+     * Gets player 2's character.
+     * @return The character controlled by player 2.
+     */
+    Character& getPlayer2();
+    /**
+     * Gets the number of frames simulated.
+     * @return The number of frames since the match started.
+     */
+    unsigned long long getFrame() const;
+};
@@ -0,0 +1,352 @@
+#include "motion_recognizer.hpp"
+
+#include "input_history.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <initializer_list>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * A set of directions, with bit @c n set for direction @c n in numpad notation.
+ */
+using DirectionMask = uint16_t;
+
+/**
+ * The number of symbols that a motion's automaton steps on: each direction (0 is unused), then each direction again
+ * for when a full charge is ready.
+ */
+constexpr size_t motionSymbols = 20UZ;
+/**
+ * The most states of a motion's nondeterministic automaton, before it is compiled.
+ */
+constexpr size_t maxPositions = 128UZ;
+/**
+ * Marks a motion that needs no charge.
+ */
+constexpr uint8_t noCharge = 0xFFU;
+/**
+ * The directions that hold each kind of charge: back, down and down-back.
+ */
+constexpr std::array<DirectionMask, 3> chargeMasks = {
+    (1U << DOWN_BACK) | (1U << BACK) | (1U << UP_BACK),
+    (1U << DOWN_BACK) | (1U << DOWN) | (1U << DOWN_FORWARD),
+    1U << DOWN_BACK,
+};
+/**
+ * The directions around the stick, clockwise from forward. Neutral is not on it.
+ */
+constexpr std::array<Direction, 8> stickRing = {FORWARD, DOWN_FORWARD, DOWN, DOWN_BACK, BACK, UP_BACK, UP, UP_FORWARD};
+
+/**
+ * Builds a set of directions.
+ * @param directions The directions.
+ * @return The set.
+ */
+static constexpr DirectionMask directions(const std::initializer_list<int> directions) {
+    DirectionMask mask = 0U;
+    for (const int direction : directions) {
+        mask |= static_cast<DirectionMask>(1U << direction);
+    }
+    return mask;
+}
+
+/**
+ * Gets the directions next to some directions on the stick, which the stick rolls through on its way to the next
+ * direction of a motion.
+ * @param mask The directions.
+ * @return The directions and their neighbors on the stick.
+ */
+static DirectionMask neighbors(const DirectionMask mask) {
+    DirectionMask result = mask;
+    for (size_t i = 0UZ; i < stickRing.size(); ++i) {
+        if (mask & (1U << stickRing[i])) {
+            result |= static_cast<DirectionMask>(1U << stickRing[(i + 1UZ) % stickRing.size()]);
+            result |= static_cast<DirectionMask>(1U << stickRing[(i + stickRing.size() - 1UZ) % stickRing.size()]);
+        }
+    }
+    return result;
+}
+
+/**
+ * The definition of a motion, before it is compiled.
+ */
+struct MotionDefinition {
+    std::vector<std::vector<DirectionMask>> alternatives; /**< Each way of inputting the motion, one set of directions per step. */
+    uint8_t stepWindow; /**< The most frames between two steps. */
+    uint8_t charge; /**< The index of the charge in @c chargeMasks needed before the first step, @c noCharge for none. */
+};
+
+/**
+ * Turns numpad notation into the steps of a motion.
+ * @param notation The directions, for example @c 236 .
+ * @return One set of exactly one direction per step.
+ */
+static std::vector<DirectionMask> sequence(const char* notation) {
+    std::vector<DirectionMask> steps;
+    for (; *notation != '\0'; ++notation) {
+        steps.push_back(static_cast<DirectionMask>(1U << (*notation - '0')));
+    }
+    return steps;
+}
+
+/**
+ * Builds every way of turning the stick around: starting from any of the four sides, in either direction. Up counts
+ * as any upward direction, since a jump can only be avoided by cancelling it.
+ * @param sides The number of sides to pass through, 4 for a full circle.
+ * @return Every way of inputting the motion.
+ */
+static std::vector<std::vector<DirectionMask>> circles(const size_t sides) {
+    const std::array<DirectionMask, 4> clockwise = {
+        directions({FORWARD}), directions({DOWN}), directions({BACK}), directions({UP_BACK, UP, UP_FORWARD})};
+    std::vector<std::vector<DirectionMask>> alternatives;
+    for (size_t start = 0UZ; start < clockwise.size(); ++start) {
+        std::vector<DirectionMask> forwards;
+        std::vector<DirectionMask> backwards;
+        for (size_t side = 0UZ; side < sides; ++side) {
+            forwards.push_back(clockwise[(start + side) % clockwise.size()]);
+            backwards.push_back(clockwise[(start + clockwise.size() * sides - side) % clockwise.size()]);
+        }
+        alternatives.push_back(forwards);
+        alternatives.push_back(backwards);
+    }
+    return alternatives;
+}
+
+/**
+ * Defines every motion.
+ * @return The definition of each motion, in the order of @c MotionInput .
+ */
+static std::array<MotionDefinition, MOTION_INPUT_COUNT> defineMotions() {
+    return {
+        MotionDefinition({sequence("236")}, 11U, noCharge),
+        MotionDefinition({sequence("214")}, 11U, noCharge),
+        MotionDefinition({sequence("41236")}, 11U, noCharge),
+        MotionDefinition({sequence("63214")}, 11U, noCharge),
+        MotionDefinition(circles(4UZ), 15U, noCharge),
+        MotionDefinition({sequence("6")}, 11U, 0U),
+        MotionDefinition({{directions({UP_BACK, UP, UP_FORWARD})}}, 11U, 1U),
+        // 323 is the usual shortcut for 623.
+        MotionDefinition({sequence("623"), sequence("323")}, 11U, noCharge),
+        MotionDefinition({sequence("236236")}, 11U, noCharge),
+        MotionDefinition({sequence("214214")}, 11U, noCharge),
+        MotionDefinition({sequence("4123641236")}, 11U, noCharge),
+        MotionDefinition({sequence("6321463214")}, 11U, noCharge),
+        MotionDefinition(circles(8UZ), 15U, noCharge),
+        MotionDefinition({sequence("646")}, 11U, 0U),
+        MotionDefinition({sequence("319")}, 11U, 2U),
+        MotionDefinition({sequence("632146")}, 11U, noCharge),
+    };
+}
+
+/**
+ * A motion compiled into a deterministic automaton.
+ */
+struct MotionAutomaton {
+    std::vector<std::array<uint8_t, motionSymbols>> transitions; /**< The next state for each state and symbol. State 0 is the start. */
+    std::vector<uint8_t> accepting; /**< Whether each state completes the motion. */
+    uint8_t stepWindow = 0U; /**< The most frames between two steps. */
+    uint8_t charge = noCharge; /**< The index of the charge in @c chargeMasks needed before the first step, @c noCharge for none. */
+};
+
+/**
+ * Compiles a motion into a deterministic automaton with the subset construction.
+ *
+ * The nondeterministic automaton has one state per step of each alternative, for how many steps have been input.
+ * Every alternative can always start over, a direction in the next step moves on, a direction rolled through on the
+ * way from the previous step stays, and anything else drops that alternative.
+ * @param motion The motion.
+ * @return The automaton.
+ * @exception std::length_error The motion needs too many states.
+ */
+static MotionAutomaton compileMotion(const MotionDefinition& motion) {
+    std::vector<size_t> offsets;
+    size_t positions = 0UZ;
+    for (const std::vector<DirectionMask>& steps : motion.alternatives) {
+        offsets.push_back(positions);
+        positions += steps.size() + 1UZ;
+    }
+    if (positions > maxPositions) {
+        throw std::length_error("Motion has too many steps to compile");
+    }
+    std::bitset<maxPositions> start;
+    for (const size_t offset : offsets) {
+        start.set(offset);
+    }
+
+    MotionAutomaton automaton;
+    automaton.stepWindow = motion.stepWindow;
+    automaton.charge = motion.charge;
+    std::vector<std::bitset<maxPositions>> subsets = {start};
+    for (size_t current = 0UZ; current < subsets.size(); ++current) {
+        std::array<uint8_t, motionSymbols> row{};
+        for (size_t symbol = 0UZ; symbol < motionSymbols; ++symbol) {
+            const int direction = static_cast<int>(symbol % 10UZ);
+            const bool chargeReady = symbol >= 10UZ;
+            std::bitset<maxPositions> next = start;
+            for (size_t alternative = 0UZ; alternative < motion.alternatives.size(); ++alternative) {
+                const std::vector<DirectionMask>& steps = motion.alternatives[alternative];
+                for (size_t step = 0UZ; step < steps.size(); ++step) {
+                    if (!subsets[current].test(offsets[alternative] + step)) {
+                        continue;
+                    }
+                    const bool charged = step != 0UZ || motion.charge == noCharge || chargeReady;
+                    if (charged && (steps[step] & (1U << direction))) {
+                        next.set(offsets[alternative] + step + 1UZ);
+                    } else if (step != 0UZ && (neighbors(steps[step - 1UZ]) & (1U << direction))) {
+                        next.set(offsets[alternative] + step);
+                    }
+                }
+            }
+            const size_t found = static_cast<size_t>(std::find(subsets.begin(), subsets.end(), next) - subsets.begin());
+            if (found == subsets.size()) {
+                if (subsets.size() > UINT8_MAX) {
+                    throw std::length_error("Motion needs too many states to compile");
+                }
+                subsets.push_back(next);
+            }
+            row[symbol] = static_cast<uint8_t>(found);
+        }
+        automaton.transitions.push_back(row);
+    }
+    for (const std::bitset<maxPositions>& subset : subsets) {
+        bool accepting = false;
+        for (size_t alternative = 0UZ; alternative < motion.alternatives.size(); ++alternative) {
+            accepting = accepting || subset.test(offsets[alternative] + motion.alternatives[alternative].size());
+        }
+        automaton.accepting.push_back(accepting ? 1U : 0U);
+    }
+    return automaton;
+}
+
+/**
+ * Gets every motion, compiled the first time it is needed.
+ * @return The automaton of each motion, in the order of @c MotionInput .
+ */
+static const std::array<MotionAutomaton, MOTION_INPUT_COUNT>& motionAutomata() {
+    static const std::array<MotionAutomaton, MOTION_INPUT_COUNT> automata = [] {
+        const std::array<MotionDefinition, MOTION_INPUT_COUNT> definitions = defineMotions();
+        std::array<MotionAutomaton, MOTION_INPUT_COUNT> compiled;
+        for (size_t motion = 0UZ; motion < MOTION_INPUT_COUNT; ++motion) {
+            compiled[motion] = compileMotion(definitions[motion]);
+        }
+        return compiled;
+    }();
+    return automata;
+}
+
+/**
+ * Adds a frame to an age, stopping at 255.
+ * @param age The age.
+ */
+static void ageByOneFrame(uint8_t& age) {
+    if (age != UINT8_MAX) {
+        ++age;
+    }
+}
+
+CommandInput commandInputFromByte(const uint8_t data) {
+    return CommandInput(static_cast<MotionInput>(data >> 4), static_cast<CommandButton>((data >> 1) & 0x07U));
+}
+
+MotionRecognizer::MotionRecognizer() : state{} {
+    this->state.progressAges.fill(UINT8_MAX);
+    this->state.completedAges.fill(UINT8_MAX);
+    this->state.releasedChargeAges.fill(UINT8_MAX);
+    this->state.direction = NEUTRAL;
+}
+
+void MotionRecognizer::update(const Direction direction, const ButtonGroup buttons) {
+    const std::array<MotionAutomaton, MOTION_INPUT_COUNT>& automata = motionAutomata();
+    std::array<bool, 3> chargeReady;
+    for (size_t charge = 0UZ; charge < chargeMasks.size(); ++charge) {
+        ageByOneFrame(this->state.releasedChargeAges[charge]);
+        uint16_t& held = this->state.heldCharges[charge];
+        if (chargeMasks[charge] & (1U << direction)) {
+            held = std::min<uint16_t>(held + 1U, UINT16_MAX);
+        } else {
+            if (held >= chargeFrames) {
+                this->state.releasedChargeAges[charge] = 0U;
+            }
+            held = 0U;
+        }
+        chargeReady[charge] = held >= chargeFrames || this->state.releasedChargeAges[charge] <= chargeReleaseWindow;
+    }
+
+    const bool moved = direction != this->state.direction;
+    for (size_t motion = 0UZ; motion < MOTION_INPUT_COUNT; ++motion) {
+        const MotionAutomaton& automaton = automata[motion];
+        ageByOneFrame(this->state.progressAges[motion]);
+        ageByOneFrame(this->state.completedAges[motion]);
+        if (!moved) {
+            continue;
+        }
+        uint8_t& current = this->state.states[motion];
+        if (this->state.progressAges[motion] > automaton.stepWindow) {
+            current = 0U;
+        }
+        const bool ready = automaton.charge != noCharge && chargeReady[automaton.charge];
+        const uint8_t next = automaton.transitions[current][direction + (ready ? 10U : 0U)];
+        if (next != current) {
+            current = next;
+            this->state.progressAges[motion] = 0U;
+            if (automaton.accepting[next]) {
+                this->state.completedAges[motion] = 0U;
+            }
+        }
+    }
+
+    const uint8_t held = buttons.toBitfield();
+    this->state.pressedButtons = held & static_cast<uint8_t>(~this->state.buttons);
+    this->state.buttons = held;
+    this->state.direction = static_cast<uint8_t>(direction);
+}
+
+bool MotionRecognizer::completed(const MotionInput motion) const {
+    return motion < MOTION_INPUT_COUNT && this->state.completedAges[motion] <= motionBufferWindow;
+}
+
+bool MotionRecognizer::pressed(const CommandButton button) const {
+    // Bits of ButtonGroup::toBitfield: LP is 8, LK is 4, HP is 2 and HK is 1.
+    constexpr uint8_t lightPunch = 0x8U;
+    constexpr uint8_t lightKick = 0x4U;
+    constexpr uint8_t heavyPunch = 0x2U;
+    constexpr uint8_t heavyKick = 0x1U;
+    const uint8_t held = this->state.buttons;
+    const uint8_t pressed = this->state.pressedButtons;
+    switch (button) {
+        case LIGHT_PUNCH_BUTTON:
+            return pressed & lightPunch;
+        case HEAVY_PUNCH_BUTTON:
+            return pressed & heavyPunch;
+        case EITHER_PUNCH_BUTTON:
+            return pressed & (lightPunch | heavyPunch);
+        case BOTH_PUNCH_BUTTONS:
+            return (held & (lightPunch | heavyPunch)) == (lightPunch | heavyPunch) && (pressed & (lightPunch | heavyPunch));
+        case LIGHT_KICK_BUTTON:
+            return pressed & lightKick;
+        case HEAVY_KICK_BUTTON:
+            return pressed & heavyKick;
+        case EITHER_KICK_BUTTON:
+            return pressed & (lightKick | heavyKick);
+        case BOTH_KICK_BUTTONS:
+            return (held & (lightKick | heavyKick)) == (lightKick | heavyKick) && (pressed & (lightKick | heavyKick));
+        default:
+            return false;
+    }
+}
+
+bool MotionRecognizer::matches(const CommandInput input) const {
+    return this->completed(input.motion) && this->pressed(input.button);
+}
+
+void MotionRecognizer::saveState(MotionRecognizerState& state) const {
+    state = this->state;
+}
+
+void MotionRecognizer::loadState(const MotionRecognizerState& state) {
+    this->state = state;
+}
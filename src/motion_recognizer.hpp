@@ -0,0 +1,144 @@
+#pragma once
+
+#include "input_history.hpp"
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * The motion of a special move or Super, in the order of the special move byte of *.ff files (see CONTRIBUTING.md).
+ */
+enum MotionInput : uint8_t {
+    QUARTER_CIRCLE_FORWARD, /**< 236 */
+    QUARTER_CIRCLE_BACK, /**< 214 */
+    HALF_CIRCLE_FORWARD, /**< 41236 */
+    HALF_CIRCLE_BACK, /**< 63214 */
+    FULL_CIRCLE, /**< 360 */
+    HORIZONTAL_CHARGE, /**< [4]6 */
+    VERTICAL_CHARGE, /**< [2]8 */
+    DRAGON_PUNCH, /**< 623 */
+    DOUBLE_QUARTER_CIRCLE_FORWARD, /**< 236236 */
+    DOUBLE_QUARTER_CIRCLE_BACK, /**< 214214 */
+    DOUBLE_HALF_CIRCLE_FORWARD, /**< 4123641236 */
+    DOUBLE_HALF_CIRCLE_BACK, /**< 6321463214 */
+    DOUBLE_FULL_CIRCLE, /**< 720 */
+    DOUBLE_HORIZONTAL_CHARGE, /**< [4]646 */
+    DOUBLE_DIAGONAL_CHARGE, /**< [1]319 */
+    HALF_CIRCLE_BACK_FORWARD, /**< 632146 */
+    MOTION_INPUT_COUNT /**< The number of motions. */
+};
+
+/**
+ * The buttons of a special move or Super, in the order of the special move byte of *.ff files (see CONTRIBUTING.md).
+ */
+enum CommandButton : uint8_t {
+    LIGHT_PUNCH_BUTTON, /**< LP */
+    HEAVY_PUNCH_BUTTON, /**< HP */
+    EITHER_PUNCH_BUTTON, /**< P, either punch */
+    BOTH_PUNCH_BUTTONS, /**< PP */
+    LIGHT_KICK_BUTTON, /**< LK */
+    HEAVY_KICK_BUTTON, /**< HK */
+    EITHER_KICK_BUTTON, /**< K, either kick */
+    BOTH_KICK_BUTTONS /**< KK */
+};
+
+/**
+ * The input of a special move or Super: a motion, then buttons.
+ */
+struct CommandInput {
+    MotionInput motion; /**< The motion. */
+    CommandButton button; /**< The buttons pressed at the end of the motion. */
+};
+
+/**
+ * Reads the special move byte of a *.ff file.
+ * @param data The byte: the motion in the high 4 bits, then the buttons in the next 3 bits.
+ * @return The command input.
+ */
+CommandInput commandInputFromByte(uint8_t data);
+
+/**
+ * How long a charge has to be held, in frames.
+ */
+constexpr uint16_t chargeFrames = 40U;
+/**
+ * How long a full charge still counts after letting go of it, in frames.
+ */
+constexpr uint8_t chargeReleaseWindow = 10U;
+/**
+ * How long a completed motion waits for its buttons, in frames.
+ */
+constexpr uint8_t motionBufferWindow = 10U;
+
+/**
+ * A fixed-size copy of a @c MotionRecognizer , which can be copied with @c std::memcpy .
+ */
+struct MotionRecognizerState {
+    std::array<uint8_t, MOTION_INPUT_COUNT> states; /**< The automaton state of each motion. */
+    std::array<uint8_t, MOTION_INPUT_COUNT> progressAges; /**< Frames since each motion last made progress, up to 255. */
+    std::array<uint8_t, MOTION_INPUT_COUNT> completedAges; /**< Frames since each motion was last completed, up to 255. */
+    std::array<uint16_t, 3> heldCharges; /**< Frames that each charge direction (back, down, down-back) has been held. */
+    std::array<uint8_t, 3> releasedChargeAges; /**< Frames since each full charge was let go of, up to 255. */
+    uint8_t direction; /**< The direction held on the last frame. */
+    uint8_t buttons; /**< The buttons held on the last frame, from @c ButtonGroup::toBitfield . */
+    uint8_t pressedButtons; /**< The buttons first pressed on the last frame. */
+};
+
+static_assert(std::is_trivially_copyable_v<MotionRecognizerState>, "MotionRecognizerState must be copyable with memcpy");
+static_assert(sizeof(MotionRecognizerState) == 60UZ, "MotionRecognizerState must have no padding, so that it can be compared byte by byte");
+
+/**
+ * Recognizes the motions and buttons of special moves and Supers as they are input.
+ *
+ * Each motion is compiled once into a table-driven automaton. Every frame costs a few table lookups per motion: the
+ * automata only step when the direction changes, and never look back through the input history.
+ *
+ * Directions rolled through between two steps of a motion (such as the 1 in 2136) are ignored, as long as each step
+ * comes within the motion's step window of the one before it. A motion completed up to @c motionBufferWindow frames
+ * ago still counts when its buttons are pressed.
+ */
+class MotionRecognizer {
+private:
+    MotionRecognizerState state; /**< Everything that changes from frame to frame. */
+public:
+    /**
+     * Starts with nothing input.
+     */
+    MotionRecognizer();
+    /**
+     * Adds one frame of input. Meant to be called once per frame.
+     * @param direction The direction held.
+     * @param buttons The buttons held.
+     */
+    void update(Direction direction, ButtonGroup buttons);
+    /**
+     * Checks whether a motion was completed recently enough to be used.
+     * @param motion The motion.
+     * @return Whether the motion was completed in the last @c motionBufferWindow frames.
+     */
+    bool completed(MotionInput motion) const;
+    /**
+     * Checks whether buttons were pressed on the last frame. Buttons that need both punches or both kicks count when
+     * both are held and at least one of them was just pressed.
+     * @param button The buttons.
+     * @return Whether the buttons were pressed.
+     */
+    bool pressed(CommandButton button) const;
+    /**
+     * Checks whether a special move or Super was input on the last frame.
+     * @param input The command input.
+     * @return Whether the motion was completed recently and its buttons were pressed on the last frame.
+     */
+    bool matches(CommandInput input) const;
+    /**
+     * Saves the recognizer.
+     * @param state Where to save it.
+     */
+    void saveState(MotionRecognizerState& state) const;
+    /**
+     * Restores the recognizer.
+     * @param state The saved recognizer.
+     */
+    void loadState(const MotionRecognizerState& state);
+};
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/**
+ * Compresses bytes with PackBits: a header byte from 0 to 127 is followed by that many bytes plus one, copied as they
+ * are, and a header byte from 129 to 255 is followed by one byte repeated 257 minus that many times.
+ * @tparam Byte The type of the bytes.
+ * @param input The bytes to compress.
+ * @return The compressed bytes.
+ */
+template <typename Byte>
+constexpr std::vector<Byte> packBits(const std::span<const Byte> input) {
+    std::vector<Byte> output;
+    output.reserve(input.size() + input.size() / 128UZ + 1UZ);
+    size_t i = 0UZ;
+    while (i < input.size()) {
+        size_t run = 1UZ;
+        while (i + run < input.size() && run < 128UZ && input[i + run] == input[i]) {
+            ++run;
+        }
+        if (run >= 2UZ) {
+            output.push_back(static_cast<Byte>(257UZ - run));
+            output.push_back(input[i]);
+            i += run;
+            continue;
+        }
+        // Literal bytes last until the next run of at least 3, which is where a repeat starts paying off.
+        size_t literal = 1UZ;
+        while (i + literal < input.size() && literal < 128UZ
+               && !(i + literal + 2UZ < input.size() && input[i + literal] == input[i + literal + 1UZ] && input[i + literal] == input[i + literal + 2UZ])) {
+            ++literal;
+        }
+        output.push_back(static_cast<Byte>(literal - 1UZ));
+        output.insert(output.end(), input.begin() + static_cast<std::ptrdiff_t>(i), input.begin() + static_cast<std::ptrdiff_t>(i + literal));
+        i += literal;
+    }
+    return output;
+}
+
+/**
+ * Decompresses bytes compressed with @c packBits .
+ * @tparam Byte The type of the bytes.
+ * @param input The compressed bytes.
+ * @param output The bytes to add the decompressed bytes to.
+ * @return Whether the input was complete; a header byte whose data was cut off leaves @p output partly filled.
+ */
+template <typename Byte>
+constexpr bool unpackBits(const std::span<const Byte> input, std::vector<Byte>& output) {
+    size_t i = 0UZ;
+    while (i < input.size()) {
+        const uint8_t header = static_cast<uint8_t>(input[i++]);
+        if (header < 128U) {
+            const size_t literal = header + 1UZ;
+            if (literal > input.size() - i) {
+                return false;
+            }
+            output.insert(output.end(), input.begin() + static_cast<std::ptrdiff_t>(i), input.begin() + static_cast<std::ptrdiff_t>(i + literal));
+            i += literal;
+        } else if (header > 128U) {
+            if (i >= input.size()) {
+                return false;
+            }
+            output.insert(output.end(), 257UZ - header, input[i++]);
+        }
+    }
+    return true;
+}
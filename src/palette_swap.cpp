@@ -0,0 +1,68 @@
+#include "palette_swap.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * Mixes the bits of a color, so that similar colors land in different slots.
+ * @param color The color.
+ * @return The hash of the color.
+ */
+static uint32_t hashColor(const uint32_t color) {
+    // The multiplier of Fibonacci hashing, 2^32 divided by the golden ratio.
+    return (color * 0x9E3779B9U) ^ (color >> 16);
+}
+
+PaletteSwap::PaletteSwap(const std::span<const uint32_t> from, const std::span<const uint32_t> to) {
+    if (from.size() != to.size()) {
+        throw std::invalid_argument("Palettes have different numbers of colors");
+    }
+    // At most half full, so that a lookup rarely goes past its first slot.
+    const size_t slots = std::bit_ceil(std::max<size_t>(from.size() * 2UZ, 8UZ));
+    this->mask = static_cast<uint32_t>(slots - 1UZ);
+    // Any color missing from the palette can mark unused slots, and with at most 2^16 colors one is always found.
+    while (std::find(from.begin(), from.end(), this->emptyKey) != from.end()) {
+        ++this->emptyKey;
+    }
+    this->keys.assign(slots, this->emptyKey);
+    this->values.assign(slots, 0U);
+    for (size_t i = 0UZ; i < from.size(); ++i) {
+        const uint32_t slot = this->find(from[i]);
+        if (this->keys[slot] == this->emptyKey && from[i] != to[i]) {
+            this->keys[slot] = from[i];
+            this->values[slot] = to[i];
+        }
+    }
+}
+
+uint32_t PaletteSwap::find(const uint32_t color) const {
+    uint32_t slot = hashColor(color) & this->mask;
+    while (this->keys[slot] != color && this->keys[slot] != this->emptyKey) {
+        slot = (slot + 1U) & this->mask;
+    }
+    return slot;
+}
+
+uint32_t PaletteSwap::map(const uint32_t color) const {
+    const uint32_t slot = this->find(color);
+    return this->keys[slot] == this->emptyKey ? color : this->values[slot];
+}
+
+void PaletteSwap::apply(const std::span<uint32_t> pixels) const {
+    if (pixels.empty()) {
+        return;
+    }
+    uint32_t previous = pixels[0];
+    uint32_t replacement = this->map(previous);
+    for (uint32_t& pixel : pixels) {
+        if (pixel != previous) {
+            previous = pixel;
+            replacement = this->map(pixel);
+        }
+        pixel = replacement;
+    }
+}
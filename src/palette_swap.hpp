@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/**
+ * Recolors pixels from one palette to another in a single pass, however many colors the palettes have.
+ *
+ * The colors are kept in an open-addressing hash table, so each pixel costs one lookup instead of one comparison per
+ * color. Sprite sheets are mostly runs of the same color (usually transparent), so the last pixel's result is
+ * remembered and a run only looks its color up once.
+ */
+class PaletteSwap {
+private:
+    std::vector<uint32_t> keys; /**< The colors to replace, with @c emptyKey marking an unused slot. */
+    std::vector<uint32_t> values; /**< The color replacing the key in the same slot. */
+    uint32_t mask = 0U; /**< The number of slots minus 1, which is a power of two minus 1. */
+    uint32_t emptyKey = 0U; /**< A color that is not replaced, marking unused slots. */
+    /**
+     * Finds the slot of a color.
+     * @param color The color.
+     * @return The slot holding the color, or the unused slot where it would go.
+     */
+    uint32_t find(uint32_t color) const;
+public:
+    /**
+     * Builds the lookup table. When a color appears more than once in @p from , its first replacement is used. Colors
+     * that do not change are left out.
+     * @param from The colors to replace, as pixel values.
+     * @param to The color replacing each color of @p from , as pixel values.
+     * @exception std::invalid_argument The palettes are not the same size.
+     */
+    PaletteSwap(std::span<const uint32_t> from, std::span<const uint32_t> to);
+    /**
+     * Recolors pixels. Pixels whose color is not in the palette are left alone.
+     * @param pixels The pixels, recolored in place.
+     */
+    void apply(std::span<uint32_t> pixels) const;
+    /**
+     * Gets what a color is recolored to.
+     * @param color The color.
+     * @return The replacement, or the color itself if it is not in the palette.
+     */
+    uint32_t map(uint32_t color) const;
+};
@@ -0,0 +1,237 @@
+#include "replay.hpp"
+
+#include "checksum.hpp"
+#include "input_history.hpp"
+#include "scalar.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifndef FOSS_FIGHT_BUILD_ID
+/**
+ * The source revision that the game was built from, set by the build system.
+ */
+#define FOSS_FIGHT_BUILD_ID "unknown"
+#endif
+
+/**
+ * The first bytes of every replay: the @c F0 @c 55 of *.ff files, then @c R .
+ */
+constexpr std::array<uint8_t, 3> replayMagic = {0xF0U, 0x55U, 0x52U};
+/**
+ * The most bytes that a number takes up as a varint.
+ */
+constexpr size_t maxVarintSize = 10UZ;
+
+uint64_t replayBuildHash() {
+    static const uint64_t hash = [] {
+        const std::string id = std::string(FOSS_FIGHT_BUILD_ID) + (FOSS_FIGHT_FIXED_POINT ? " fixed-point" : " float");
+        return checksum64(std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(id.data()), id.size()));
+    }();
+    return hash;
+}
+
+ReplayRecorder::ReplayRecorder(const std::array<std::string, 2>& characters, const std::array<uint16_t, 2>& palettes) {
+    this->replay.characters = characters;
+    this->replay.palettes = palettes;
+}
+
+void ReplayRecorder::recordFrame(const uint8_t player1Input, const uint8_t player2Input) {
+    const std::array<uint8_t, 2> frameInputs = {player1Input, player2Input};
+    for (size_t player = 0UZ; player < 2UZ; ++player) {
+        std::vector<InputHistoryEntry>& entries = this->replay.inputs[player];
+        const uint8_t input = frameInputs[player];
+        if (!entries.empty() && entries.back().getDuration() < maxInputDuration
+            && packInput(entries.back().getDirection(), entries.back().getButton()) == input) {
+            entries.back().incrementDuration();
+        } else {
+            entries.emplace_back(unpackDirection(input), unpackButtons(input));
+        }
+    }
+    ++this->replay.frames;
+}
+
+const Replay& ReplayRecorder::getReplay() const { return this->replay; }
+
+/**
+ * Writes a number as an unsigned LEB128 varint: 7 bits per byte, lowest first, with the top bit set on every byte
+ * but the last.
+ * @param output Where to write, with room for @c maxVarintSize bytes.
+ * @param value The number.
+ * @return Where the varint ends.
+ */
+static uint8_t* writeVarint(uint8_t* output, uint64_t value) {
+    while (value >= 0x80U) {
+        *output++ = static_cast<uint8_t>(value | 0x80U);
+        value >>= 7;
+    }
+    *output++ = static_cast<uint8_t>(value);
+    return output;
+}
+
+/**
+ * Reads an unsigned LEB128 varint.
+ * @param input Where to read, which is moved past the varint.
+ * @param end The end of the bytes.
+ * @return The number.
+ * @exception std::invalid_argument The varint runs past the end, or does not fit in 64 bits.
+ */
+static uint64_t readVarint(const uint8_t*& input, const uint8_t* const end) {
+    // Most durations are under 128 frames, so take the one-byte case first.
+    if (input < end && *input < 0x80U) {
+        return *input++;
+    }
+    uint64_t value = 0U;
+    for (unsigned int shift = 0U; shift < 64U; shift += 7U) {
+        if (input >= end) {
+            throw std::invalid_argument("Replay ends in the middle of a number");
+        }
+        const uint8_t byte = *input++;
+        // The tenth byte only has room for the 64th bit, so anything more would be silently dropped.
+        if (shift == 63U && byte > 1U) {
+            throw std::invalid_argument("Replay has a number that is too long");
+        }
+        value |= static_cast<uint64_t>(byte & 0x7FU) << shift;
+        if (byte < 0x80U) {
+            return value;
+        }
+    }
+    throw std::invalid_argument("Replay has a number that is too long");
+}
+
+std::vector<uint8_t> encodeReplay(const Replay& replay) {
+    size_t capacity = replayMagic.size() + 1UZ + 8UZ + maxVarintSize;
+    for (size_t player = 0UZ; player < 2UZ; ++player) {
+        if (replay.characters[player].size() > 0xFFUZ) {
+            throw std::invalid_argument("Character name is too long for a replay: " + replay.characters[player]);
+        }
+        capacity += 3UZ + replay.characters[player].size() + maxVarintSize + replay.inputs[player].size() * 3UZ;
+    }
+    // Durations never reach 2^14, so every entry fits in 3 bytes and the buffer never has to grow.
+    static_assert(maxInputDuration < 0x4000U, "Input durations must fit in a 2-byte varint");
+    std::vector<uint8_t> bytes(capacity);
+    uint8_t* output = bytes.data();
+
+    for (const uint8_t byte : replayMagic) {
+        *output++ = byte;
+    }
+    *output++ = replayVersion;
+    for (int shift = 56; shift >= 0; shift -= 8) {
+        *output++ = static_cast<uint8_t>(replay.buildHash >> shift);
+    }
+    for (size_t player = 0UZ; player < 2UZ; ++player) {
+        *output++ = static_cast<uint8_t>(replay.palettes[player] >> 8);
+        *output++ = static_cast<uint8_t>(replay.palettes[player]);
+        *output++ = static_cast<uint8_t>(replay.characters[player].size());
+        for (const char c : replay.characters[player]) {
+            *output++ = static_cast<uint8_t>(c);
+        }
+    }
+    output = writeVarint(output, replay.frames);
+    for (size_t player = 0UZ; player < 2UZ; ++player) {
+        output = writeVarint(output, replay.inputs[player].size());
+        for (const InputHistoryEntry& entry : replay.inputs[player]) {
+            *output++ = packInput(entry.getDirection(), entry.getButton());
+            const unsigned short duration = entry.getDuration();
+            if (duration < 0x80U) {
+                *output++ = static_cast<uint8_t>(duration);
+            } else {
+                *output++ = static_cast<uint8_t>(duration | 0x80U);
+                *output++ = static_cast<uint8_t>(duration >> 7);
+            }
+        }
+    }
+    bytes.resize(static_cast<size_t>(output - bytes.data()));
+    return bytes;
+}
+
+Replay decodeReplay(const std::span<const uint8_t> bytes) {
+    const uint8_t* input = bytes.data();
+    const uint8_t* const end = bytes.data() + bytes.size();
+    const size_t headerSize = replayMagic.size() + 1UZ + 8UZ;
+    if (bytes.size() < headerSize || !std::equal(replayMagic.begin(), replayMagic.end(), input)) {
+        throw std::invalid_argument("Not a replay");
+    }
+    input += replayMagic.size();
+    if (*input != replayVersion) {
+        throw std::invalid_argument("Unsupported replay version " + std::to_string(*input));
+    }
+    ++input;
+    Replay replay;
+    replay.buildHash = 0U;
+    for (int i = 0; i < 8; ++i) {
+        replay.buildHash = (replay.buildHash << 8) | *input++;
+    }
+    for (size_t player = 0UZ; player < 2UZ; ++player) {
+        if (end - input < 3) {
+            throw std::invalid_argument("Replay ends in the middle of the players");
+        }
+        replay.palettes[player] = static_cast<uint16_t>((input[0] << 8) | input[1]);
+        const size_t nameLength = input[2];
+        input += 3;
+        if (static_cast<size_t>(end - input) < nameLength) {
+            throw std::invalid_argument("Replay ends in the middle of a character name");
+        }
+        replay.characters[player].assign(reinterpret_cast<const char*>(input), nameLength);
+        input += nameLength;
+    }
+    replay.frames = readVarint(input, end);
+    for (size_t player = 0UZ; player < 2UZ; ++player) {
+        const uint64_t count = readVarint(input, end);
+        // Every entry takes at least 2 bytes, which bounds how much memory a broken replay can ask for.
+        if (count > static_cast<uint64_t>(end - input) / 2U) {
+            throw std::invalid_argument("Replay has more inputs than bytes");
+        }
+        std::vector<InputHistoryEntry>& entries = replay.inputs[player];
+        entries.reserve(count);
+        uint64_t frames = 0U;
+        for (uint64_t i = 0U; i < count; ++i) {
+            if (input >= end) {
+                throw std::invalid_argument("Replay ends in the middle of the inputs");
+            }
+            const uint8_t packed = *input++;
+            const uint64_t duration = readVarint(input, end);
+            const uint8_t direction = packed >> 4;
+            if (direction < DOWN_BACK || direction > UP_FORWARD || duration > maxInputDuration) {
+                throw std::invalid_argument("Replay has an invalid input for player " + std::to_string(player + 1UZ));
+            }
+            entries.emplace_back(static_cast<Direction>(direction), unpackButtons(packed), static_cast<unsigned short>(duration));
+            frames += duration + 1U;
+        }
+        if (frames != replay.frames) {
+            throw std::invalid_argument("Player " + std::to_string(player + 1UZ) + "'s inputs last " + std::to_string(frames)
+                                        + " frames, but the replay has " + std::to_string(replay.frames));
+        }
+    }
+    if (input != end) {
+        throw std::invalid_argument("Replay has data after the inputs");
+    }
+    return replay;
+}
+
+void saveReplay(const std::string& path, const Replay& replay) {
+    const std::vector<uint8_t> bytes = encodeReplay(replay);
+    std::ofstream file(path, std::ios::binary);
+    if (!file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()))) {
+        throw std::runtime_error("Could not write replay " + path);
+    }
+}
+
+Replay loadReplay(const std::string& path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        throw std::runtime_error("Could not open replay " + path);
+    }
+    std::vector<uint8_t> bytes(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    if (!file.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()))) {
+        throw std::runtime_error("Could not read replay " + path);
+    }
+    return decodeReplay(bytes);
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "input_history.hpp"
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+/**
+ * The version of the replay format written by @c encodeReplay .
+ */
+constexpr uint8_t replayVersion = 1U;
+
+/**
+ * Identifies the build that a replay was recorded with, since a replay only plays back the same way on a build
+ * with the same simulation.
+ * @return A hash of the source revision the game was built from and the kind of physics it uses.
+ */
+uint64_t replayBuildHash();
+
+/**
+ * A recorded match: who played, and every input of both players, run-length encoded like an @c InputHistory .
+ */
+struct Replay {
+    std::array<std::string, 2> characters; /**< The name of each player's character. */
+    std::array<uint16_t, 2> palettes{}; /**< The palette of each player's character. */
+    uint64_t buildHash = replayBuildHash(); /**< The @c replayBuildHash of the build the replay was recorded with. */
+    uint64_t frames = 0U; /**< The number of frames in the match. */
+    std::array<std::vector<InputHistoryEntry>, 2> inputs; /**< The inputs of each player, covering every frame. */
+};
+
+/**
+ * Records the inputs of a match one frame at a time.
+ */
+class ReplayRecorder {
+private:
+    Replay replay; /**< The replay so far. */
+public:
+    /**
+     * Starts recording a match.
+     * @param characters The name of each player's character.
+     * @param palettes The palette of each player's character.
+     */
+    ReplayRecorder(const std::array<std::string, 2>& characters, const std::array<uint16_t, 2>& palettes);
+    /**
+     * Adds the inputs of one frame. Inputs held for longer than @c maxInputDuration are split into several entries.
+     * @param player1Input Player 1's input, from @c packInput .
+     * @param player2Input Player 2's input, from @c packInput .
+     */
+    void recordFrame(uint8_t player1Input, uint8_t player2Input);
+    /**
+     * Gets the replay so far.
+     * @return Every frame recorded.
+     */
+    const Replay& getReplay() const;
+};
+
+/**
+ * Encodes a replay into bytes, in the format described in CONTRIBUTING.md.
+ * @param replay The replay to encode.
+ * @return The encoded replay.
+ * @exception std::invalid_argument A character name is longer than 255 bytes.
+ */
+std::vector<uint8_t> encodeReplay(const Replay& replay);
+
+/**
+ * Decodes a replay from bytes written by @c encodeReplay .
+ * @param bytes The encoded replay.
+ * @return The replay.
+ * @exception std::invalid_argument The bytes are not a valid replay.
+ */
+Replay decodeReplay(std::span<const uint8_t> bytes);
+
+/**
+ * Writes a replay to a file.
+ * @param path The path of the file.
+ * @param replay The replay to write.
+ * @exception std::runtime_error The file could not be written.
+ */
+void saveReplay(const std::string& path, const Replay& replay);
+
+/**
+ * Reads a replay from a file.
+ * @param path The path of the file.
+ * @return The replay.
+ * @exception std::runtime_error The file could not be read.
+ * @exception std::invalid_argument The file is not a valid replay.
+ */
+Replay loadReplay(const std::string& path);
@@ -0,0 +1,263 @@
+#include "rollback.hpp"
+
+#include "command_input_parser.hpp"
+#include "input_history.hpp"
+#include "match.hpp"
+#include "transport.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/**
+ * The size of a packet with no inputs.
+ */
+constexpr size_t packetHeaderSize = 21UZ;
+/**
+ * The most inputs in one packet.
+ */
+constexpr uint32_t maxInputsPerPacket = 0xFFU;
+
+/**
+ * Writes a 32-bit number in little-endian.
+ * @param buffer Where to write.
+ * @param value The number.
+ */
+static void writeU32LE(uint8_t* buffer, const uint32_t value) {
+    buffer[0] = static_cast<uint8_t>(value);
+    buffer[1] = static_cast<uint8_t>(value >> 8);
+    buffer[2] = static_cast<uint8_t>(value >> 16);
+    buffer[3] = static_cast<uint8_t>(value >> 24);
+}
+
+/**
+ * Writes a 64-bit number in little-endian.
+ * @param buffer Where to write.
+ * @param value The number.
+ */
+static void writeU64LE(uint8_t* buffer, const uint64_t value) {
+    writeU32LE(buffer, static_cast<uint32_t>(value));
+    writeU32LE(buffer + 4, static_cast<uint32_t>(value >> 32));
+}
+
+/**
+ * Reads a 32-bit number in little-endian.
+ * @param buffer Where to read.
+ * @return The number.
+ */
+static uint32_t readU32LE(const uint8_t* buffer) {
+    return static_cast<uint32_t>(buffer[0])
+         | (static_cast<uint32_t>(buffer[1]) << 8)
+         | (static_cast<uint32_t>(buffer[2]) << 16)
+         | (static_cast<uint32_t>(buffer[3]) << 24);
+}
+
+/**
+ * Reads a 64-bit number in little-endian.
+ * @param buffer Where to read.
+ * @return The number.
+ */
+static uint64_t readU64LE(const uint8_t* buffer) {
+    return static_cast<uint64_t>(readU32LE(buffer)) | (static_cast<uint64_t>(readU32LE(buffer + 4)) << 32);
+}
+
+RollbackSession::RollbackSession(Match& match,
+                                 PackedCommandInputParser& player1Controller,
+                                 PackedCommandInputParser& player2Controller,
+                                 Transport& transport,
+                                 const size_t localPlayer,
+                                 const uint32_t inputDelay)
+    : match{match},
+      controllers{&player1Controller, &player2Controller},
+      transport{transport},
+      localPlayer{localPlayer},
+      remotePlayer{1UZ - localPlayer},
+      localInputCount{inputDelay} {
+    if (localPlayer > 1UZ) {
+        throw std::invalid_argument("Invalid local player " + std::to_string(localPlayer));
+    }
+    if (inputDelay >= maxRollbackFrames) {
+        throw std::invalid_argument("Input delay of " + std::to_string(inputDelay) + " frames is too long");
+    }
+    // Nothing is pressed during the input delay at the start of the match.
+    for (uint32_t frame = 0U; frame < inputDelay; ++frame) {
+        this->inputs[localPlayer][frame] = neutralInput;
+        this->inputFrames[localPlayer][frame] = frame + 1U;
+    }
+}
+
+bool RollbackSession::hasInput(const size_t player, const uint32_t frame) const {
+    return this->inputFrames[player][frame % rollbackInputWindow] == frame + 1U;
+}
+
+uint8_t RollbackSession::remoteInputFor(const uint32_t frame) const {
+    if (this->hasInput(this->remotePlayer, frame)) {
+        return this->inputs[this->remotePlayer][frame % rollbackInputWindow];
+    }
+    if (this->remoteInputCount == 0U) {
+        return neutralInput;
+    }
+    // Players tend to keep holding what they were holding, so the last input received is the best guess.
+    return this->inputs[this->remotePlayer][(this->remoteInputCount - 1U) % rollbackInputWindow];
+}
+
+void RollbackSession::simulateFrame(const uint32_t frame) {
+    this->match.saveState(this->states[frame % savedStates]);
+    const uint8_t remoteInput = this->remoteInputFor(frame);
+    this->usedRemoteInputs[frame % rollbackInputWindow] = remoteInput;
+    this->controllers[this->localPlayer]->setInput(this->inputs[this->localPlayer][frame % rollbackInputWindow]);
+    this->controllers[this->remotePlayer]->setInput(remoteInput);
+    this->match.step();
+}
+
+void RollbackSession::receiveInputs() {
+    while (this->transport.receive(this->packet)) {
+        if (this->packet.size() < packetHeaderSize) {
+            continue;
+        }
+        const uint32_t acknowledged = readU32LE(this->packet.data());
+        const uint32_t first = readU32LE(this->packet.data() + 4);
+        const uint32_t count = this->packet[8];
+        if (this->packet.size() < packetHeaderSize + count || acknowledged > this->localInputCount) {
+            continue;
+        }
+        ++this->stats.packetsReceived;
+        this->acknowledgedCount = std::max(this->acknowledgedCount, acknowledged);
+        const uint32_t checksumFrame = readU32LE(this->packet.data() + 9);
+        if (checksumFrame != 0U) {
+            this->addChecksum(this->remotePlayer, checksumFrame - 1U, readU64LE(this->packet.data() + 13));
+        }
+        for (uint32_t i = 0U; i < count; ++i) {
+            const uint32_t frame = first + i;
+            // Inputs too far ahead would overwrite inputs that may still be needed for a rollback.
+            if (frame < this->remoteInputCount
+                || frame >= this->remoteInputCount + rollbackInputWindow - maxRollbackFrames
+                || this->hasInput(this->remotePlayer, frame)) {
+                continue;
+            }
+            const uint8_t input = this->packet[packetHeaderSize + i];
+            this->inputs[this->remotePlayer][frame % rollbackInputWindow] = input;
+            this->inputFrames[this->remotePlayer][frame % rollbackInputWindow] = frame + 1U;
+            if (frame < this->currentFrame && this->usedRemoteInputs[frame % rollbackInputWindow] != input) {
+                this->rollbackFrame = std::min(this->rollbackFrame, frame);
+            }
+        }
+        while (this->hasInput(this->remotePlayer, this->remoteInputCount)) {
+            ++this->remoteInputCount;
+        }
+    }
+}
+
+void RollbackSession::sendInputs() {
+    const uint32_t count = std::min(this->localInputCount - this->acknowledgedCount, maxInputsPerPacket);
+    const uint32_t first = this->localInputCount - count;
+    this->packet.resize(packetHeaderSize + count);
+    writeU32LE(this->packet.data(), this->remoteInputCount);
+    writeU32LE(this->packet.data() + 4, first);
+    this->packet[8] = static_cast<uint8_t>(count);
+    // The latest local checksum, which the remote player compares once it has confirmed the same frame.
+    const uint32_t checksumFrame = this->checksummedCount;
+    writeU32LE(this->packet.data() + 9, checksumFrame);
+    writeU64LE(this->packet.data() + 13, checksumFrame == 0U ? 0U : this->checksums[this->localPlayer][(checksumFrame - 1U) % rollbackInputWindow]);
+    for (uint32_t i = 0U; i < count; ++i) {
+        this->packet[packetHeaderSize + i] = this->inputs[this->localPlayer][(first + i) % rollbackInputWindow];
+    }
+    this->transport.send(this->packet);
+    ++this->stats.packetsSent;
+}
+
+void RollbackSession::rollBack() {
+    if (this->rollbackFrame >= this->currentFrame) {
+        this->rollbackFrame = noRollback;
+        return;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    this->match.loadState(this->states[this->rollbackFrame % savedStates]);
+    for (uint32_t frame = this->rollbackFrame; frame < this->currentFrame; ++frame) {
+        this->simulateFrame(frame);
+    }
+    const uint64_t elapsed = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    const uint32_t frames = this->currentFrame - this->rollbackFrame;
+    ++this->stats.rollbacks;
+    this->stats.resimulatedFrames += frames;
+    this->stats.longestRollback = std::max(this->stats.longestRollback, frames);
+    uint64_t& worst = this->stats.worstResimulationNanoseconds[std::min(frames, maxRollbackFrames)];
+    worst = std::max(worst, elapsed);
+    this->rollbackFrame = noRollback;
+}
+
+void RollbackSession::addChecksum(const size_t player, const uint32_t frame, const uint64_t checksum) {
+    if (this->checksumFrames[player][frame % rollbackInputWindow] == frame + 1U) {
+        return;
+    }
+    this->checksums[player][frame % rollbackInputWindow] = checksum;
+    this->checksumFrames[player][frame % rollbackInputWindow] = frame + 1U;
+    const size_t otherPlayer = 1UZ - player;
+    if (this->checksumFrames[otherPlayer][frame % rollbackInputWindow] != frame + 1U) {
+        return;
+    }
+    ++this->stats.checksumsCompared;
+    if (this->checksums[otherPlayer][frame % rollbackInputWindow] != checksum) {
+        this->stats.firstDesyncFrame = std::min(this->stats.firstDesyncFrame, frame);
+    }
+}
+
+void RollbackSession::checksumConfirmedFrames() {
+    // Only frames still saved can be checksummed, and only frames before the current one are saved.
+    const uint32_t end = std::min(this->getConfirmedFrame() + 1U, this->currentFrame);
+    if (this->checksummedCount >= end) {
+        return;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    this->checksummedCount = std::max(this->checksummedCount, this->currentFrame - std::min(this->currentFrame, savedStates));
+    for (; this->checksummedCount < end; ++this->checksummedCount) {
+        const uint32_t frame = this->checksummedCount;
+        this->addChecksum(this->localPlayer, frame, this->match.checksumState(this->states[frame % savedStates]));
+    }
+    this->stats.checksumNanoseconds += static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+}
+
+bool RollbackSession::advanceFrame(const uint8_t localInput) {
+    this->receiveInputs();
+    this->rollBack();
+    this->checksumConfirmedFrames();
+    if (this->currentFrame >= this->remoteInputCount + maxRollbackFrames
+        || this->localInputCount - this->acknowledgedCount >= rollbackInputWindow - maxRollbackFrames) {
+        ++this->stats.stalls;
+        this->sendInputs();
+        return false;
+    }
+    this->inputs[this->localPlayer][this->localInputCount % rollbackInputWindow] = localInput;
+    this->inputFrames[this->localPlayer][this->localInputCount % rollbackInputWindow] = this->localInputCount + 1U;
+    ++this->localInputCount;
+    this->sendInputs();
+    this->simulateFrame(this->currentFrame);
+    ++this->currentFrame;
+    ++this->stats.framesAdvanced;
+    return true;
+}
+
+uint32_t RollbackSession::getCurrentFrame() const { return this->currentFrame; }
+
+uint32_t RollbackSession::getConfirmedFrame() const {
+    return std::min(this->remoteInputCount, this->localInputCount);
+}
+
+bool RollbackSession::getConfirmedState(const uint32_t frame, MatchState& state) const {
+    if (frame > this->currentFrame || frame > this->getConfirmedFrame() || frame + savedStates <= this->currentFrame) {
+        return false;
+    }
+    if (frame == this->currentFrame) {
+        this->match.saveState(state);
+    } else {
+        state = this->states[frame % savedStates];
+    }
+    return true;
+}
+
+const RollbackStats& RollbackSession::getStats() const { return this->stats; }
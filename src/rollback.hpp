@@ -0,0 +1,161 @@
+#pragma once
+
+#include "command_input_parser.hpp"
+#include "match.hpp"
+#include "transport.hpp"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+/**
+ * The most frames that the remote player's inputs can be predicted for, after which the game waits for them.
+ */
+constexpr uint32_t maxRollbackFrames = 8U;
+/**
+ * The number of recent frames of inputs kept for each player.
+ */
+constexpr uint32_t rollbackInputWindow = 64U;
+
+/**
+ * What a @c RollbackSession has done so far.
+ */
+struct RollbackStats {
+    uint64_t framesAdvanced = 0U; /**< The number of frames simulated for the first time. */
+    uint64_t stalls = 0U; /**< The number of frames spent waiting for the remote player's inputs. */
+    uint64_t rollbacks = 0U; /**< The number of times that a prediction was wrong and frames were simulated again. */
+    uint64_t resimulatedFrames = 0U; /**< The number of frames simulated again over every rollback. */
+    uint32_t longestRollback = 0U; /**< The most frames simulated again in one rollback. */
+    std::array<uint64_t, maxRollbackFrames + 1U> worstResimulationNanoseconds{}; /**< The longest time taken by a rollback, by the number of frames it simulated again. */
+    uint64_t packetsSent = 0U; /**< The number of packets sent. */
+    uint64_t packetsReceived = 0U; /**< The number of valid packets received. */
+    uint64_t checksumsCompared = 0U; /**< The number of confirmed frames whose checksum was compared with the remote player's. */
+    uint32_t firstDesyncFrame = UINT32_MAX; /**< The first confirmed frame whose checksum differed from the remote player's, @c UINT32_MAX if none has. */
+    uint64_t checksumNanoseconds = 0U; /**< The total time spent checksumming confirmed frames. */
+};
+
+/**
+ * Plays a match against a remote player with rollback: the remote player's inputs are predicted, and when their real
+ * inputs arrive and differ from the prediction, the match is restored to the first wrong frame and simulated again.
+ *
+ * Each packet holds every local input that the other player has not acknowledged yet, so lost packets need no resending.
+ * Once both players' inputs for a frame are known, the state at the start of that frame is checksummed, and the
+ * latest checksum goes out with every packet so that each side can tell when the matches stop agreeing.
+ *
+ * Packets are little-endian: the number of remote inputs received so far (4 bytes), the frame of the first input
+ * (4 bytes), the number of inputs (1 byte), one more than the frame of the checksum (4 bytes, 0 for none), the
+ * @c Match::checksumState of that frame (8 bytes), then one byte per input from @c packInput .
+ */
+class RollbackSession {
+private:
+    static constexpr uint32_t savedStates = maxRollbackFrames + 1U; /**< The number of frames of match state kept. */
+    static constexpr uint32_t noRollback = UINT32_MAX; /**< Marks that no frame needs to be simulated again. */
+    Match& match; /**< The match being played. */
+    std::array<PackedCommandInputParser*, 2> controllers; /**< The command input parsers of both players of the match. */
+    Transport& transport; /**< How to reach the remote player. */
+    const size_t localPlayer; /**< The index of the local player, 0 for player 1 and 1 for player 2. */
+    const size_t remotePlayer; /**< The index of the remote player. */
+    uint32_t currentFrame = 0U; /**< The next frame to simulate. */
+    std::array<MatchState, savedStates> states; /**< The state of the match at the start of each recent frame. */
+    std::array<std::array<uint8_t, rollbackInputWindow>, 2> inputs{}; /**< The real inputs of each player, indexed by frame. */
+    std::array<std::array<uint32_t, rollbackInputWindow>, 2> inputFrames{}; /**< One more than the frame that each input belongs to, 0 for none. */
+    std::array<uint8_t, rollbackInputWindow> usedRemoteInputs{}; /**< The remote input (real or predicted) that each recent frame was simulated with. */
+    uint32_t localInputCount; /**< The number of local inputs so far, including the input delay. */
+    uint32_t remoteInputCount = 0U; /**< The number of remote inputs received in a row from frame 0. */
+    uint32_t acknowledgedCount = 0U; /**< The number of local inputs that the remote player has received in a row from frame 0. */
+    uint32_t rollbackFrame = noRollback; /**< The first frame that was simulated with a wrong prediction. */
+    std::array<std::array<uint64_t, rollbackInputWindow>, 2> checksums{}; /**< The checksum of each recent confirmed frame, locally and remotely, indexed by frame. */
+    std::array<std::array<uint32_t, rollbackInputWindow>, 2> checksumFrames{}; /**< One more than the frame that each checksum belongs to, 0 for none. */
+    uint32_t checksummedCount = 0U; /**< The number of confirmed frames checksummed locally in a row from frame 0. */
+    RollbackStats stats; /**< What the session has done so far. */
+    std::vector<uint8_t> packet; /**< The buffer for sending and receiving packets. */
+    /**
+     * Checks whether a player's real input for a frame is known.
+     * @param player The index of the player.
+     * @param frame The frame.
+     * @return Whether the input is known.
+     */
+    bool hasInput(size_t player, uint32_t frame) const;
+    /**
+     * Gets the remote player's input for a frame, predicting it if it has not arrived yet.
+     * @param frame The frame.
+     * @return The real input if known, otherwise the last input received in a row.
+     */
+    uint8_t remoteInputFor(uint32_t frame) const;
+    /**
+     * Saves the state of the match, then simulates one frame.
+     * @param frame The frame to simulate, which must be the frame the match is at.
+     */
+    void simulateFrame(uint32_t frame);
+    /**
+     * Takes every packet that has arrived, and notes the first frame that was predicted wrong.
+     */
+    void receiveInputs();
+    /**
+     * Sends every local input that the remote player has not acknowledged yet.
+     */
+    void sendInputs();
+    /**
+     * Restores the match to the first frame that was predicted wrong, and simulates it again up to the current frame.
+     */
+    void rollBack();
+    /**
+     * Keeps a player's checksum of a confirmed frame, and compares it with the other player's if that has arrived.
+     * @param player The index of the player that the checksum came from.
+     * @param frame The frame.
+     * @param checksum The @c Match::checksumState of the frame.
+     */
+    void addChecksum(size_t player, uint32_t frame, uint64_t checksum);
+    /**
+     * Checksums every saved frame that has become confirmed since the last call.
+     */
+    void checksumConfirmedFrames();
+public:
+    /**
+     * Starts a session.
+     * @param match The match to play, at its first frame.
+     * @param player1Controller The command input parser of player 1 in the match.
+     * @param player2Controller The command input parser of player 2 in the match.
+     * @param transport How to reach the remote player.
+     * @param localPlayer The index of the local player, 0 for player 1 and 1 for player 2.
+     * @param inputDelay The number of frames between the local player pressing something and it happening, which gives
+     * the remote player's inputs time to arrive. Must be less than @c maxRollbackFrames .
+     * @exception std::invalid_argument The local player or the input delay is out of range.
+     */
+    RollbackSession(Match& match,
+                    PackedCommandInputParser& player1Controller,
+                    PackedCommandInputParser& player2Controller,
+                    Transport& transport,
+                    size_t localPlayer,
+                    uint32_t inputDelay = 2U);
+    /**
+     * Receives the remote player's inputs, rolls back if a prediction was wrong, then simulates the next frame.
+     * Meant to be called once per frame.
+     * @param localInput The local player's input for this frame, from @c packInput .
+     * @return Whether a frame was simulated (@c true), or the remote player is too far behind and the local input
+     * was dropped (@c false).
+     */
+    bool advanceFrame(uint8_t localInput);
+    /**
+     * Gets the next frame to simulate.
+     * @return The number of frames simulated.
+     */
+    uint32_t getCurrentFrame() const;
+    /**
+     * Gets how far both players' inputs are known.
+     * @return The number of frames from the start for which both players' real inputs are known.
+     */
+    uint32_t getConfirmedFrame() const;
+    /**
+     * Gets the state of the match at the start of a frame, if it no longer depends on any prediction.
+     * @param frame The frame.
+     * @param state Where to put the state.
+     * @return Whether the state was found: every input before the frame is known, and the frame is recent enough.
+     */
+    bool getConfirmedState(uint32_t frame, MatchState& state) const;
+    /**
+     * Gets what the session has done so far.
+     * @return The statistics of the session.
+     */
+    const RollbackStats& getStats() const;
+};
@@ -0,0 +1,256 @@
+#include "command_input_parser.hpp"
+#include "desync.hpp"
+#include "frame_timer.hpp"
+#include "input_history.hpp"
+#include "match.hpp"
+#include "rollback.hpp"
+#include "transport.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include <SDL3/SDL.h>
+
+/**
+ * The length of one frame at 60 frames per second, in nanoseconds.
+ */
+constexpr uint64_t frameNanoseconds = SDL_NS_PER_SECOND / ticksPerSecond;
+
+/**
+ * One player of a netplay test: their own copy of the match, and the bot pressing their buttons.
+ */
+struct Peer {
+    PackedCommandInputParser player1Controller; /**< Player 1's inputs in this peer's match. */
+    PackedCommandInputParser player2Controller; /**< Player 2's inputs in this peer's match. */
+    Match match; /**< This peer's copy of the match. */
+    RandomCommandInputParser bot; /**< Decides what the local player presses. */
+    RollbackSession session; /**< Keeps the match in sync with the other peer. */
+    /**
+     * Sets up one player of a netplay test.
+     * @param character The character that both players play.
+     * @param transport How to reach the other peer.
+     * @param localPlayer The index of the local player, 0 for player 1 and 1 for player 2.
+     * @param inputDelay The input delay, in frames.
+     * @param seed The seed of the bot.
+     */
+    Peer(const std::string& character, Transport& transport, const size_t localPlayer, const uint32_t inputDelay, const uint_fast32_t seed)
+        : match{character.c_str(), &player1Controller, character.c_str(), &player2Controller},
+          bot{seed},
+          session{match, player1Controller, player2Controller, transport, localPlayer, inputDelay} {}
+    /**
+     * Has the bot press its buttons, then advances the session.
+     * @return Whether a frame was simulated.
+     */
+    bool advance() {
+        this->bot.updateInput();
+        return this->session.advanceFrame(packInput(this->bot.inputToDirection(), this->bot.getButton()));
+    }
+};
+
+/**
+ * Prints what a session has done.
+ * @param name The name of the peer.
+ * @param stats The statistics of the peer's session.
+ */
+static void printStats(const std::string& name, const RollbackStats& stats) {
+    std::cout << name << ": " << stats.framesAdvanced << " frames, " << stats.stalls << " stalls, "
+              << stats.rollbacks << " rollbacks (" << stats.resimulatedFrames << " frames re-simulated, longest "
+              << stats.longestRollback << "), " << stats.packetsSent << " packets sent, "
+              << stats.packetsReceived << " received" << std::endl;
+    std::cout << "  " << stats.checksumsCompared << " checksums compared, ";
+    if (stats.firstDesyncFrame == UINT32_MAX) {
+        std::cout << "no desync";
+    } else {
+        std::cout << "DESYNC from frame " << stats.firstDesyncFrame;
+    }
+    if (stats.framesAdvanced != 0U) {
+        const double checksumNanoseconds = static_cast<double>(stats.checksumNanoseconds) / static_cast<double>(stats.framesAdvanced);
+        std::cout << ", checksums took " << checksumNanoseconds << " ns per frame ("
+                  << checksumNanoseconds * 100.0 / static_cast<double>(frameNanoseconds) << "% of a frame)";
+    }
+    std::cout << std::endl;
+    for (uint32_t frames = 1U; frames <= maxRollbackFrames; ++frames) {
+        if (stats.worstResimulationNanoseconds[frames] != 0U) {
+            std::cout << "  worst " << frames << "-frame rollback: "
+                      << static_cast<double>(stats.worstResimulationNanoseconds[frames]) / 1000.0 << " us" << std::endl;
+        }
+    }
+}
+
+/**
+ * Measures the time to roll back and simulate again, without any network, by restoring a saved state and
+ * simulating the same frames over and over.
+ * @param character The character that both players play.
+ * @param frames The number of frames to roll back.
+ * @param repetitions The number of rollbacks to time.
+ */
+static void measureResimulation(const std::string& character, const uint32_t frames, const size_t repetitions) {
+    RandomCommandInputParser player1Controller(1U);
+    RandomCommandInputParser player2Controller(2U);
+    Match match(character.c_str(), &player1Controller, character.c_str(), &player2Controller);
+    for (int i = 0; i < 600; ++i) {
+        match.step();
+    }
+    std::array<MatchState, maxRollbackFrames + 1U> states;
+    MatchState start;
+    uint64_t worst = 0U;
+    uint64_t total = 0U;
+    for (size_t r = 0UZ; r < repetitions; ++r) {
+        match.saveState(start);
+        const auto begin = std::chrono::steady_clock::now();
+        match.loadState(start);
+        for (uint32_t f = 0U; f < frames; ++f) {
+            match.saveState(states[f]);
+            match.step();
+        }
+        const uint64_t elapsed = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count());
+        worst = std::max(worst, elapsed);
+        total += elapsed;
+    }
+    std::cout << "Forced " << frames << "-frame rollback over " << repetitions << " runs: worst "
+              << static_cast<double>(worst) / 1000.0 << " us, mean "
+              << static_cast<double>(total) / static_cast<double>(repetitions) / 1000.0 << " us (budget "
+              << static_cast<double>(frameNanoseconds) / 1000.0 << " us)" << std::endl;
+}
+
+/**
+ * Prints how to use the rollback test harness.
+ * @param program The name the program was started with.
+ */
+static void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [options]" << std::endl
+              << "  --character <name>    Character for both players (default: Debuggy)" << std::endl
+              << "  --frames <n>          Frames to play (default: 3600)" << std::endl
+              << "  --input-delay <n>     Input delay in frames (default: 2)" << std::endl
+              << "  --seed <n>            Seed of the bots and the link (default: 0)" << std::endl
+              << "In-process loopback (default):" << std::endl
+              << "  --delay <ms>          One-way latency (default: 50)" << std::endl
+              << "  --jitter <ms>         Extra random latency per packet (default: 10)" << std::endl
+              << "  --loss <percent>      Packets dropped (default: 5)" << std::endl
+              << "Two processes over UDP, in real time:" << std::endl
+              << "  --udp <local port> <remote host> <remote port> --player <1|2>" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    std::string character = "Debuggy";
+    uint64_t frames = 3600U;
+    uint32_t inputDelay = 2U;
+    uint_fast32_t seed = 0U;
+    LinkConditions conditions{50U * SDL_NS_PER_MS, 10U * SDL_NS_PER_MS, 0.05, 0U};
+    bool udp = false;
+    uint16_t localPort = 0U;
+    std::string remoteHost;
+    uint16_t remotePort = 0U;
+    size_t localPlayer = 0UZ;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string argument = argv[i];
+        if (argument == "--help" || argument == "-h") {
+            printUsage(argv[0]);
+            return 0;
+        }
+        if (argument == "--udp" && i + 3 < argc) {
+            udp = true;
+            localPort = static_cast<uint16_t>(std::strtoul(argv[++i], nullptr, 10));
+            remoteHost = argv[++i];
+            remotePort = static_cast<uint16_t>(std::strtoul(argv[++i], nullptr, 10));
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Error: missing value for " << argument << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+        const char* value = argv[++i];
+        if (argument == "--character") {
+            character = value;
+        } else if (argument == "--frames") {
+            frames = std::strtoull(value, nullptr, 10);
+        } else if (argument == "--input-delay") {
+            inputDelay = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+        } else if (argument == "--seed") {
+            seed = static_cast<uint_fast32_t>(std::strtoul(value, nullptr, 10));
+        } else if (argument == "--delay") {
+            conditions.delayNanoseconds = static_cast<uint64_t>(std::strtod(value, nullptr) * SDL_NS_PER_MS);
+        } else if (argument == "--jitter") {
+            conditions.jitterNanoseconds = static_cast<uint64_t>(std::strtod(value, nullptr) * SDL_NS_PER_MS);
+        } else if (argument == "--loss") {
+            conditions.lossRate = std::strtod(value, nullptr) / 100.0;
+        } else if (argument == "--player") {
+            localPlayer = std::strtoul(value, nullptr, 10) == 2UL ? 1UZ : 0UZ;
+        } else {
+            std::cerr << "Error: unknown option " << argument << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    conditions.seed = seed;
+
+    try {
+        if (udp) {
+            UdpTransport transport(localPort, remoteHost, remotePort);
+            Peer peer(character, transport, localPlayer, inputDelay, seed + localPlayer);
+            FrameLimiter limiter(ticksPerSecond);
+            limiter.start(SDL_GetTicksNS());
+            while (peer.session.getCurrentFrame() < frames) {
+                peer.advance();
+                limiter.wait();
+            }
+            printStats("Player " + std::to_string(localPlayer + 1UZ), peer.session.getStats());
+            if (peer.session.getStats().firstDesyncFrame != UINT32_MAX) {
+                return 1;
+            }
+        } else {
+            LoopbackLink link(conditions);
+            Peer player1(character, link.endpoint(0UZ), 0UZ, inputDelay, seed);
+            Peer player2(character, link.endpoint(1UZ), 1UZ, inputDelay, seed + 1U);
+            const auto start = std::chrono::steady_clock::now();
+            for (uint64_t tick = 0U; player1.session.getCurrentFrame() < frames || player2.session.getCurrentFrame() < frames; ++tick) {
+                link.setTime(tick * frameNanoseconds);
+                player1.advance();
+                player2.advance();
+            }
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            std::cout << "Played " << frames << " frames over loopback ("
+                      << static_cast<double>(conditions.delayNanoseconds) / SDL_NS_PER_MS << " ms delay, "
+                      << static_cast<double>(conditions.jitterNanoseconds) / SDL_NS_PER_MS << " ms jitter, "
+                      << conditions.lossRate * 100.0 << "% loss) in " << elapsed.count() << " s" << std::endl;
+            printStats("Player 1", player1.session.getStats());
+            printStats("Player 2", player2.session.getStats());
+
+            const uint32_t checkFrame = std::min({player1.session.getConfirmedFrame(), player2.session.getConfirmedFrame(),
+                                                  player1.session.getCurrentFrame(), player2.session.getCurrentFrame()});
+            MatchState player1State;
+            MatchState player2State;
+            if (player1.session.getConfirmedState(checkFrame, player1State)
+                && player2.session.getConfirmedState(checkFrame, player2State)) {
+                const bool inSync = std::memcmp(&player1State, &player2State, sizeof(MatchState)) == 0;
+                std::cout << (inSync ? "In sync" : "DESYNC") << " at frame " << checkFrame << std::endl;
+                for (const FieldDifference& difference : diffMatchStates(player1State, player2State)) {
+                    std::cout << "  " << difference << std::endl;
+                }
+                if (!inSync) {
+                    return 1;
+                }
+            }
+            if (player1.session.getStats().firstDesyncFrame != UINT32_MAX || player2.session.getStats().firstDesyncFrame != UINT32_MAX) {
+                return 1;
+            }
+        }
+        measureResimulation(character, 7U, 1000UZ);
+        measureResimulation(character, 8U, 1000UZ);
+    } catch (const std::exception& e) {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,132 @@
+#include "roster.hpp"
+
+#include "character_data.hpp"
+#include "character_pack.hpp"
+#include "compiled_character.hpp"
+#include "data_exception.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <SDL3/SDL.h>
+
+/**
+ * The extension of character pack files.
+ */
+static constexpr const char* packExtension = ".ffc";
+
+/**
+ * Guards @c characterDirectory and @c openPacks , since matches are set up on worker threads.
+ */
+static std::mutex rosterMutex;
+
+/**
+ * The directory that character packs are found in, empty until it is first needed.
+ */
+static std::string characterDirectory;
+
+/**
+ * The packs that are currently open, which are unmapped as soon as nothing uses them.
+ */
+static std::map<std::string, std::weak_ptr<const CharacterPack>> openPacks;
+
+/**
+ * Gets the character directory, defaulting to @c characters next to the game.
+ * @return The character directory.
+ */
+static const std::string& lockedCharacterDirectory() {
+    if (characterDirectory.empty()) {
+        const char* basePath = SDL_GetBasePath();
+        characterDirectory = (std::filesystem::path(basePath == nullptr ? "" : basePath) / "characters").string();
+    }
+    return characterDirectory;
+}
+
+/**
+ * Checks whether a name can be a character, so that it cannot point outside of the character directory.
+ * @param name The name.
+ * @return Whether the name has no path separators and does not start with a dot.
+ */
+static bool isValidName(const std::string& name) {
+    return !name.empty() && name.front() != '.' && name.find_first_of("/\\") == std::string::npos;
+}
+
+void setCharacterDirectory(const std::string& directory) {
+    const std::lock_guard lock(rosterMutex);
+    characterDirectory = directory;
+}
+
+std::string getCharacterDirectory() {
+    const std::lock_guard lock(rosterMutex);
+    return lockedCharacterDirectory();
+}
+
+std::vector<std::string> listCharacters() {
+    std::vector<std::string> names;
+    for (const EmbeddedCharacter& character : getEmbeddedRoster()) {
+        names.emplace_back(character.name);
+    }
+    std::error_code error;
+    for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(getCharacterDirectory(), error)) {
+        if (entry.path().extension() == packExtension && isValidName(entry.path().stem().string())) {
+            names.push_back(entry.path().stem().string());
+        }
+    }
+    std::ranges::sort(names);
+    names.erase(std::ranges::unique(names).begin(), names.end());
+    return names;
+}
+
+std::shared_ptr<const CharacterPack> openCharacterPack(const std::string& name) {
+    if (!isValidName(name)) {
+        throw DataException<unsigned short>(std::string(__PRETTY_FUNCTION__) + " while finding " + name, std::string("Invalid character name"));
+    }
+    const std::lock_guard lock(rosterMutex);
+    std::weak_ptr<const CharacterPack>& cached = openPacks[name];
+    if (std::shared_ptr<const CharacterPack> pack = cached.lock()) {
+        return pack;
+    }
+    std::shared_ptr<const CharacterPack> pack;
+    const std::span<const EmbeddedCharacter> embedded = getEmbeddedRoster();
+    const auto it = std::ranges::find_if(embedded, [&name](const EmbeddedCharacter& character) {
+        return name == character.name;
+    });
+    if (it != embedded.end()) {
+        pack = std::make_shared<const CharacterPack>(std::span<const std::byte>(it->start, it->end));
+    } else {
+        const std::filesystem::path path = std::filesystem::path(lockedCharacterDirectory()) / (name + packExtension);
+        std::error_code error;
+        if (!std::filesystem::is_regular_file(path, error)) {
+            openPacks.erase(name);
+            throw DataException<unsigned short>(std::string(__PRETTY_FUNCTION__) + " while finding " + name, std::string("No such character in ") + lockedCharacterDirectory());
+        }
+        try {
+            pack = std::make_shared<const CharacterPack>(path.string());
+        } catch (...) {
+            openPacks.erase(name);
+            throw;
+        }
+    }
+    cached = pack;
+    return pack;
+}
+
+CharacterData loadCharacterData(const std::string& name) {
+    const std::span<const ParsedCharacter> parsed = getParsedRoster();
+    const auto it = std::ranges::find_if(parsed, [&name](const ParsedCharacter& character) {
+        return name == character.name;
+    });
+    if (it != parsed.end()) {
+        return readCompiledRecords(it->records, false);
+    }
+    // The pack stays mapped as long as the character might still read its rarely used animations from it.
+    const std::shared_ptr<const CharacterPack> pack = openCharacterPack(name);
+    return readCompiledCharacter(pack->getCompiled(), false, pack);
+}
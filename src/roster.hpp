@@ -0,0 +1,79 @@
+#pragma once
+
+#include "character_data.hpp"
+#include "character_pack.hpp"
+#include "compiled_character.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+/**
+ * A compiled character linked into the game, when it is built with @c FOSS_FIGHT_EMBED_ROSTER .
+ */
+struct EmbeddedCharacter {
+    const char* name; /**< The name of the character. */
+    const std::byte* start; /**< The first byte of the compiled character. */
+    const std::byte* end; /**< The byte after the last byte of the compiled character. */
+};
+
+/**
+ * Gets the characters linked into the game. Generated by CMake from the roster.
+ * @return The linked characters, empty unless the game is built with @c FOSS_FIGHT_EMBED_ROSTER .
+ */
+std::span<const EmbeddedCharacter> getEmbeddedRoster();
+
+/**
+ * A character whose data was parsed while compiling the game, when it is built with @c FOSS_FIGHT_CONSTEXPR_ROSTER .
+ */
+struct ParsedCharacter {
+    const char* name; /**< The name of the character. */
+    CompiledRecords records; /**< The character's records, which live as long as the game. */
+};
+
+/**
+ * Gets the characters parsed while compiling the game. Generated by CMake from the roster.
+ * @return The parsed characters, empty unless the game is built with @c FOSS_FIGHT_CONSTEXPR_ROSTER .
+ */
+std::span<const ParsedCharacter> getParsedRoster();
+
+/**
+ * Changes the directory that character packs are found in.
+ * @param directory The directory holding a @c <name>.ffc file for each character.
+ */
+void setCharacterDirectory(const std::string& directory);
+
+/**
+ * Gets the directory that character packs are found in.
+ * @return The directory, @c characters next to the game unless changed with @c setCharacterDirectory .
+ */
+std::string getCharacterDirectory();
+
+/**
+ * Lists every character that can be played.
+ * @return The names of the characters linked into the game and of the packs in the character directory, sorted and
+ * without duplicates.
+ */
+std::vector<std::string> listCharacters();
+
+/**
+ * Opens the compiled data of a character, preferring one linked into the game to a pack in the character directory.
+ * While any pointer to a pack is alive, opening the same character again shares it instead of mapping it again.
+ * Safe to call from any thread.
+ * @param name The name of the character.
+ * @return The character's pack.
+ * @exception DataException Throws a <c>DataException<unsigned short></c> when there is no such character, or any of the exceptions thrown by @c CharacterPack::CharacterPack .
+ */
+std::shared_ptr<const CharacterPack> openCharacterPack(const std::string& name);
+
+/**
+ * Loads the data of a character, preferring data parsed while compiling the game to its pack, so that only the sprite
+ * sheet has to come from the pack. Only the combat animations are read: the ones for which @c isRarelyUsedAnimation is
+ * @c true are left to @c CharacterData::deferred , which keeps the pack mapped until they are read.
+ * @param name The name of the character.
+ * @return The character's data.
+ * @exception DataException Any of the exceptions thrown by @c openCharacterPack , @c CompiledCharacter::CompiledCharacter or @c readCompiledRecords .
+ */
+CharacterData loadCharacterData(const std::string& name);
@@ -0,0 +1,68 @@
+#include "roster_loader.hpp"
+
+#include "character_data.hpp"
+#include "character_renderer.hpp"
+#include "roster.hpp"
+
+#include <cstddef>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+float LoadProgress::fraction() const {
+    return this->requested == 0UZ ? 1.0F : static_cast<float>(this->finished) / static_cast<float>(this->requested);
+}
+
+RosterLoader::RosterLoader(const size_t threadCount) : pool(threadCount) {}
+
+RosterLoader::~RosterLoader() {
+    this->stopping = true;
+}
+
+std::shared_future<std::shared_ptr<const LoadedCharacter>> RosterLoader::load(const std::string& name) {
+    const std::lock_guard lock(this->mutex);
+    if (const auto it = this->loads.find(name); it != this->loads.end()) {
+        return it->second;
+    }
+    // The pool only takes copyable tasks, so the promise is shared with the task.
+    const auto promise = std::make_shared<std::promise<std::shared_ptr<const LoadedCharacter>>>();
+    std::shared_future<std::shared_ptr<const LoadedCharacter>> future = promise->get_future().share();
+    this->loads.emplace(name, future);
+    ++this->requested;
+    this->pool.submit([this, name, promise] {
+        try {
+            if (this->stopping) {
+                throw std::runtime_error("Loading " + name + " was cancelled");
+            }
+            CharacterData data = loadCharacterData(name);
+            PreparedSpriteSheets sheets = CharacterRenderer::prepare(name, data.palettes);
+            promise->set_value(std::make_shared<const LoadedCharacter>(name, std::move(data), std::move(sheets)));
+        } catch (...) {
+            ++this->failed;
+            promise->set_exception(std::current_exception());
+        }
+        ++this->finished;
+    });
+    return future;
+}
+
+void RosterLoader::release(const std::string& name) {
+    const std::lock_guard lock(this->mutex);
+    this->loads.erase(name);
+}
+
+void RosterLoader::preloadRoster() {
+    for (const std::string& name : listCharacters()) {
+        this->load(name);
+    }
+}
+
+LoadProgress RosterLoader::getProgress() const {
+    // Finished first, so that it is never ahead of the number asked for.
+    const size_t finished = this->finished;
+    return LoadProgress(this->requested, finished, this->failed);
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "character_data.hpp"
+#include "character_renderer.hpp"
+#include "work_stealing_pool.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+/**
+ * A character whose data is read and whose sprite sheets are recolored, so that giving it to a match only takes
+ * making its @c Character and uploading its sprite sheets with @c CharacterRenderer .
+ */
+struct LoadedCharacter {
+    std::string name; /**< The name of the character. */
+    CharacterData data; /**< The character's data, copied into each @c Character made from it. */
+    PreparedSpriteSheets sheets; /**< The character's sprite sheet in every palette. */
+};
+
+/**
+ * How far a @c RosterLoader has got.
+ */
+struct LoadProgress {
+    size_t requested = 0UZ; /**< How many characters have been asked for. */
+    size_t finished = 0UZ; /**< How many of them are loaded, including the ones that failed. */
+    size_t failed = 0UZ; /**< How many of them could not be loaded. */
+    /**
+     * Gets how much of the loading is done.
+     * @return From 0 to 1, 1 when nothing has been asked for.
+     */
+    float fraction() const;
+};
+
+/**
+ * Loads characters in the background. Reading the data and recoloring the sprite sheets run on the loader's own
+ * workers, and only uploading the sprite sheets is left for the render thread, since an @c SDL_Renderer can only be
+ * used from the thread that made it. Safe to use from any thread.
+ */
+class RosterLoader {
+private:
+    mutable std::mutex mutex; /**< Guards @c RosterLoader::loads . */
+    std::map<std::string, std::shared_future<std::shared_ptr<const LoadedCharacter>>> loads; /**< Every character asked for and not released since, by name. */
+    std::atomic<size_t> requested = 0UZ; /**< How many characters have been asked for. */
+    std::atomic<size_t> finished = 0UZ; /**< How many of them are loaded, including the ones that failed. */
+    std::atomic<size_t> failed = 0UZ; /**< How many of them could not be loaded. */
+    std::atomic<bool> stopping = false; /**< Whether the loader is being destroyed, so that loads not started yet are skipped. */
+    WorkStealingPool pool; /**< The workers, last so that they stop before anything they use is destroyed. */
+public:
+    /**
+     * Starts the workers.
+     * @param threadCount The number of workers, 0 for one per hardware thread.
+     */
+    explicit RosterLoader(size_t threadCount = 0UZ);
+    /**
+     * Waits for the loads that have started, and skips the rest.
+     */
+    ~RosterLoader();
+    RosterLoader(const RosterLoader&) = delete;
+    RosterLoader& operator=(const RosterLoader&) = delete;
+    /**
+     * Starts loading a character, unless it was already asked for.
+     * @param name The name of the character.
+     * @return The loaded character once it is ready. Getting it rethrows any of the exceptions thrown by
+     * @c loadCharacterData and @c CharacterRenderer::prepare .
+     */
+    std::shared_future<std::shared_ptr<const LoadedCharacter>> load(const std::string& name);
+    /**
+     * Forgets a character, so that its data and sprite sheets are freed as soon as nothing else holds them, such as
+     * once a match has copied its data and uploaded its sprite sheets. Asking for it again loads it again. A load that
+     * has not finished yet still runs, and its result is dropped unless something still holds its future.
+     * @param name The name of the character.
+     */
+    void release(const std::string& name);
+    /**
+     * Starts loading every character in @c listCharacters that was not asked for yet, or that was released since. Loads are not run in the order
+     * they are asked for, so the characters needed right away are best waited for before preloading the rest.
+     */
+    void preloadRoster();
+    /**
+     * Gets how far the loader has got.
+     * @return The number of characters asked for, loaded and failed.
+     */
+    LoadProgress getProgress() const;
+};
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <cmath>
+#include <compare>
+#include <cstdint>
+
+#include <SDL3/SDL.h>
+
+/**
+ * Determines whether physics uses fixed-point numbers (@c true) or @c float (@c false). Fixed-point physics gives
+ * bit-identical matches on any compiler, optimization level and CPU, which replays and rollback depend on.
+ * Normally set by the @c FOSS_FIGHT_FIXED_POINT CMake option.
+ */
+#ifndef FOSS_FIGHT_FIXED_POINT
+#define FOSS_FIGHT_FIXED_POINT true
+#endif
+
+/**
+ * A signed fixed-point number with 16 integer bits and 16 fractional bits, so 1/65536 of a pixel of precision over
+ * ±32768 pixels. Every operation is done with integers, so the results never depend on the compiler or CPU.
+ */
+class Fixed {
+private:
+    int32_t raw = 0; /**< The number multiplied by @c Fixed::one . */
+public:
+    static constexpr int fractionalBits = 16; /**< The number of bits after the point. */
+    static constexpr int32_t one = 1 << fractionalBits; /**< The raw value of 1. */
+    /**
+     * Constructs 0.
+     */
+    constexpr Fixed() = default;
+    /**
+     * Constructs a whole number.
+     * @param value The number.
+     */
+    constexpr Fixed(const int value) : raw{value * one} {}
+    /**
+     * Constructs the nearest fixed-point number to a @c float . Only meant for loading data, never during a match.
+     * @param value The number.
+     */
+    constexpr explicit Fixed(const float value) : raw{static_cast<int32_t>(std::lround(value * static_cast<float>(one)))} {}
+    /**
+     * Constructs a number out of its raw value.
+     * @param raw The number multiplied by @c Fixed::one .
+     * @return The number.
+     */
+    static constexpr Fixed fromRaw(const int32_t raw) {
+        Fixed result;
+        result.raw = raw;
+        return result;
+    }
+    /**
+     * Gets the raw value of the number.
+     * @return The number multiplied by @c Fixed::one .
+     */
+    constexpr int32_t getRaw() const { return this->raw; }
+    /**
+     * Converts the number to a @c float , for rendering.
+     * @return The nearest @c float .
+     */
+    constexpr float toFloat() const { return static_cast<float>(this->raw) / static_cast<float>(one); }
+
+    constexpr Fixed operator-() const { return fromRaw(-this->raw); }
+    constexpr Fixed operator+(const Fixed other) const { return fromRaw(this->raw + other.raw); }
+    constexpr Fixed operator-(const Fixed other) const { return fromRaw(this->raw - other.raw); }
+    /**
+     * Multiplies two numbers, rounding towards negative infinity.
+     * @param other The other number.
+     * @return The product.
+     */
+    constexpr Fixed operator*(const Fixed other) const {
+        return fromRaw(static_cast<int32_t>((static_cast<int64_t>(this->raw) * other.raw) >> fractionalBits));
+    }
+    /**
+     * Divides two numbers, rounding towards 0.
+     * @param other The other number, which must not be 0.
+     * @return The quotient.
+     */
+    constexpr Fixed operator/(const Fixed other) const {
+        return fromRaw(static_cast<int32_t>((static_cast<int64_t>(this->raw) << fractionalBits) / other.raw));
+    }
+    constexpr Fixed& operator+=(const Fixed other) { return *this = *this + other; }
+    constexpr Fixed& operator-=(const Fixed other) { return *this = *this - other; }
+    constexpr Fixed& operator*=(const Fixed other) { return *this = *this * other; }
+    constexpr Fixed& operator/=(const Fixed other) { return *this = *this / other; }
+    constexpr auto operator<=>(const Fixed&) const = default;
+    constexpr bool operator==(const Fixed&) const = default;
+};
+
+#if FOSS_FIGHT_FIXED_POINT
+typedef Fixed Scalar; /**< The type of number used for physics. */
+#else
+typedef float Scalar; /**< The type of number used for physics. */
+#endif
+
+/**
+ * Converts a physics number to a @c float , for rendering.
+ * @param value The number.
+ * @return The nearest @c float .
+ */
+constexpr float toFloat(const Fixed value) { return value.toFloat(); }
+
+/**
+ * Converts a physics number to a @c float , for rendering.
+ * @param value The number.
+ * @return The same number.
+ */
+constexpr float toFloat(const float value) { return value; }
+
+/**
+ * A rectangle in physics numbers.
+ */
+struct ScalarRect {
+    Scalar x; /**< The x-coordinate of the top-left corner. */
+    Scalar y; /**< The y-coordinate of the top-left corner. */
+    Scalar w; /**< The width. */
+    Scalar h; /**< The height. */
+    /**
+     * Converts a @c SDL_FRect . Only meant for loading data, never during a match.
+     * @param rect The rectangle.
+     * @return The nearest rectangle in physics numbers.
+     */
+    static constexpr ScalarRect fromFRect(const SDL_FRect& rect) {
+        return ScalarRect(Scalar(rect.x), Scalar(rect.y), Scalar(rect.w), Scalar(rect.h));
+    }
+    /**
+     * Converts the rectangle to a @c SDL_FRect , for rendering.
+     * @return The nearest rectangle in @c float .
+     */
+    constexpr SDL_FRect toFRect() const {
+        return SDL_FRect(toFloat(this->x), toFloat(this->y), toFloat(this->w), toFloat(this->h));
+    }
+};
+
+/**
+ * Checks whether two rectangles overlap, the same way as @c SDL_HasRectIntersectionFloat : touching edges count, and
+ * rectangles with a negative width or height never overlap.
+ * @param a The first rectangle.
+ * @param b The second rectangle.
+ * @return Whether the rectangles overlap.
+ */
+constexpr bool hasIntersection(const ScalarRect& a, const ScalarRect& b) {
+    if (a.w < Scalar(0) || a.h < Scalar(0) || b.w < Scalar(0) || b.h < Scalar(0)) {
+        return false;
+    }
+    const Scalar left = a.x > b.x ? a.x : b.x;
+    const Scalar right = a.x + a.w < b.x + b.w ? a.x + a.w : b.x + b.w;
+    const Scalar top = a.y > b.y ? a.y : b.y;
+    const Scalar bottom = a.y + a.h < b.y + b.h ? a.y + a.h : b.y + b.h;
+    return left <= right && top <= bottom;
+}
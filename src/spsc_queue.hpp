@@ -0,0 +1,59 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+/**
+ * A fixed-size queue between exactly one thread that pushes and one thread that pops, which never locks or allocates.
+ *
+ * Each index is only written by one side, and sits on its own cache line so that the two threads do not fight over
+ * it. Each side also keeps a copy of the other side's index, and only reloads it when the queue looks full or empty.
+ * @tparam T The type of item, which must be copyable.
+ * @tparam Capacity The most items in the queue at once, which must be a power of two.
+ */
+template <typename T, size_t Capacity>
+class SpscQueue {
+private:
+    static_assert(Capacity != 0UZ && (Capacity & (Capacity - 1UZ)) == 0UZ, "SpscQueue capacity must be a power of two");
+    alignas(64) std::atomic<size_t> head = 0UZ; /**< The number of items ever popped, written by the consumer. */
+    size_t cachedTail = 0UZ; /**< The consumer's copy of @c SpscQueue::tail . */
+    alignas(64) std::atomic<size_t> tail = 0UZ; /**< The number of items ever pushed, written by the producer. */
+    size_t cachedHead = 0UZ; /**< The producer's copy of @c SpscQueue::head . */
+    alignas(64) std::array<T, Capacity> items{}; /**< The items, with item @c n in slot @c n modulo the capacity. */
+public:
+    /**
+     * Adds an item to the back of the queue. Only to be called by the producer.
+     * @param item The item.
+     * @return Whether there was room for the item.
+     */
+    bool tryPush(const T& item) {
+        const size_t position = this->tail.load(std::memory_order_relaxed);
+        if (position - this->cachedHead == Capacity) {
+            this->cachedHead = this->head.load(std::memory_order_acquire);
+            if (position - this->cachedHead == Capacity) {
+                return false;
+            }
+        }
+        this->items[position & (Capacity - 1UZ)] = item;
+        this->tail.store(position + 1UZ, std::memory_order_release);
+        return true;
+    }
+    /**
+     * Takes the item at the front of the queue. Only to be called by the consumer.
+     * @param item Where to put the item.
+     * @return Whether there was an item.
+     */
+    bool tryPop(T& item) {
+        const size_t position = this->head.load(std::memory_order_relaxed);
+        if (position == this->cachedTail) {
+            this->cachedTail = this->tail.load(std::memory_order_acquire);
+            if (position == this->cachedTail) {
+                return false;
+            }
+        }
+        item = this->items[position & (Capacity - 1UZ)];
+        this->head.store(position + 1UZ, std::memory_order_release);
+        return true;
+    }
+};
@@ -0,0 +1,93 @@
+#include "texture_atlas.hpp"
+
+#include "data_exception.hpp"
+
+#include <map>
+#include <string>
+
+#include <SDL3/SDL.h>
+
+std::map<std::string, TextureAtlas::Entry> TextureAtlas::textures;
+std::map<std::string, TextureAtlas::Sheet> TextureAtlas::sheets;
+
+std::string TextureAtlas::makeKey(const std::string& name, const unsigned short paletteIndex) {
+    return name + '#' + std::to_string(paletteIndex);
+}
+
+SDL_Texture* TextureAtlas::acquire(SDL_Renderer*& renderer, const std::string& key, SDL_Surface*& spriteSheet) {
+    Entry& entry = TextureAtlas::textures[key];
+    if (entry.texture == nullptr) {
+        entry.texture = SDL_CreateTexture(renderer, spriteSheet->format, SDL_TEXTUREACCESS_STATIC, spriteSheet->w, spriteSheet->h);
+        if (entry.texture == nullptr) {
+            TextureAtlas::textures.erase(key);
+            throw DataException<int>(std::string(__PRETTY_FUNCTION__) + " while creating texture for " + key, std::string(SDL_GetError()));
+        }
+        if (!SDL_SetTextureScaleMode(entry.texture, SDL_SCALEMODE_NEAREST)) {
+            SDL_DestroyTexture(entry.texture);
+            TextureAtlas::textures.erase(key);
+            throw DataException<int>(std::string(__PRETTY_FUNCTION__) + " while setting scale mode for " + key, std::string(SDL_GetError()), SDL_SCALEMODE_NEAREST);
+        }
+        if (!SDL_UpdateTexture(entry.texture, nullptr, spriteSheet->pixels, spriteSheet->pitch)) {
+            SDL_DestroyTexture(entry.texture);
+            TextureAtlas::textures.erase(key);
+            throw DataException<int>(std::string(__PRETTY_FUNCTION__) + " while updating texture for " + key, std::string(SDL_GetError()), spriteSheet->pitch);
+        }
+    }
+    ++entry.references;
+    return entry.texture;
+}
+
+SDL_Texture* TextureAtlas::tryAcquire(const std::string& key) {
+    const auto it = TextureAtlas::textures.find(key);
+    if (it == TextureAtlas::textures.end()) {
+        return nullptr;
+    }
+    ++it->second.references;
+    return it->second.texture;
+}
+
+SDL_Surface* TextureAtlas::acquireSheet(const std::string& name, SDL_Surface* (*load)(const std::string& name)) {
+    Sheet& sheet = TextureAtlas::sheets[name];
+    if (sheet.surface == nullptr) {
+        SDL_Surface* decoded = load(name);
+        if (decoded == nullptr) {
+            TextureAtlas::sheets.erase(name);
+            throw DataException<int>(std::string(__PRETTY_FUNCTION__) + " while loading sprite sheet for " + name, std::string(SDL_GetError()));
+        }
+        // Recoloring reads every pixel as 32 bits, whatever format the image was saved in.
+        if (decoded->format == SDL_PIXELFORMAT_RGBA32) {
+            sheet.surface = decoded;
+        } else {
+            sheet.surface = SDL_ConvertSurface(decoded, SDL_PIXELFORMAT_RGBA32);
+            SDL_DestroySurface(decoded);
+            if (sheet.surface == nullptr) {
+                TextureAtlas::sheets.erase(name);
+                throw DataException<int>(std::string(__PRETTY_FUNCTION__) + " while converting sprite sheet for " + name, std::string(SDL_GetError()));
+            }
+        }
+    }
+    ++sheet.references;
+    return sheet.surface;
+}
+
+void TextureAtlas::releaseSheet(const std::string& name) {
+    const auto it = TextureAtlas::sheets.find(name);
+    if (it == TextureAtlas::sheets.end()) {
+        return;
+    }
+    if (--it->second.references == 0UZ) {
+        SDL_DestroySurface(it->second.surface);
+        TextureAtlas::sheets.erase(it);
+    }
+}
+
+void TextureAtlas::release(const std::string& key) {
+    const auto it = TextureAtlas::textures.find(key);
+    if (it == TextureAtlas::textures.end()) {
+        return;
+    }
+    if (--it->second.references == 0UZ) {
+        SDL_DestroyTexture(it->second.texture);
+        TextureAtlas::textures.erase(it);
+    }
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <map>
+#include <string>
+
+#include <SDL3/SDL.h>
+
+/**
+ * A cache of sprite sheet textures, so that each sprite sheet is only uploaded to the GPU once.
+ * Every sprite of a character shares the same texture, and so do characters using the same sprite sheet and palette.
+ */
+class TextureAtlas {
+private:
+    /**
+     * A texture in the atlas, along with how many characters are using it.
+     */
+    struct Entry {
+        SDL_Texture* texture = nullptr; /**< The uploaded sprite sheet. */
+        size_t references = 0UZ; /**< How many characters are currently using the texture. */
+    };
+    /**
+     * A decoded sprite sheet in its original colors, along with how many characters are using it.
+     */
+    struct Sheet {
+        SDL_Surface* surface = nullptr; /**< The sprite sheet, in @c SDL_PIXELFORMAT_RGBA32 . */
+        size_t references = 0UZ; /**< How many characters are currently using the sprite sheet. */
+    };
+    static std::map<std::string, Entry> textures; /**< The uploaded sprite sheets, keyed by @c TextureAtlas::makeKey . */
+    static std::map<std::string, Sheet> sheets; /**< The decoded sprite sheets, keyed by character name. */
+public:
+    /**
+     * Creates the key for a sprite sheet.
+     * @param name The name of the character.
+     * @param paletteIndex The palette the sprite sheet was recolored with.
+     * @return A key unique to the character and palette.
+     */
+    static std::string makeKey(const std::string& name, unsigned short paletteIndex);
+    /**
+     * Gets the texture for a sprite sheet, uploading it if it has not been uploaded yet.
+     * @param renderer The renderer to upload the texture to.
+     * @param key The key of the sprite sheet, made with @c TextureAtlas::makeKey .
+     * @param spriteSheet The sprite sheet to upload if it is not in the atlas yet.
+     * @return The texture of the whole sprite sheet.
+     * @exception DataException Throws a @c DataException<int> when running into issues creating the texture.
+     */
+    static SDL_Texture* acquire(SDL_Renderer*& renderer, const std::string& key, SDL_Surface*& spriteSheet);
+    /**
+     * Gets the texture for a sprite sheet if it has already been uploaded, so that it does not need to be recolored.
+     * @param key The key of the sprite sheet, made with @c TextureAtlas::makeKey .
+     * @return The texture of the whole sprite sheet, or @c nullptr if it is not in the atlas. Unless it is
+     * @c nullptr , it must be released with @c TextureAtlas::release .
+     */
+    static SDL_Texture* tryAcquire(const std::string& key);
+    /**
+     * Gets the decoded sprite sheet of a character in its original colors, decoding it if no other character is using it.
+     * @param name The name of the character.
+     * @param load Decodes the sprite sheet, in any format, if it is not decoded yet. The atlas takes ownership of it.
+     * @return The sprite sheet, in @c SDL_PIXELFORMAT_RGBA32 , which must not be changed.
+     * @exception DataException Throws a @c DataException<int> when the sprite sheet cannot be decoded or converted.
+     */
+    static SDL_Surface* acquireSheet(const std::string& name, SDL_Surface* (*load)(const std::string& name));
+    /**
+     * Stops using a decoded sprite sheet, destroying it if no other character is using it.
+     * @param name The name of the character.
+     */
+    static void releaseSheet(const std::string& name);
+    /**
+     * Stops using a texture, destroying it if no other character is using it.
+     * @param key The key of the sprite sheet, made with @c TextureAtlas::makeKey .
+     */
+    static void release(const std::string& key);
+};
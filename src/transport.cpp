@@ -0,0 +1,110 @@
+#include "transport.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+/**
+ * The largest packet that can be received.
+ */
+constexpr size_t maxPacketSize = 1500UZ;
+
+LoopbackLink::Endpoint::Endpoint(LoopbackLink& link, const size_t side) : link{link}, side{side} {}
+
+void LoopbackLink::Endpoint::send(const std::span<const uint8_t> packet) {
+    LoopbackLink& link = this->link;
+    std::uniform_real_distribution<double> chance(0.0, 1.0);
+    if (link.conditions.lossRate > 0.0 && chance(link.generator) < link.conditions.lossRate) {
+        return;
+    }
+    uint64_t arrival = link.now + link.conditions.delayNanoseconds;
+    if (link.conditions.jitterNanoseconds > 0U) {
+        std::uniform_int_distribution<uint64_t> jitter(0U, link.conditions.jitterNanoseconds);
+        arrival += jitter(link.generator);
+    }
+    link.inFlight[1UZ - this->side].emplace(arrival, std::vector<uint8_t>(packet.begin(), packet.end()));
+}
+
+bool LoopbackLink::Endpoint::receive(std::vector<uint8_t>& packet) {
+    std::multimap<uint64_t, std::vector<uint8_t>>& incoming = this->link.inFlight[this->side];
+    if (incoming.empty() || incoming.begin()->first > this->link.now) {
+        return false;
+    }
+    packet = std::move(incoming.begin()->second);
+    incoming.erase(incoming.begin());
+    return true;
+}
+
+LoopbackLink::LoopbackLink(const LinkConditions& conditions)
+    : conditions{conditions},
+      generator{conditions.seed},
+      endpoints{Endpoint(*this, 0UZ), Endpoint(*this, 1UZ)} {}
+
+void LoopbackLink::setTime(const uint64_t nanoseconds) { this->now = nanoseconds; }
+
+Transport& LoopbackLink::endpoint(const size_t side) { return this->endpoints.at(side); }
+
+UdpTransport::UdpTransport(const uint16_t localPort, const std::string& remoteHost, const uint16_t remotePort) {
+    addrinfo hints{};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    addrinfo* found = nullptr;
+    const int lookup = getaddrinfo(remoteHost.c_str(), std::to_string(remotePort).c_str(), &hints, &found);
+    if (lookup != 0 || found == nullptr) {
+        throw std::runtime_error("Could not find host " + remoteHost + ": " + gai_strerror(lookup));
+    }
+    const uint8_t* address = reinterpret_cast<const uint8_t*>(found->ai_addr);
+    this->remoteAddress.assign(address, address + found->ai_addrlen);
+    freeaddrinfo(found);
+
+    this->socketHandle = socket(AF_INET, SOCK_DGRAM, 0);
+    if (this->socketHandle < 0) {
+        throw std::runtime_error(std::string("Could not open socket: ") + std::strerror(errno));
+    }
+    sockaddr_in local{};
+    local.sin_family = AF_INET;
+    local.sin_addr.s_addr = htonl(INADDR_ANY);
+    local.sin_port = htons(localPort);
+    if (bind(this->socketHandle, reinterpret_cast<const sockaddr*>(&local), sizeof(local)) < 0
+        || fcntl(this->socketHandle, F_SETFL, fcntl(this->socketHandle, F_GETFL, 0) | O_NONBLOCK) < 0) {
+        const std::string error(std::strerror(errno));
+        close(this->socketHandle);
+        throw std::runtime_error("Could not bind to port " + std::to_string(localPort) + ": " + error);
+    }
+}
+
+UdpTransport::~UdpTransport() {
+    if (this->socketHandle >= 0) {
+        close(this->socketHandle);
+    }
+}
+
+void UdpTransport::send(const std::span<const uint8_t> packet) {
+    // Lost packets are expected, so errors (such as the other player not listening yet) are ignored.
+    sendto(this->socketHandle, packet.data(), packet.size(), 0,
+           reinterpret_cast<const sockaddr*>(this->remoteAddress.data()),
+           static_cast<socklen_t>(this->remoteAddress.size()));
+}
+
+bool UdpTransport::receive(std::vector<uint8_t>& packet) {
+    packet.resize(maxPacketSize);
+    const ssize_t size = recv(this->socketHandle, packet.data(), packet.size(), 0);
+    if (size < 0) {
+        packet.clear();
+        return false;
+    }
+    packet.resize(static_cast<size_t>(size));
+    return true;
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+/**
+ * Sends and receives packets between two players. Packets may be lost, duplicated or arrive out of order.
+ */
+class Transport {
+public:
+    /**
+     * Destroys a transport.
+     */
+    virtual ~Transport() = default;
+    /**
+     * Sends a packet to the other player, without waiting.
+     * @param packet The bytes to send.
+     */
+    virtual void send(std::span<const uint8_t> packet) = 0;
+    /**
+     * Takes the next packet that has arrived from the other player, without waiting.
+     * @param packet Where to put the bytes received.
+     * @return Whether a packet was received.
+     */
+    virtual bool receive(std::vector<uint8_t>& packet) = 0;
+};
+
+/**
+ * How bad a @c LoopbackLink is.
+ */
+struct LinkConditions {
+    uint64_t delayNanoseconds = 0U; /**< How long each packet takes to arrive. */
+    uint64_t jitterNanoseconds = 0U; /**< The most extra time, picked at random per packet, that a packet can take to arrive. */
+    double lossRate = 0.0; /**< The chance of each packet being dropped, from 0 to 1. */
+    uint_fast32_t seed = 0U; /**< The seed of the jitter and losses. */
+};
+
+/**
+ * A fake network between two players in the same process, for testing netplay on one machine.
+ *
+ * Time only moves when @c LoopbackLink::setTime is called, so a test can simulate any connection as fast as the
+ * CPU allows and get the same result every time. Not thread-safe.
+ */
+class LoopbackLink {
+private:
+    /**
+     * One side of the link.
+     */
+    class Endpoint : public Transport {
+    private:
+        LoopbackLink& link; /**< The link that the endpoint belongs to. */
+        const size_t side; /**< Which side of the link the endpoint is, 0 or 1. */
+    public:
+        /**
+         * Creates one side of a link.
+         * @param link The link that the endpoint belongs to.
+         * @param side Which side of the link the endpoint is, 0 or 1.
+         */
+        Endpoint(LoopbackLink& link, size_t side);
+        void send(std::span<const uint8_t> packet) override;
+        bool receive(std::vector<uint8_t>& packet) override;
+    };
+    const LinkConditions conditions; /**< How bad the link is. */
+    std::mt19937 generator; /**< The source of the jitter and losses. */
+    uint64_t now = 0U; /**< The current time, in nanoseconds. */
+    std::array<std::multimap<uint64_t, std::vector<uint8_t>>, 2> inFlight; /**< The packets on their way to each side, keyed by when they arrive. */
+    std::array<Endpoint, 2> endpoints; /**< Both sides of the link. */
+public:
+    /**
+     * Creates a link.
+     * @param conditions How bad the link is.
+     */
+    explicit LoopbackLink(const LinkConditions& conditions);
+    LoopbackLink(const LoopbackLink&) = delete;
+    LoopbackLink& operator=(const LoopbackLink&) = delete;
+    /**
+     * Moves time forward, letting the packets that are due arrive.
+     * @param nanoseconds The current time, in nanoseconds.
+     */
+    void setTime(uint64_t nanoseconds);
+    /**
+     * Gets one side of the link.
+     * @param side Which side, 0 or 1.
+     * @return The transport of that side.
+     */
+    Transport& endpoint(size_t side);
+};
+
+/**
+ * Sends packets over UDP (IPv4), for testing netplay between two processes, for example over localhost.
+ */
+class UdpTransport : public Transport {
+private:
+    int socketHandle = -1; /**< The socket. */
+    std::vector<uint8_t> remoteAddress; /**< The address of the other player, as a @c sockaddr_in . */
+public:
+    /**
+     * Opens a socket.
+     * @param localPort The port to receive from.
+     * @param remoteHost The host name or address of the other player.
+     * @param remotePort The port of the other player.
+     * @exception std::runtime_error The socket could not be opened, or the host could not be found.
+     */
+    UdpTransport(uint16_t localPort, const std::string& remoteHost, uint16_t remotePort);
+    /**
+     * Closes the socket.
+     */
+    ~UdpTransport() override;
+    UdpTransport(const UdpTransport&) = delete;
+    UdpTransport& operator=(const UdpTransport&) = delete;
+    void send(std::span<const uint8_t> packet) override;
+    bool receive(std::vector<uint8_t>& packet) override;
+};
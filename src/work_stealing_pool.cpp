@@ -0,0 +1,119 @@
+#include "work_stealing_pool.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+/**
+ * The pool that the current thread works for, @c nullptr if it is not a worker.
+ */
+static thread_local const WorkStealingPool* currentPool = nullptr;
+/**
+ * The index of the current thread in its pool.
+ */
+static thread_local size_t currentIndex = 0UZ;
+
+WorkStealingPool::WorkStealingPool(size_t threadCount) {
+    if (threadCount == 0UZ) {
+        threadCount = std::max(1U, std::thread::hardware_concurrency());
+    }
+    for (size_t i = 0UZ; i < threadCount; ++i) {
+        this->queues.push_back(std::make_unique<WorkerQueue>());
+    }
+    for (size_t i = 0UZ; i < threadCount; ++i) {
+        this->workers.emplace_back(&WorkStealingPool::run, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(this->sleepMutex);
+        this->stopping = true;
+    }
+    this->wake.notify_all();
+    for (std::thread& worker : this->workers) {
+        worker.join();
+    }
+}
+
+void WorkStealingPool::submit(std::function<void()> task) {
+    const size_t index = currentPool == this ? currentIndex : this->nextQueue.fetch_add(1UZ) % this->queues.size();
+    ++this->pending;
+    // Counted before it is pushed, so that a worker taking it right away never brings the count below zero.
+    {
+        std::lock_guard<std::mutex> lock(this->sleepMutex);
+        ++this->queued;
+    }
+    {
+        std::lock_guard<std::mutex> lock(this->queues[index]->mutex);
+        this->queues[index]->tasks.push_back(std::move(task));
+    }
+    this->wake.notify_one();
+}
+
+bool WorkStealingPool::take(const size_t index, std::function<void()>& task) {
+    {
+        WorkerQueue& own = *this->queues[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            --this->queued;
+            return true;
+        }
+    }
+    for (size_t offset = 1UZ; offset < this->queues.size(); ++offset) {
+        WorkerQueue& victim = *this->queues[(index + offset) % this->queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            --this->queued;
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::run(const size_t index) {
+    currentPool = this;
+    currentIndex = index;
+    std::function<void()> task;
+    while (true) {
+        if (this->take(index, task)) {
+            try {
+                task();
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(this->sleepMutex);
+                if (this->error == nullptr) {
+                    this->error = std::current_exception();
+                }
+            }
+            task = nullptr;
+            if (this->pending.fetch_sub(1UZ) == 1UZ) {
+                std::lock_guard<std::mutex> lock(this->sleepMutex);
+                this->done.notify_all();
+            }
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(this->sleepMutex);
+        this->wake.wait(lock, [this] { return this->stopping || this->queued > 0UZ; });
+        if (this->stopping && this->queued == 0UZ) {
+            return;
+        }
+    }
+}
+
+void WorkStealingPool::wait() {
+    std::unique_lock<std::mutex> lock(this->sleepMutex);
+    this->done.wait(lock, [this] { return this->pending == 0UZ; });
+    if (this->error != nullptr) {
+        std::rethrow_exception(std::exchange(this->error, nullptr));
+    }
+}
+
+size_t WorkStealingPool::size() const { return this->workers.size(); }
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * A pool of threads that each have their own queue of tasks, and take tasks from each other's queues when theirs runs out.
+ *
+ * A worker takes its newest task first, which keeps the data it just touched in its cache, and steals the oldest task
+ * of another worker, which is the least likely to be in that worker's cache.
+ */
+class WorkStealingPool {
+private:
+    /**
+     * The queue of tasks of one worker.
+     */
+    struct WorkerQueue {
+        std::deque<std::function<void()>> tasks; /**< The tasks waiting to be run, newest at the back. */
+        std::mutex mutex; /**< Guards @c WorkerQueue::tasks . */
+    };
+    std::vector<std::unique_ptr<WorkerQueue>> queues; /**< The queue of each worker. */
+    std::vector<std::thread> workers; /**< The threads running the tasks. */
+    std::atomic<size_t> queued = 0UZ; /**< The number of tasks waiting in any queue. */
+    std::atomic<size_t> pending = 0UZ; /**< The number of tasks submitted but not finished yet. */
+    std::atomic<size_t> nextQueue = 0UZ; /**< The queue to give the next task submitted from outside the pool to. */
+    std::mutex sleepMutex; /**< Guards sleeping and waking, as well as @c WorkStealingPool::stopping and @c WorkStealingPool::error . */
+    std::condition_variable wake; /**< Wakes up idle workers when there are tasks or the pool is stopping. */
+    std::condition_variable done; /**< Wakes up @c WorkStealingPool::wait once every task is finished. */
+    bool stopping = false; /**< Whether the workers are meant to exit. */
+    std::exception_ptr error; /**< The first exception thrown by a task, if any. */
+    /**
+     * Takes a task, first from the worker's own queue and then from the other workers' queues.
+     * @param index The index of the worker taking the task.
+     * @param task Where to put the task.
+     * @return Whether a task was found.
+     */
+    bool take(size_t index, std::function<void()>& task);
+    /**
+     * Runs tasks until the pool stops.
+     * @param index The index of the worker.
+     */
+    void run(size_t index);
+public:
+    /**
+     * Starts the workers.
+     * @param threadCount The number of workers, 0 for one per hardware thread.
+     */
+    explicit WorkStealingPool(size_t threadCount = 0UZ);
+    /**
+     * Finishes every task in the queues, then stops the workers.
+     */
+    ~WorkStealingPool();
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+    /**
+     * Adds a task to run. Tasks submitted by a worker go to that worker's own queue.
+     * @param task The task to run.
+     */
+    void submit(std::function<void()> task);
+    /**
+     * Waits for every submitted task to finish.
+     * @exception std::exception Rethrows the first exception thrown by a task, if any.
+     */
+    void wait();
+    /**
+     * Gets the number of workers.
+     * @return The number of threads running tasks.
+     */
+    size_t size() const;
+};